@@ -0,0 +1,329 @@
+/**
+ * @file PB7200CAN.cpp
+ * @brief Cyclic CAN messages for PB7200P80 pack data
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ */
+
+#include "PB7200CAN.h"
+
+/**
+ * @brief Store a 16-bit value little-endian
+ */
+static inline void put16(uint8_t *p, uint16_t value) {
+    p[0] = value & 0xFF;
+    p[1] = value >> 8;
+}
+
+/**
+ * @brief Temperature counts (0.1 °C) to whole degrees, saturated
+ */
+static inline int8_t tempToDegrees(int16_t raw) {
+    int16_t degrees = (raw >= 0 ? raw + 5 : raw - 5) / 10;
+    return (int8_t)(degrees > 127 ? 127 : (degrees < -128 ? -128 : degrees));
+}
+
+/**
+ * @brief Float to saturated 16-bit count
+ */
+static inline uint16_t toCount(float value, float lsb) {
+    float count = value / lsb + 0.5;
+    return count <= 0.0 ? 0 : (count >= 65535.0 ? 65535 : (uint16_t)count);
+}
+
+// ========== Memory Sink ==========
+
+/**
+ * @brief Constructor
+ */
+PB7200CanMemorySink::PB7200CanMemorySink() {
+    clear();
+}
+
+/**
+ * @brief Store a frame, overwriting the oldest when full
+ */
+bool PB7200CanMemorySink::send(const CanFrame &frame) {
+    _frames[_head] = frame;
+    _head = (_head + 1) % PB7200_CAN_MEMORY_FRAMES;
+    if (_count < PB7200_CAN_MEMORY_FRAMES) {
+        _count++;
+    }
+    _total++;
+    return true;
+}
+
+/**
+ * @brief Get number of stored frames
+ */
+uint16_t PB7200CanMemorySink::count() const {
+    return _count;
+}
+
+/**
+ * @brief Get a stored frame
+ */
+const CanFrame *PB7200CanMemorySink::at(uint16_t index) const {
+    if (index >= _count) {
+        return nullptr;
+    }
+    return &_frames[(_head + PB7200_CAN_MEMORY_FRAMES - _count + index) % PB7200_CAN_MEMORY_FRAMES];
+}
+
+/**
+ * @brief Get number of frames sent since the last clear
+ */
+uint32_t PB7200CanMemorySink::total() const {
+    return _total;
+}
+
+/**
+ * @brief Remove all frames
+ */
+void PB7200CanMemorySink::clear() {
+    _head = 0;
+    _count = 0;
+    _total = 0;
+}
+
+// ========== Encoder ==========
+
+/**
+ * @brief Constructor
+ */
+PB7200CanEncoder::PB7200CanEncoder(uint32_t baseId) {
+    _baseId = baseId;
+    _chargeVoltage10mV = 0;
+    _dischargeVoltage10mV = 0;
+    _currentLimit10mA = 0;
+    _maxTemp = 0;
+    _minTemp = 0;
+}
+
+/**
+ * @brief Set identifier of the first message
+ */
+void PB7200CanEncoder::setBaseId(uint32_t baseId) {
+    _baseId = baseId;
+}
+
+/**
+ * @brief Set limits reported in the limits message
+ */
+void PB7200CanEncoder::setLimits(const ProtectionConfig &config, uint8_t cellCount) {
+    _chargeVoltage10mV = toCount(config.overVoltageThreshold * cellCount, 0.01);
+    _dischargeVoltage10mV = toCount(config.underVoltageThreshold * cellCount, 0.01);
+    _currentLimit10mA = toCount(config.overCurrentThreshold, PB7200_CURRENT_LSB);
+    _maxTemp = tempToDegrees((int16_t)(config.overTempThreshold * 10.0));
+    _minTemp = tempToDegrees((int16_t)(config.underTempThreshold * 10.0));
+}
+
+/**
+ * @brief Get number of frames in one cycle
+ */
+uint8_t PB7200CanEncoder::frameCount(const PackSnapshot &snapshot) const {
+    uint8_t cellFrames = (snapshot.cellCount + PB7200_CAN_CELLS_PER_FRAME - 1) /
+                         PB7200_CAN_CELLS_PER_FRAME;
+    return PB7200_CAN_CELLS + cellFrames;
+}
+
+/**
+ * @brief Encode one frame of the cycle
+ */
+bool PB7200CanEncoder::encode(uint8_t slot, const PackSnapshot &snapshot,
+                              uint8_t socHalfPercent, CanFrame &frame) const {
+    if (slot >= frameCount(snapshot)) {
+        return false;
+    }
+
+    uint8_t message = slot < PB7200_CAN_CELLS ? slot : (uint8_t)PB7200_CAN_CELLS;
+    uint8_t *d = frame.data;
+    frame.id = _baseId + message;
+    for (uint8_t i = 0; i < 8; i++) {
+        d[i] = 0;
+    }
+
+    switch (message) {
+        case PB7200_CAN_PACK: {
+            uint32_t totalRaw = 0;
+            for (uint8_t i = 0; i < snapshot.cellCount; i++) {
+                totalRaw += snapshot.cellRaw[i];
+            }
+            uint32_t pack10mV = (totalRaw + 5) / 10;
+            put16(d, pack10mV > 0xFFFF ? 0xFFFF : (uint16_t)pack10mV);
+            put16(d + 2, (uint16_t)snapshot.currentRaw);
+            d[4] = socHalfPercent;
+            frame.length = 5;
+            break;
+        }
+
+        case PB7200_CAN_LIMITS:
+            put16(d, _chargeVoltage10mV);
+            put16(d + 2, _dischargeVoltage10mV);
+            put16(d + 4, _currentLimit10mA);
+            d[6] = (uint8_t)_maxTemp;
+            d[7] = (uint8_t)_minTemp;
+            frame.length = 8;
+            break;
+
+        case PB7200_CAN_EXTREMES: {
+            uint8_t maxIndex = 0;
+            uint8_t minIndex = 0;
+            for (uint8_t i = 1; i < snapshot.cellCount; i++) {
+                if (snapshot.cellRaw[i] > snapshot.cellRaw[maxIndex]) {
+                    maxIndex = i;
+                }
+                if (snapshot.cellRaw[i] < snapshot.cellRaw[minIndex]) {
+                    minIndex = i;
+                }
+            }
+            int16_t maxTemp = snapshot.tempCount ? snapshot.tempRaw[0] : 0;
+            int16_t minTemp = maxTemp;
+            for (uint8_t i = 1; i < snapshot.tempCount; i++) {
+                if (snapshot.tempRaw[i] > maxTemp) {
+                    maxTemp = snapshot.tempRaw[i];
+                }
+                if (snapshot.tempRaw[i] < minTemp) {
+                    minTemp = snapshot.tempRaw[i];
+                }
+            }
+            put16(d, snapshot.cellCount ? snapshot.cellRaw[maxIndex] : 0);
+            put16(d + 2, snapshot.cellCount ? snapshot.cellRaw[minIndex] : 0);
+            d[4] = maxIndex;
+            d[5] = minIndex;
+            d[6] = (uint8_t)tempToDegrees(maxTemp);
+            d[7] = (uint8_t)tempToDegrees(minTemp);
+            frame.length = 8;
+            break;
+        }
+
+        case PB7200_CAN_FAULTS:
+            d[0] = snapshot.status;
+            d[1] = snapshot.faultStatus;
+            d[2] = snapshot.balanceMask & 0xFF;
+            d[3] = (snapshot.balanceMask >> 8) & 0xFF;
+            d[4] = (snapshot.balanceMask >> 16) & 0xFF;
+            d[5] = snapshot.cellCount;
+            d[6] = snapshot.tempCount;
+            frame.length = 7;
+            break;
+
+        case PB7200_CAN_TEMPS:
+            for (uint8_t i = 0; i < snapshot.tempCount; i++) {
+                d[i] = (uint8_t)tempToDegrees(snapshot.tempRaw[i]);
+            }
+            frame.length = snapshot.tempCount;
+            break;
+
+        default: {
+            // Multiplexed cells: first byte selects the group of three
+            uint8_t group = slot - PB7200_CAN_CELLS;
+            uint8_t first = group * PB7200_CAN_CELLS_PER_FRAME;
+            d[0] = group;
+            frame.length = 1;
+            for (uint8_t i = first;
+                 i < snapshot.cellCount && i < first + PB7200_CAN_CELLS_PER_FRAME; i++) {
+                put16(d + frame.length, snapshot.cellRaw[i]);
+                frame.length += 2;
+            }
+            break;
+        }
+    }
+
+    return true;
+}
+
+// ========== Scheduler ==========
+
+/**
+ * @brief Constructor
+ */
+PB7200CanScheduler::PB7200CanScheduler(PB7200CanSink &sink, uint32_t periodMs)
+    : _sink(sink) {
+    _period = periodMs ? periodMs : 1;
+    _cycleStart = 0;
+    _sendErrors = 0;
+    _socHalfPercent = 0;
+    _nextSlot = 0;
+    _hasData = false;
+    _started = false;
+}
+
+/**
+ * @brief Get the encoder
+ */
+PB7200CanEncoder &PB7200CanScheduler::encoder() {
+    return _encoder;
+}
+
+/**
+ * @brief Set cycle period
+ */
+void PB7200CanScheduler::setPeriod(uint32_t periodMs) {
+    _period = periodMs ? periodMs : 1;
+    _started = false;
+}
+
+/**
+ * @brief Provide the data sent from now on
+ */
+void PB7200CanScheduler::update(const PackSnapshot &snapshot, float soc) {
+    _snapshot = snapshot;
+    soc = soc < 0.0 ? 0.0 : (soc > 100.0 ? 100.0 : soc);
+    _socHalfPercent = (uint8_t)(soc * 2.0 + 0.5);
+    _hasData = true;
+}
+
+/**
+ * @brief Send frames that are due
+ */
+uint8_t PB7200CanScheduler::poll(uint32_t nowMs) {
+    if (!_hasData) {
+        return 0;
+    }
+
+    if (!_started) {
+        _cycleStart = nowMs;
+        _nextSlot = 0;
+        _started = true;
+    }
+
+    uint8_t frames = _encoder.frameCount(_snapshot);
+    if (_nextSlot >= frames) {
+        if (nowMs - _cycleStart < _period) {
+            return 0;
+        }
+        _cycleStart += _period;
+        _nextSlot = 0;
+    }
+
+    // Slot k is due k/frames of the way through the cycle
+    uint32_t due = (uint32_t)((uint64_t)_period * _nextSlot / frames);
+    uint32_t elapsed = nowMs - _cycleStart;
+    if (elapsed < due) {
+        return 0;
+    }
+
+    // Late by a slot or more: shift the rest of the cycle back instead of
+    // sending the overdue slots back to back
+    uint32_t spacing = _period / frames;
+    if (elapsed - due >= (spacing ? spacing : 1)) {
+        _cycleStart = nowMs - due;
+    }
+
+    CanFrame frame;
+    _encoder.encode(_nextSlot, _snapshot, _socHalfPercent, frame);
+    if (!_sink.send(frame)) {
+        _sendErrors++;
+    }
+    _nextSlot++;
+    return 1;
+}
+
+/**
+ * @brief Get number of frames the sink rejected
+ */
+uint32_t PB7200CanScheduler::getSendErrors() const {
+    return _sendErrors;
+}
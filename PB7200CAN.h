@@ -0,0 +1,241 @@
+/**
+ * @file PB7200CAN.h
+ * @brief Cyclic CAN messages for PB7200P80 pack data
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Frames are encoded straight from snapshot register counts with
+ * integer math and handed to a frame sink, so the same code drives an
+ * MCP2515, the ESP32 TWAI controller or an in-memory buffer on a host.
+ * The scheduler spreads one cycle of frames evenly over the period
+ * instead of sending them in a burst.
+ *
+ * Messages (identifier = base + offset, little-endian payloads):
+ *   +0 Pack      voltage (10 mV), current (10 mA), SOC (0.5 %)
+ *   +1 Limits    charge/discharge voltage (10 mV), current (10 mA),
+ *                max/min temperature (°C)
+ *   +2 Extremes  max/min cell (mV), max/min cell index,
+ *                max/min temperature (°C)
+ *   +3 Faults    status, fault status, balance mask (24 bits),
+ *                cell count, sensor count
+ *   +4 Temps     one signed byte per sensor (°C)
+ *   +5 Cells     multiplexed: index, then three cells (mV)
+ */
+
+#ifndef PB7200CAN_H
+#define PB7200CAN_H
+
+#include "PB7200Types.h"
+
+// Default identifier of the first message (11-bit)
+#define PB7200_CAN_BASE_ID 0x350
+
+// Default cycle period (ms)
+#define PB7200_CAN_PERIOD_MS 1000
+
+// Cells per multiplexed cell frame
+#define PB7200_CAN_CELLS_PER_FRAME 3
+
+// Frames kept by PB7200CanMemorySink
+#ifndef PB7200_CAN_MEMORY_FRAMES
+#define PB7200_CAN_MEMORY_FRAMES 32
+#endif
+
+/**
+ * @brief Message offsets from the base identifier
+ */
+enum PB7200_CanMessage {
+    PB7200_CAN_PACK = 0,
+    PB7200_CAN_LIMITS,
+    PB7200_CAN_EXTREMES,
+    PB7200_CAN_FAULTS,
+    PB7200_CAN_TEMPS,
+    PB7200_CAN_CELLS,
+    PB7200_CAN_MESSAGE_COUNT
+};
+
+/**
+ * @brief Classic CAN data frame
+ */
+struct CanFrame {
+    uint32_t id;        // Identifier
+    uint8_t length;     // Data length (0-8)
+    uint8_t data[8];    // Payload
+};
+
+/**
+ * @brief Destination of encoded frames
+ */
+class PB7200CanSink {
+public:
+    virtual ~PB7200CanSink() {}
+
+    /**
+     * @brief Transmit a frame
+     * @param frame Frame to send
+     * @return true if the frame was queued
+     */
+    virtual bool send(const CanFrame &frame) = 0;
+};
+
+/**
+ * @brief Sink that keeps the most recent frames in RAM (host tests)
+ */
+class PB7200CanMemorySink : public PB7200CanSink {
+public:
+    PB7200CanMemorySink();
+
+    bool send(const CanFrame &frame) override;
+
+    /**
+     * @brief Get number of stored frames
+     * @return Frame count
+     */
+    uint16_t count() const;
+
+    /**
+     * @brief Get a stored frame
+     * @param index 0 = oldest
+     * @return Frame or nullptr if out of range
+     */
+    const CanFrame *at(uint16_t index) const;
+
+    /**
+     * @brief Get number of frames sent since the last clear
+     * @return Frame count (including overwritten frames)
+     */
+    uint32_t total() const;
+
+    /**
+     * @brief Remove all frames
+     */
+    void clear();
+
+private:
+    CanFrame _frames[PB7200_CAN_MEMORY_FRAMES];
+    uint16_t _head;
+    uint16_t _count;
+    uint32_t _total;
+};
+
+/**
+ * @brief Encodes pack messages from a snapshot
+ */
+class PB7200CanEncoder {
+public:
+    /**
+     * @brief Constructor
+     * @param baseId Identifier of the first message
+     */
+    PB7200CanEncoder(uint32_t baseId = PB7200_CAN_BASE_ID);
+
+    /**
+     * @brief Set identifier of the first message
+     * @param baseId Base identifier
+     */
+    void setBaseId(uint32_t baseId);
+
+    /**
+     * @brief Set limits reported in the limits message
+     *
+     * Converted to counts once here, not on every frame.
+     *
+     * @param config Protection thresholds (per cell)
+     * @param cellCount Cells in series
+     */
+    void setLimits(const ProtectionConfig &config, uint8_t cellCount);
+
+    /**
+     * @brief Get number of frames in one cycle
+     * @param snapshot Snapshot to send
+     * @return Fixed messages plus one frame per three cells
+     */
+    uint8_t frameCount(const PackSnapshot &snapshot) const;
+
+    /**
+     * @brief Encode one frame of the cycle
+     * @param slot Frame index within the cycle
+     * @param snapshot Raw snapshot
+     * @param socHalfPercent State of charge (0.5 %)
+     * @param frame Frame to fill
+     * @return true if slot is valid
+     */
+    bool encode(uint8_t slot, const PackSnapshot &snapshot, uint8_t socHalfPercent,
+                CanFrame &frame) const;
+
+private:
+    uint32_t _baseId;
+    uint16_t _chargeVoltage10mV;
+    uint16_t _dischargeVoltage10mV;
+    uint16_t _currentLimit10mA;
+    int8_t _maxTemp;
+    int8_t _minTemp;
+};
+
+/**
+ * @brief Sends one cycle of frames spread evenly over the period
+ */
+class PB7200CanScheduler {
+public:
+    /**
+     * @brief Constructor
+     * @param sink Destination of frames
+     * @param periodMs Cycle period
+     */
+    PB7200CanScheduler(PB7200CanSink &sink, uint32_t periodMs = PB7200_CAN_PERIOD_MS);
+
+    /**
+     * @brief Get the encoder (base identifier, limits)
+     * @return Encoder
+     */
+    PB7200CanEncoder &encoder();
+
+    /**
+     * @brief Set cycle period
+     * @param periodMs Period in milliseconds
+     */
+    void setPeriod(uint32_t periodMs);
+
+    /**
+     * @brief Provide the data sent from now on
+     * @param snapshot Latest snapshot (copied)
+     * @param soc State of charge (%)
+     */
+    void update(const PackSnapshot &snapshot, float soc);
+
+    /**
+     * @brief Send frames that are due
+     *
+     * Call often (every loop). At most one frame is sent per call. A
+     * frame sent a slot or more late moves the rest of the cycle back,
+     * so after a stall the frames keep their spacing instead of going
+     * out back to back. Calls further apart than one slot (period /
+     * frames) lengthen the cycle, and so does a period shorter than a
+     * millisecond per frame.
+     *
+     * @param nowMs Current time (e.g. millis())
+     * @return Number of frames sent (0 or 1)
+     */
+    uint8_t poll(uint32_t nowMs);
+
+    /**
+     * @brief Get number of frames the sink rejected
+     * @return Error count
+     */
+    uint32_t getSendErrors() const;
+
+private:
+    PB7200CanSink &_sink;
+    PB7200CanEncoder _encoder;
+    PackSnapshot _snapshot;
+    uint32_t _period;
+    uint32_t _cycleStart;
+    uint32_t _sendErrors;
+    uint8_t _socHalfPercent;
+    uint8_t _nextSlot;
+    bool _hasData;
+    bool _started;
+};
+
+#endif // PB7200CAN_H
@@ -0,0 +1,258 @@
+/**
+ * @file PB7200Decimator.cpp
+ * @brief Multi-rate min/max/mean/last aggregation of PB7200P80 snapshots
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ */
+
+#include "PB7200Decimator.h"
+
+/**
+ * @brief Constructor
+ */
+PB7200Decimator::PB7200Decimator() {
+    _stageCount = 0;
+    _cellCount = 0;
+    _tempCount = 0;
+    _channelCount = 0;
+    _callback = nullptr;
+    _context = nullptr;
+}
+
+/**
+ * @brief Append a coarser stage
+ */
+bool PB7200Decimator::addStage(uint32_t intervalMs) {
+    if (_stageCount >= PB7200_DECIMATOR_MAX_STAGES || intervalMs == 0) {
+        return false;
+    }
+
+    // Aligned windows only nest if intervals are multiples
+    if (_stageCount > 0 && intervalMs % _stages[_stageCount - 1].interval != 0) {
+        return false;
+    }
+
+    Stage &stage = _stages[_stageCount];
+    stage.interval = intervalMs;
+    stage.windowStart = 0;
+    stage.count = 0;
+    stage.samples = 0;
+    stage.open = false;
+    _stageCount++;
+    return true;
+}
+
+/**
+ * @brief Set function called for every closed window
+ */
+void PB7200Decimator::setCallback(PB7200_AggregateCallback callback, void *context) {
+    _callback = callback;
+    _context = context;
+}
+
+/**
+ * @brief Discard all open windows
+ */
+void PB7200Decimator::reset() {
+    for (uint8_t s = 0; s < _stageCount; s++) {
+        _stages[s].count = 0;
+        _stages[s].open = false;
+    }
+}
+
+/**
+ * @brief Feed a snapshot into stage 0
+ */
+void PB7200Decimator::push(const PackSnapshot &snapshot) {
+    if (snapshot.cellCount != _cellCount || snapshot.tempCount != _tempCount) {
+        reset();
+        _cellCount = snapshot.cellCount;
+        _tempCount = snapshot.tempCount;
+        _channelCount = _cellCount + _tempCount + 1;
+    }
+
+    if (_stageCount == 0) {
+        return;
+    }
+
+    Stage &stage = _stages[0];
+    uint32_t time = snapshot.timestamp;
+
+    // Wrap-safe: elapsed time since the window started
+    if (stage.open && (time - stage.windowStart >= stage.interval || stage.count == 0xFFFF)) {
+        closeWindow(0);
+    }
+    if (!stage.open) {
+        openWindow(0, time);
+    }
+
+    uint8_t channel = 0;
+    for (uint8_t i = 0; i < _cellCount; i++, channel++) {
+        int16_t value = (int16_t)snapshot.cellRaw[i];
+        addValue(stage, channel, value, value, value, value);
+    }
+    for (uint8_t i = 0; i < _tempCount; i++, channel++) {
+        int16_t value = snapshot.tempRaw[i];
+        addValue(stage, channel, value, value, value, value);
+    }
+    addValue(stage, channel, snapshot.currentRaw, snapshot.currentRaw,
+             snapshot.currentRaw, snapshot.currentRaw);
+    stage.count++;
+    stage.samples++;
+}
+
+/**
+ * @brief Close every open window now
+ */
+void PB7200Decimator::flush() {
+    // Lower stages first, so their last window reaches the next stage
+    for (uint8_t s = 0; s < _stageCount; s++) {
+        closeWindow(s);
+    }
+}
+
+/**
+ * @brief Get number of stages
+ */
+uint8_t PB7200Decimator::getStageCount() const {
+    return _stageCount;
+}
+
+/**
+ * @brief Get window length of a stage
+ */
+uint32_t PB7200Decimator::getInterval(uint8_t stage) const {
+    return stage < _stageCount ? _stages[stage].interval : 0;
+}
+
+/**
+ * @brief Get number of channels
+ */
+uint8_t PB7200Decimator::getChannelCount() const {
+    return _channelCount;
+}
+
+/**
+ * @brief Get channel of a temperature sensor
+ */
+uint8_t PB7200Decimator::tempChannel(uint8_t sensorIndex) const {
+    return _cellCount + sensorIndex;
+}
+
+/**
+ * @brief Get channel of the pack current
+ */
+uint8_t PB7200Decimator::currentChannel() const {
+    return _cellCount + _tempCount;
+}
+
+/**
+ * @brief Get number of inputs in a stage's window
+ */
+uint16_t PB7200Decimator::getSampleCount(uint8_t stage) const {
+    return stage < _stageCount ? _stages[stage].count : 0;
+}
+
+/**
+ * @brief Get the aggregate of a channel
+ */
+bool PB7200Decimator::getAggregate(uint8_t stage, uint8_t channel,
+                                   ChannelAggregate &aggregate) const {
+    if (stage >= _stageCount || channel >= _channelCount || _stages[stage].count == 0) {
+        return false;
+    }
+
+    const Stage &s = _stages[stage];
+    aggregate.min = s.min[channel];
+    aggregate.max = s.max[channel];
+    aggregate.mean = meanOf(s, channel);
+    aggregate.last = s.last[channel];
+    return true;
+}
+
+/**
+ * @brief Start a window aligned to the stage interval
+ */
+void PB7200Decimator::openWindow(uint8_t stage, uint32_t time) {
+    Stage &s = _stages[stage];
+    s.windowStart = time - time % s.interval;
+    s.count = 0;
+    s.samples = 0;
+    s.open = true;
+}
+
+/**
+ * @brief Report a window and fold it into the next stage
+ */
+void PB7200Decimator::closeWindow(uint8_t stage) {
+    Stage &s = _stages[stage];
+    if (!s.open) {
+        return;
+    }
+
+    if (s.count > 0 && _callback != nullptr) {
+        _callback(*this, stage, s.windowStart, _context);
+    }
+
+    if (s.count > 0 && stage + 1 < _stageCount) {
+        Stage &up = _stages[stage + 1];
+
+        // A gap in the data can leave the next stage's window behind
+        if (up.open && s.windowStart - up.windowStart >= up.interval) {
+            closeWindow(stage + 1);
+        }
+        if (!up.open) {
+            openWindow(stage + 1, s.windowStart);
+        }
+
+        // Sums carry up, so higher means weight every snapshot equally
+        for (uint8_t ch = 0; ch < _channelCount; ch++) {
+            addValue(up, ch, s.min[ch], s.max[ch], s.sum[ch], s.last[ch]);
+        }
+        up.count++;
+        up.samples += s.samples;
+
+        s.open = false;
+        s.count = 0;
+
+        uint32_t windowEnd = s.windowStart + s.interval;
+        if (windowEnd - up.windowStart >= up.interval) {
+            closeWindow(stage + 1);
+        }
+        return;
+    }
+
+    s.open = false;
+    s.count = 0;
+}
+
+/**
+ * @brief Fold one input into a channel accumulator
+ */
+void PB7200Decimator::addValue(Stage &stage, uint8_t channel, int16_t min, int16_t max,
+                               int64_t sum, int16_t last) {
+    if (stage.count == 0) {
+        stage.min[channel] = min;
+        stage.max[channel] = max;
+        stage.sum[channel] = sum;
+    } else {
+        if (min < stage.min[channel]) {
+            stage.min[channel] = min;
+        }
+        if (max > stage.max[channel]) {
+            stage.max[channel] = max;
+        }
+        stage.sum[channel] += sum;
+    }
+    stage.last[channel] = last;
+}
+
+/**
+ * @brief Rounded mean of a channel accumulator
+ */
+int16_t PB7200Decimator::meanOf(const Stage &stage, uint8_t channel) const {
+    int64_t sum = stage.sum[channel];
+    int64_t half = stage.samples / 2;
+    return (int16_t)((sum >= 0 ? sum + half : sum - half) / (int64_t)stage.samples);
+}
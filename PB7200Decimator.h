@@ -0,0 +1,181 @@
+/**
+ * @file PB7200Decimator.h
+ * @brief Multi-rate min/max/mean/last aggregation of PB7200P80 snapshots
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * A cascade of streaming aggregators for logging. Stage 0 consumes raw
+ * snapshots, every further stage consumes the windows closed by the
+ * stage below it (e.g. raw → 1 s → 1 min → 1 h). Each closed window is
+ * reported through a callback with the min, max, mean and last value of
+ * every channel, so coarse logs still keep the extremes. Each stage
+ * passes its sums and snapshot count up, so every mean is the mean of
+ * the snapshots in the window, however unevenly they were spread.
+ *
+ * Memory is fixed and accumulators are integer register counts.
+ */
+
+#ifndef PB7200DECIMATOR_H
+#define PB7200DECIMATOR_H
+
+#include "PB7200Types.h"
+
+// Maximum number of cascaded stages
+#ifndef PB7200_DECIMATOR_MAX_STAGES
+#define PB7200_DECIMATOR_MAX_STAGES 3
+#endif
+
+// Channels: cells, then temperature sensors, then current
+#define PB7200_DECIMATOR_MAX_CHANNELS (PB7200_MAX_CELLS + PB7200_MAX_TEMPS + 1)
+
+/**
+ * @brief Aggregate of one channel over a window (register counts)
+ */
+struct ChannelAggregate {
+    int16_t min;    // Lowest value
+    int16_t max;    // Highest value
+    int16_t mean;   // Rounded mean
+    int16_t last;   // Most recent value
+};
+
+class PB7200Decimator;
+
+/**
+ * @brief Called when a stage closes a window
+ *
+ * Read the window with PB7200Decimator::getAggregate() from inside the
+ * callback.
+ */
+typedef void (*PB7200_AggregateCallback)(const PB7200Decimator &decimator, uint8_t stage,
+                                         uint32_t windowStart, void *context);
+
+/**
+ * @brief Cascade of streaming aggregators
+ */
+class PB7200Decimator {
+public:
+    /**
+     * @brief Constructor (no stages)
+     */
+    PB7200Decimator();
+
+    /**
+     * @brief Append a coarser stage
+     *
+     * Windows are aligned to multiples of the interval on the snapshot
+     * clock, so each interval must be a multiple of the previous one.
+     *
+     * @param intervalMs Window length in milliseconds
+     * @return true if successful
+     */
+    bool addStage(uint32_t intervalMs);
+
+    /**
+     * @brief Set function called for every closed window
+     * @param callback Callback (nullptr = none)
+     * @param context Passed to the callback
+     */
+    void setCallback(PB7200_AggregateCallback callback, void *context = nullptr);
+
+    /**
+     * @brief Discard all open windows (stages are kept)
+     */
+    void reset();
+
+    /**
+     * @brief Feed a snapshot into stage 0
+     *
+     * Windows that ended before the snapshot time are closed first.
+     * A change of cell or sensor count discards the open windows.
+     *
+     * @param snapshot Raw snapshot
+     */
+    void push(const PackSnapshot &snapshot);
+
+    /**
+     * @brief Close every open window now (e.g. before power-down)
+     */
+    void flush();
+
+    /**
+     * @brief Get number of stages
+     * @return Stage count
+     */
+    uint8_t getStageCount() const;
+
+    /**
+     * @brief Get window length of a stage
+     * @param stage Stage index
+     * @return Interval in milliseconds (0 if invalid)
+     */
+    uint32_t getInterval(uint8_t stage) const;
+
+    /**
+     * @brief Get number of channels
+     * @return Cells + sensors + 1
+     */
+    uint8_t getChannelCount() const;
+
+    /**
+     * @brief Get channel of a temperature sensor
+     * @param sensorIndex Logical sensor index
+     * @return Channel index
+     */
+    uint8_t tempChannel(uint8_t sensorIndex) const;
+
+    /**
+     * @brief Get channel of the pack current
+     * @return Channel index
+     */
+    uint8_t currentChannel() const;
+
+    /**
+     * @brief Get number of inputs in a stage's window
+     * @param stage Stage index
+     * @return Snapshots (stage 0) or closed windows (higher stages)
+     */
+    uint16_t getSampleCount(uint8_t stage) const;
+
+    /**
+     * @brief Get the aggregate of a channel
+     *
+     * Inside the callback this is the window being closed, otherwise
+     * the window in progress.
+     *
+     * @param stage Stage index
+     * @param channel Channel index (cells first)
+     * @param aggregate Structure to store aggregate
+     * @return true if the window has data
+     */
+    bool getAggregate(uint8_t stage, uint8_t channel, ChannelAggregate &aggregate) const;
+
+private:
+    struct Stage {
+        uint32_t interval;
+        uint32_t windowStart;
+        uint16_t count;      // Inputs: snapshots or lower windows
+        bool open;
+        uint32_t samples;    // Snapshots behind the window
+        int16_t min[PB7200_DECIMATOR_MAX_CHANNELS];
+        int16_t max[PB7200_DECIMATOR_MAX_CHANNELS];
+        int16_t last[PB7200_DECIMATOR_MAX_CHANNELS];
+        int64_t sum[PB7200_DECIMATOR_MAX_CHANNELS];   // Over all snapshots
+    };
+
+    Stage _stages[PB7200_DECIMATOR_MAX_STAGES];
+    uint8_t _stageCount;
+    uint8_t _cellCount;
+    uint8_t _tempCount;
+    uint8_t _channelCount;
+    PB7200_AggregateCallback _callback;
+    void *_context;
+
+    void openWindow(uint8_t stage, uint32_t time);
+    void closeWindow(uint8_t stage);
+    void addValue(Stage &stage, uint8_t channel, int16_t min, int16_t max,
+                  int64_t sum, int16_t last);
+    int16_t meanOf(const Stage &stage, uint8_t channel) const;
+};
+
+#endif // PB7200DECIMATOR_H
@@ -0,0 +1,67 @@
+/**
+ * @file PB7200EEPROM.h
+ * @brief EEPROM backend for PB7200P80 persistent storage
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ * 
+ * Header-only so that boards without an EEPROM library are not
+ * affected unless a sketch includes it. On ESP32/ESP8266 call
+ * EEPROM.begin(size) before use.
+ */
+
+#ifndef PB7200EEPROM_H
+#define PB7200EEPROM_H
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "PB7200Storage.h"
+
+/**
+ * @brief Persistent storage on the Arduino EEPROM library
+ */
+class PB7200EEPROMStorage : public PB7200Storage {
+public:
+    /**
+     * @brief Constructor
+     * @param size Bytes to use (0 = whole EEPROM)
+     */
+    PB7200EEPROMStorage(uint32_t size = 0) : _size(size) {}
+
+    uint32_t size() override {
+        return _size ? _size : EEPROM.length();
+    }
+
+    bool read(uint32_t address, void *data, uint16_t length) override {
+        uint8_t *bytes = (uint8_t *)data;
+        for (uint16_t i = 0; i < length; i++) {
+            bytes[i] = EEPROM.read(address + i);
+        }
+        return true;
+    }
+
+    bool write(uint32_t address, const void *data, uint16_t length) override {
+        const uint8_t *bytes = (const uint8_t *)data;
+        for (uint16_t i = 0; i < length; i++) {
+#if defined(ESP32) || defined(ESP8266)
+            EEPROM.write(address + i, bytes[i]);
+#else
+            EEPROM.update(address + i, bytes[i]);  // Skips unchanged bytes
+#endif
+        }
+        return true;
+    }
+
+    bool commit() override {
+#if defined(ESP32) || defined(ESP8266)
+        return EEPROM.commit();
+#else
+        return true;
+#endif
+    }
+
+private:
+    uint32_t _size;
+};
+
+#endif // PB7200EEPROM_H
@@ -0,0 +1,200 @@
+/**
+ * @file PB7200Format.cpp
+ * @brief Fixed-point number formatting without float printing
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ */
+
+#include "PB7200Format.h"
+
+// Flash strings need explicit reads on AVR
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define PB7200_FLASH_READ(p) pgm_read_byte(p)
+#else
+#define PB7200_FLASH_READ(p) (*(p))
+#endif
+
+/**
+ * @brief Format an unsigned integer
+ */
+uint8_t pb7200FormatUnsigned(char *out, uint32_t value) {
+    char digits[10];
+    uint8_t count = 0;
+
+    // 32-bit division is slow on 8-bit cores: switch to 16-bit early
+    while (value > 0xFFFF) {
+        digits[count++] = '0' + value % 10;
+        value /= 10;
+    }
+    uint16_t small = (uint16_t)value;
+    do {
+        digits[count++] = '0' + small % 10;
+        small /= 10;
+    } while (small > 0);
+
+    for (uint8_t i = 0; i < count; i++) {
+        out[i] = digits[count - 1 - i];
+    }
+    out[count] = '\0';
+    return count;
+}
+
+/**
+ * @brief Format a fixed-point value
+ */
+uint8_t pb7200FormatFixed(char *out, int32_t value, uint8_t decimals) {
+    uint8_t length = 0;
+    uint32_t magnitude = (uint32_t)value;
+    if (value < 0) {
+        out[length++] = '-';
+        magnitude = 0 - magnitude;
+    }
+
+    if (decimals == 0) {
+        return length + pb7200FormatUnsigned(out + length, magnitude);
+    }
+    if (decimals > 9) {
+        decimals = 9;
+    }
+
+    // Pad with leading zeros so there is at least one integer digit
+    char digits[PB7200_FORMAT_MAX];
+    uint8_t count = pb7200FormatUnsigned(digits, magnitude);
+    uint8_t integerDigits = count > decimals ? count - decimals : 0;
+
+    if (integerDigits == 0) {
+        out[length++] = '0';
+    } else {
+        for (uint8_t i = 0; i < integerDigits; i++) {
+            out[length++] = digits[i];
+        }
+    }
+    out[length++] = '.';
+    for (uint8_t i = count; i < decimals; i++) {
+        out[length++] = '0';
+    }
+    for (uint8_t i = integerDigits; i < count; i++) {
+        out[length++] = digits[i];
+    }
+
+    out[length] = '\0';
+    return length;
+}
+
+/**
+ * @brief Scale a float to a rounded fixed-point integer
+ */
+int32_t pb7200ToFixed(float value, uint8_t decimals) {
+    static const float scale[] = {1.0, 10.0, 100.0, 1000.0, 10000.0, 100000.0, 1000000.0};
+    float scaled = value * scale[decimals > 6 ? 6 : decimals];
+    scaled += scaled < 0.0 ? -0.5 : 0.5;
+    if (scaled >= 2147483647.0) {
+        return INT32_MAX;
+    }
+    if (scaled <= -2147483648.0) {
+        return INT32_MIN;
+    }
+    return (int32_t)scaled;
+}
+
+// ========== Line Buffer ==========
+
+/**
+ * @brief Constructor
+ */
+PB7200LineBuffer::PB7200LineBuffer() {
+    clear();
+}
+
+/**
+ * @brief Empty the line
+ */
+void PB7200LineBuffer::clear() {
+    _length = 0;
+    _text[0] = '\0';
+}
+
+/**
+ * @brief Append text from RAM
+ */
+void PB7200LineBuffer::append(const char *text) {
+    while (*text && _length < PB7200_LINE_MAX) {
+        _text[_length++] = *text++;
+    }
+    _text[_length] = '\0';
+}
+
+/**
+ * @brief Append text stored in flash
+ */
+void PB7200LineBuffer::appendFlash(const char *text) {
+    char c;
+    while ((c = PB7200_FLASH_READ(text)) != '\0' && _length < PB7200_LINE_MAX) {
+        _text[_length++] = c;
+        text++;
+    }
+    _text[_length] = '\0';
+}
+
+/**
+ * @brief Append one character
+ */
+void PB7200LineBuffer::appendChar(char c) {
+    if (_length < PB7200_LINE_MAX) {
+        _text[_length++] = c;
+        _text[_length] = '\0';
+    }
+}
+
+/**
+ * @brief Append an unsigned integer
+ */
+void PB7200LineBuffer::appendUnsigned(uint32_t value) {
+    char digits[PB7200_FORMAT_MAX];
+    pb7200FormatUnsigned(digits, value);
+    append(digits);
+}
+
+/**
+ * @brief Append a fixed-point value
+ */
+void PB7200LineBuffer::appendFixed(int32_t value, uint8_t decimals) {
+    char digits[PB7200_FORMAT_MAX];
+    pb7200FormatFixed(digits, value, decimals);
+    append(digits);
+}
+
+/**
+ * @brief Append a byte as two uppercase hex digits
+ */
+void PB7200LineBuffer::appendHex(uint8_t value) {
+    static const char hex[] = "0123456789ABCDEF";
+    appendChar(hex[value >> 4]);
+    appendChar(hex[value & 0x0F]);
+}
+
+/**
+ * @brief Pad with spaces up to a column
+ */
+void PB7200LineBuffer::padTo(uint8_t column) {
+    while (_length < column && _length < PB7200_LINE_MAX) {
+        _text[_length++] = ' ';
+    }
+    _text[_length] = '\0';
+}
+
+/**
+ * @brief Get the line
+ */
+const char *PB7200LineBuffer::c_str() const {
+    return _text;
+}
+
+/**
+ * @brief Get line length
+ */
+uint8_t PB7200LineBuffer::length() const {
+    return _length;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file PB7200Format.h
+ * @brief Fixed-point number formatting without float printing
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ * 
+ * Register counts are printed as decimals by integer digit extraction
+ * (e.g. 3712 mV with 3 decimals → "3.712"), so neither dtostrf nor the
+ * float printf support is linked in. PB7200LineBuffer assembles a
+ * line from text and such values so it can be sent with one write.
+ */
+
+#ifndef PB7200FORMAT_H
+#define PB7200FORMAT_H
+
+#include <stdint.h>
+
+// Line buffer capacity (characters, including the line ending)
+#ifndef PB7200_LINE_MAX
+#define PB7200_LINE_MAX 64
+#endif
+
+// Longest formatted value: "-2147483648" with a decimal point, plus terminator
+#define PB7200_FORMAT_MAX 13
+
+/**
+ * @brief Format an unsigned integer
+ * @param out Buffer of at least PB7200_FORMAT_MAX bytes
+ * @param value Value
+ * @return Number of characters (terminator not counted)
+ */
+uint8_t pb7200FormatUnsigned(char *out, uint32_t value);
+
+/**
+ * @brief Format a fixed-point value
+ * @param out Buffer of at least PB7200_FORMAT_MAX bytes
+ * @param value Value in units of 10^-decimals
+ * @param decimals Digits after the decimal point (0-9)
+ * @return Number of characters (terminator not counted)
+ */
+uint8_t pb7200FormatFixed(char *out, int32_t value, uint8_t decimals);
+
+/**
+ * @brief Scale a float to a rounded fixed-point integer
+ * @param value Value
+ * @param decimals Digits after the decimal point (0-6)
+ * @return value * 10^decimals, rounded and saturated
+ */
+int32_t pb7200ToFixed(float value, uint8_t decimals);
+
+/**
+ * @brief Fixed-size text line (truncates when full)
+ */
+class PB7200LineBuffer {
+public:
+    /**
+     * @brief Constructor (empty line)
+     */
+    PB7200LineBuffer();
+
+    /**
+     * @brief Empty the line
+     */
+    void clear();
+
+    /**
+     * @brief Append text from RAM
+     * @param text Null-terminated text
+     */
+    void append(const char *text);
+
+    /**
+     * @brief Append text stored in flash (PSTR() on AVR, plain text elsewhere)
+     * @param text Null-terminated text
+     */
+    void appendFlash(const char *text);
+
+    /**
+     * @brief Append one character
+     * @param c Character
+     */
+    void appendChar(char c);
+
+    /**
+     * @brief Append an unsigned integer
+     * @param value Value
+     */
+    void appendUnsigned(uint32_t value);
+
+    /**
+     * @brief Append a fixed-point value
+     * @param value Value in units of 10^-decimals
+     * @param decimals Digits after the decimal point
+     */
+    void appendFixed(int32_t value, uint8_t decimals);
+
+    /**
+     * @brief Append a byte as two uppercase hex digits
+     * @param value Value
+     */
+    void appendHex(uint8_t value);
+
+    /**
+     * @brief Pad with spaces up to a column
+     * @param column Target length
+     */
+    void padTo(uint8_t column);
+
+    /**
+     * @brief Get the line
+     * @return Null-terminated text
+     */
+    const char *c_str() const;
+
+    /**
+     * @brief Get line length
+     * @return Number of characters
+     */
+    uint8_t length() const;
+
+private:
+    char _text[PB7200_LINE_MAX + 1];
+    uint8_t _length;
+};
+
+#endif // PB7200FORMAT_H
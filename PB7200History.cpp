@@ -0,0 +1,167 @@
+/**
+ * @file PB7200History.cpp
+ * @brief Snapshot history ring with LTTB downsampling for export
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ */
+
+#include "PB7200History.h"
+
+/**
+ * @brief Constructor
+ */
+PB7200History::PB7200History(PackSnapshot *buffer, uint16_t capacity) {
+    _buffer = buffer;
+    _capacity = buffer != nullptr ? capacity : 0;
+    _head = 0;
+    _count = 0;
+}
+
+/**
+ * @brief Append a snapshot
+ */
+void PB7200History::push(const PackSnapshot &snapshot) {
+    if (_capacity == 0) {
+        return;
+    }
+
+    _buffer[_head] = snapshot;
+    _head = (_head + 1) % _capacity;
+    if (_count < _capacity) {
+        _count++;
+    }
+}
+
+/**
+ * @brief Remove all snapshots
+ */
+void PB7200History::clear() {
+    _head = 0;
+    _count = 0;
+}
+
+/**
+ * @brief Get number of stored snapshots
+ */
+uint16_t PB7200History::count() const {
+    return _count;
+}
+
+/**
+ * @brief Get ring capacity
+ */
+uint16_t PB7200History::capacity() const {
+    return _capacity;
+}
+
+/**
+ * @brief Get a stored snapshot
+ */
+const PackSnapshot *PB7200History::at(uint16_t index) const {
+    if (index >= _count) {
+        return nullptr;
+    }
+
+    // Oldest entry sits at head once the ring is full
+    uint16_t slot = (uint16_t)((_head + _capacity - _count + index) % _capacity);
+    return &_buffer[slot];
+}
+
+/**
+ * @brief Get one channel of a stored snapshot
+ */
+int16_t PB7200History::value(uint16_t index, uint8_t channel) const {
+    const PackSnapshot *snapshot = at(index);
+    if (snapshot == nullptr) {
+        return 0;
+    }
+
+    if (channel < snapshot->cellCount) {
+        return (int16_t)snapshot->cellRaw[channel];
+    }
+    channel -= snapshot->cellCount;
+    if (channel < snapshot->tempCount) {
+        return snapshot->tempRaw[channel];
+    }
+    return channel == snapshot->tempCount ? snapshot->currentRaw : 0;
+}
+
+/**
+ * @brief Export a channel reduced to a number of points (LTTB)
+ */
+uint16_t PB7200History::downsample(uint8_t channel, uint16_t points,
+                                   PB7200_PointCallback callback, void *context) const {
+    if (callback == nullptr || _count == 0 || points == 0) {
+        return 0;
+    }
+
+    // Nothing to reduce
+    if (points >= _count) {
+        for (uint16_t i = 0; i < _count; i++) {
+            callback(at(i)->timestamp, value(i, channel), context);
+        }
+        return _count;
+    }
+
+    // Too few points for a bucket: keep the ends, the oldest dropped first
+    if (points < 3) {
+        if (points == 2) {
+            callback(at(0)->timestamp, value(0, channel), context);
+        }
+        callback(at(_count - 1)->timestamp, value(_count - 1, channel), context);
+        return points;
+    }
+
+    // Times are taken relative to the first sample so they stay small
+    uint32_t origin = at(0)->timestamp;
+    uint16_t buckets = points - 2;
+    uint16_t inner = _count - 2;
+
+    uint16_t selected = 0;
+    callback(origin, value(0, channel), context);
+
+    for (uint16_t b = 0; b < buckets; b++) {
+        // Bucket b covers [start, end) of the inner samples (offset by 1)
+        uint16_t start = 1 + (uint32_t)b * inner / buckets;
+        uint16_t end = 1 + (uint32_t)(b + 1) * inner / buckets;
+
+        // Third vertex: average of the next bucket (the last sample for the last bucket)
+        uint16_t nextStart = end;
+        uint16_t nextEnd = b + 1 < buckets ? 1 + (uint32_t)(b + 2) * inner / buckets : _count;
+        int64_t sumT = 0;
+        int32_t sumV = 0;
+        for (uint16_t i = nextStart; i < nextEnd; i++) {
+            sumT += at(i)->timestamp - origin;
+            sumV += value(i, channel);
+        }
+        uint16_t nextCount = nextEnd - nextStart;
+        int64_t cT = sumT / nextCount;
+        int64_t cV = sumV / nextCount;
+
+        int64_t aT = at(selected)->timestamp - origin;
+        int64_t aV = value(selected, channel);
+
+        // Twice the triangle area; comparing areas needs no halving
+        uint16_t best = start;
+        int64_t bestArea = -1;
+        for (uint16_t i = start; i < end; i++) {
+            int64_t bT = at(i)->timestamp - origin;
+            int64_t bV = value(i, channel);
+            int64_t area = (aT - cT) * (bV - aV) - (aT - bT) * (cV - aV);
+            if (area < 0) {
+                area = -area;
+            }
+            if (area > bestArea) {
+                bestArea = area;
+                best = i;
+            }
+        }
+
+        selected = best;
+        callback(at(selected)->timestamp, value(selected, channel), context);
+    }
+
+    callback(at(_count - 1)->timestamp, value(_count - 1, channel), context);
+    return points;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file PB7200History.h
+ * @brief Snapshot history ring with LTTB downsampling for export
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Keeps the most recent snapshots in a caller-provided array. Any
+ * channel can be exported as a Largest-Triangle-Three-Buckets reduction
+ * to a fixed number of points, read straight from the ring. The
+ * reduction reads every stored sample, so its time grows with the
+ * history length; only the output follows the number of points.
+ */
+
+#ifndef PB7200HISTORY_H
+#define PB7200HISTORY_H
+
+#include "PB7200Types.h"
+
+/**
+ * @brief Called for every exported point
+ */
+typedef void (*PB7200_PointCallback)(uint32_t timestamp, int16_t value, void *context);
+
+/**
+ * @brief Ring of past snapshots
+ *
+ * Channels are numbered as in PB7200Decimator: cells first, then
+ * temperature sensors, then current.
+ */
+class PB7200History {
+public:
+    /**
+     * @brief Constructor
+     * @param buffer Storage for capacity snapshots
+     * @param capacity Number of snapshots kept
+     */
+    PB7200History(PackSnapshot *buffer, uint16_t capacity);
+
+    /**
+     * @brief Append a snapshot, overwriting the oldest when full
+     * @param snapshot Snapshot to store
+     */
+    void push(const PackSnapshot &snapshot);
+
+    /**
+     * @brief Remove all snapshots
+     */
+    void clear();
+
+    /**
+     * @brief Get number of stored snapshots
+     * @return Snapshot count
+     */
+    uint16_t count() const;
+
+    /**
+     * @brief Get ring capacity
+     * @return Maximum number of snapshots
+     */
+    uint16_t capacity() const;
+
+    /**
+     * @brief Get a stored snapshot
+     * @param index 0 = oldest
+     * @return Snapshot or nullptr if out of range
+     */
+    const PackSnapshot *at(uint16_t index) const;
+
+    /**
+     * @brief Get one channel of a stored snapshot
+     * @param index 0 = oldest
+     * @param channel Channel index
+     * @return Value in register counts (0 if out of range)
+     */
+    int16_t value(uint16_t index, uint8_t channel) const;
+
+    /**
+     * @brief Export a channel reduced to a number of points
+     *
+     * Uses Largest-Triangle-Three-Buckets: first and last samples are
+     * kept, and from every bucket in between the sample that forms the
+     * largest triangle with its neighbours is chosen, which preserves
+     * peaks and the visual shape. With fewer samples than points every
+     * sample is exported. Two points export the first and last samples,
+     * one point the last.
+     *
+     * @param channel Channel index
+     * @param points Number of points
+     * @param callback Called for each point, oldest first
+     * @param context Passed to the callback
+     * @return Number of points exported
+     */
+    uint16_t downsample(uint8_t channel, uint16_t points,
+                        PB7200_PointCallback callback, void *context = nullptr) const;
+
+private:
+    PackSnapshot *_buffer;
+    uint16_t _capacity;
+    uint16_t _head;
+    uint16_t _count;
+};
+
+#endif // PB7200HISTORY_H
@@ -0,0 +1,370 @@
+/**
+ * @file PB7200Json.cpp
+ * @brief Streaming JSON writer for snapshots, statistics and events
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ */
+
+#include "PB7200Json.h"
+
+/**
+ * @brief Write into a fixed buffer
+ */
+PB7200JsonWriter::PB7200JsonWriter(char *buffer, uint16_t size) {
+    _write = nullptr;
+    _context = nullptr;
+    _buffer = buffer;
+    _size = size;
+    _used = 0;
+    _length = 0;
+    _first = 0;
+    _depth = 0;
+    _afterKey = false;
+    _overflow = false;
+    if (_size > 0) {
+        _buffer[0] = '\0';
+    }
+}
+
+/**
+ * @brief Stream through an output function
+ */
+PB7200JsonWriter::PB7200JsonWriter(PB7200_WriteFunction write, void *context) {
+    _write = write;
+    _context = context;
+    _buffer = _chunk;
+    _size = PB7200_JSON_CHUNK;
+    _used = 0;
+    _length = 0;
+    _first = 0;
+    _depth = 0;
+    _afterKey = false;
+    _overflow = false;
+}
+
+#ifdef ARDUINO
+/**
+ * @brief Stream to a Print
+ */
+PB7200JsonWriter::PB7200JsonWriter(Print &out)
+    : PB7200JsonWriter(writePrint, &out) {
+}
+
+/**
+ * @brief Forward a chunk to a Print
+ */
+void PB7200JsonWriter::writePrint(const char *data, uint16_t length, void *context) {
+    ((Print *)context)->write((const uint8_t *)data, length);
+}
+#endif
+
+/**
+ * @brief Start an object
+ */
+void PB7200JsonWriter::beginObject() {
+    begin('{');
+}
+
+/**
+ * @brief End the current object
+ */
+void PB7200JsonWriter::endObject() {
+    end('}');
+}
+
+/**
+ * @brief Start an array
+ */
+void PB7200JsonWriter::beginArray() {
+    begin('[');
+}
+
+/**
+ * @brief End the current array
+ */
+void PB7200JsonWriter::endArray() {
+    end(']');
+}
+
+/**
+ * @brief Write an object key
+ */
+void PB7200JsonWriter::key(const char *name) {
+    separator();
+    put('"');
+    while (*name) {
+        put(*name++);
+    }
+    put('"');
+    put(':');
+    _afterKey = true;
+}
+
+/**
+ * @brief Write a string value (escaped)
+ */
+void PB7200JsonWriter::string(const char *text) {
+    static const char hex[] = "0123456789abcdef";
+
+    separator();
+    put('"');
+    for (; *text; text++) {
+        char c = *text;
+        if (c == '"' || c == '\\') {
+            put('\\');
+            put(c);
+        } else if ((uint8_t)c < 0x20) {
+            char escape[6] = {'\\', 'u', '0', '0', hex[(c >> 4) & 0x0F], hex[c & 0x0F]};
+            put(escape, 6);
+        } else {
+            put(c);
+        }
+    }
+    put('"');
+}
+
+/**
+ * @brief Write a signed integer
+ */
+void PB7200JsonWriter::number(int32_t value) {
+    fixed(value, 0);
+}
+
+/**
+ * @brief Write an unsigned integer
+ */
+void PB7200JsonWriter::number(uint32_t value) {
+    char text[PB7200_FORMAT_MAX];
+    separator();
+    put(text, pb7200FormatUnsigned(text, value));
+}
+
+/**
+ * @brief Write a fixed-point value
+ */
+void PB7200JsonWriter::fixed(int32_t value, uint8_t decimals) {
+    char text[PB7200_FORMAT_MAX];
+    separator();
+    put(text, pb7200FormatFixed(text, value, decimals));
+}
+
+/**
+ * @brief Write a boolean
+ */
+void PB7200JsonWriter::boolean(bool value) {
+    separator();
+    if (value) {
+        put("true", 4);
+    } else {
+        put("false", 5);
+    }
+}
+
+/**
+ * @brief Write null
+ */
+void PB7200JsonWriter::null() {
+    separator();
+    put("null", 4);
+}
+
+/**
+ * @brief Send buffered output
+ */
+void PB7200JsonWriter::flush() {
+    if (_write != nullptr && _used > 0) {
+        _write(_chunk, _used, _context);
+        _used = 0;
+    }
+}
+
+/**
+ * @brief Get number of characters written
+ */
+uint32_t PB7200JsonWriter::length() const {
+    return _length;
+}
+
+/**
+ * @brief Check for a full buffer or too deep nesting
+ */
+bool PB7200JsonWriter::overflowed() const {
+    return _overflow;
+}
+
+/**
+ * @brief Write a comma unless this is the first element
+ */
+void PB7200JsonWriter::separator() {
+    if (_afterKey) {
+        _afterKey = false;
+        return;
+    }
+    if (_depth == 0) {
+        return;
+    }
+
+    uint16_t bit = 1U << (_depth - 1);
+    if (_first & bit) {
+        _first &= ~bit;
+    } else {
+        put(',');
+    }
+}
+
+/**
+ * @brief Open an object or array
+ */
+void PB7200JsonWriter::begin(char c) {
+    separator();
+    put(c);
+    if (_depth >= PB7200_JSON_MAX_DEPTH) {
+        _overflow = true;
+        return;
+    }
+    _depth++;
+    _first |= 1U << (_depth - 1);
+}
+
+/**
+ * @brief Close an object or array
+ */
+void PB7200JsonWriter::end(char c) {
+    if (_depth > 0) {
+        _depth--;
+    }
+    _afterKey = false;
+    put(c);
+}
+
+/**
+ * @brief Append one character
+ */
+void PB7200JsonWriter::put(char c) {
+    _length++;
+
+    if (_write != nullptr) {
+        _chunk[_used++] = c;
+        if (_used == PB7200_JSON_CHUNK) {
+            flush();
+        }
+        return;
+    }
+
+    // Fixed buffer: keep room for the terminator
+    if (_used + 1 < _size) {
+        _buffer[_used++] = c;
+        _buffer[_used] = '\0';
+    } else {
+        _overflow = true;
+    }
+}
+
+/**
+ * @brief Append characters
+ */
+void PB7200JsonWriter::put(const char *text, uint16_t length) {
+    for (uint16_t i = 0; i < length; i++) {
+        put(text[i]);
+    }
+}
+
+// ========== Serializers ==========
+
+/**
+ * @brief Write a float member with fixed decimals
+ */
+static void fixedMember(PB7200JsonWriter &writer, const char *name, float value,
+                        uint8_t decimals) {
+    writer.key(name);
+    writer.fixed(pb7200ToFixed(value, decimals), decimals);
+}
+
+/**
+ * @brief Write a snapshot as a JSON object
+ */
+void writeSnapshotJson(PB7200JsonWriter &writer, const PackSnapshot &snapshot) {
+    writer.beginObject();
+    writer.key("seq");
+    writer.number((uint32_t)snapshot.sequence);
+    writer.key("time");
+    writer.number(snapshot.timestamp);
+    writer.key("coherent");
+    writer.boolean(snapshot.coherent);
+    writer.key("status");
+    writer.number((uint32_t)snapshot.status);
+    writer.key("faults");
+    writer.number((uint32_t)snapshot.faultStatus);
+    writer.key("balance");
+    writer.number(snapshot.balanceMask);
+
+    // Counts of 10 mA, 1 mV and 0.1 °C print as A, V and °C
+    writer.key("current");
+    writer.fixed(snapshot.currentRaw, 2);
+
+    writer.key("cells");
+    writer.beginArray();
+    for (uint8_t i = 0; i < snapshot.cellCount; i++) {
+        writer.fixed(snapshot.cellRaw[i], 3);
+    }
+    writer.endArray();
+
+    writer.key("temps");
+    writer.beginArray();
+    for (uint8_t i = 0; i < snapshot.tempCount; i++) {
+        writer.fixed(snapshot.tempRaw[i], 1);
+    }
+    writer.endArray();
+    writer.endObject();
+}
+
+/**
+ * @brief Write pack statistics as a JSON object
+ */
+void writeStatsJson(PB7200JsonWriter &writer, const PackStats &stats) {
+    writer.beginObject();
+    fixedMember(writer, "voltage", stats.totalVoltage, 3);
+    fixedMember(writer, "maxCell", stats.maxCellVoltage, 3);
+    fixedMember(writer, "minCell", stats.minCellVoltage, 3);
+    fixedMember(writer, "avgCell", stats.avgCellVoltage, 3);
+    fixedMember(writer, "delta", stats.voltageDelta, 3);
+    writer.key("maxCellIndex");
+    writer.number((uint32_t)stats.maxCellIndex);
+    writer.key("minCellIndex");
+    writer.number((uint32_t)stats.minCellIndex);
+    fixedMember(writer, "current", stats.current, 2);
+    fixedMember(writer, "power", stats.power, 1);
+    fixedMember(writer, "maxTemp", stats.maxTemp, 1);
+    fixedMember(writer, "minTemp", stats.minTemp, 1);
+    fixedMember(writer, "soc", stats.soc, 1);
+    fixedMember(writer, "remainingAh", stats.remainingAh, 3);
+    fixedMember(writer, "remainingWh", stats.remainingWh, 1);
+    fixedMember(writer, "energyWh", stats.energyWh, 1);
+    fixedMember(writer, "balanceCurrent", stats.balanceCurrent, 3);
+    writer.key("balancing");
+    writer.number((uint32_t)stats.balancingCount);
+    writer.endObject();
+}
+
+/**
+ * @brief Write an event log entry as a JSON object
+ */
+void writeEventJson(PB7200JsonWriter &writer, const EventRecord &event) {
+    static const char *const names[] = {
+        "unknown", "boot", "reset", "fault", "faults_cleared", "comm_lost",
+        "comm_restored", "config_change", "balance_start", "balance_stop", "bus_recovery"
+    };
+    uint8_t type = event.type < sizeof(names) / sizeof(names[0]) ? event.type : 0;
+
+    writer.beginObject();
+    writer.key("seq");
+    writer.number(event.sequence);
+    writer.key("time");
+    writer.number(event.timestamp);
+    writer.key("type");
+    writer.string(names[type]);
+    writer.key("data");
+    writer.number(event.data);
+    writer.endObject();
+}
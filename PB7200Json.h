@@ -0,0 +1,199 @@
+/**
+ * @file PB7200Json.h
+ * @brief Streaming JSON writer for snapshots, statistics and events
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Writes JSON straight to a Print (through a small chunk buffer) or
+ * into a fixed buffer, with no heap use and bounded stack. Numbers are
+ * printed from register counts with PB7200Format, not float printing.
+ */
+
+#ifndef PB7200JSON_H
+#define PB7200JSON_H
+
+#include "PB7200Types.h"
+#include "PB7200Format.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+// Bytes collected before each write to the output
+#ifndef PB7200_JSON_CHUNK
+#define PB7200_JSON_CHUNK 32
+#endif
+
+// Deepest object/array nesting
+#define PB7200_JSON_MAX_DEPTH 16
+
+/**
+ * @brief Output function for streamed JSON
+ */
+typedef void (*PB7200_WriteFunction)(const char *data, uint16_t length, void *context);
+
+/**
+ * @brief Streaming JSON writer
+ *
+ * Commas and nesting are tracked by the writer, so values are simply
+ * written in order:
+ *
+ *   writer.beginObject();
+ *   writer.key("soc"); writer.fixed(805, 1);
+ *   writer.endObject();
+ *   writer.flush();
+ */
+class PB7200JsonWriter {
+public:
+    /**
+     * @brief Write into a fixed buffer (always null-terminated)
+     * @param buffer Output buffer
+     * @param size Buffer size
+     */
+    PB7200JsonWriter(char *buffer, uint16_t size);
+
+    /**
+     * @brief Stream through an output function
+     * @param write Called with each chunk
+     * @param context Passed to write
+     */
+    PB7200JsonWriter(PB7200_WriteFunction write, void *context);
+
+#ifdef ARDUINO
+    /**
+     * @brief Stream to a Print (Serial, WiFiClient, MQTT buffer...)
+     * @param out Output
+     */
+    PB7200JsonWriter(Print &out);
+#endif
+
+    /**
+     * @brief Start an object
+     */
+    void beginObject();
+
+    /**
+     * @brief End the current object
+     */
+    void endObject();
+
+    /**
+     * @brief Start an array
+     */
+    void beginArray();
+
+    /**
+     * @brief End the current array
+     */
+    void endArray();
+
+    /**
+     * @brief Write an object key
+     * @param name Key (not escaped)
+     */
+    void key(const char *name);
+
+    /**
+     * @brief Write a string value (escaped)
+     * @param text String
+     */
+    void string(const char *text);
+
+    /**
+     * @brief Write a signed integer
+     * @param value Value
+     */
+    void number(int32_t value);
+
+    /**
+     * @brief Write an unsigned integer
+     * @param value Value
+     */
+    void number(uint32_t value);
+
+    /**
+     * @brief Write a fixed-point value
+     * @param value Value in units of 10^-decimals
+     * @param decimals Digits after the decimal point
+     */
+    void fixed(int32_t value, uint8_t decimals);
+
+    /**
+     * @brief Write a boolean
+     * @param value Value
+     */
+    void boolean(bool value);
+
+    /**
+     * @brief Write null
+     */
+    void null();
+
+    /**
+     * @brief Send buffered output (streaming mode)
+     */
+    void flush();
+
+    /**
+     * @brief Get number of characters written
+     * @return Length, including characters dropped on overflow
+     */
+    uint32_t length() const;
+
+    /**
+     * @brief Check for a full buffer or too deep nesting
+     * @return true if output was lost
+     */
+    bool overflowed() const;
+
+private:
+    PB7200_WriteFunction _write;
+    void *_context;
+    char *_buffer;
+    uint16_t _size;
+    uint16_t _used;
+    uint32_t _length;
+    uint16_t _first;     // Bit per level: no element written yet
+    uint8_t _depth;
+    bool _afterKey;
+    bool _overflow;
+    char _chunk[PB7200_JSON_CHUNK];
+
+    void separator();
+    void begin(char c);
+    void end(char c);
+    void put(char c);
+    void put(const char *text, uint16_t length);
+
+#ifdef ARDUINO
+    static void writePrint(const char *data, uint16_t length, void *context);
+#endif
+};
+
+/**
+ * @brief Write a snapshot as a JSON object
+ *
+ * {"seq","time","coherent","status","faults","balance","current" (A),
+ *  "cells" (V), "temps" (°C)}
+ *
+ * @param writer Writer
+ * @param snapshot Raw snapshot
+ */
+void writeSnapshotJson(PB7200JsonWriter &writer, const PackSnapshot &snapshot);
+
+/**
+ * @brief Write pack statistics as a JSON object
+ * @param writer Writer
+ * @param stats Statistics
+ */
+void writeStatsJson(PB7200JsonWriter &writer, const PackStats &stats);
+
+/**
+ * @brief Write an event log entry as a JSON object
+ * @param writer Writer
+ * @param event Event
+ */
+void writeEventJson(PB7200JsonWriter &writer, const EventRecord &event);
+
+#endif // PB7200JSON_H
@@ -0,0 +1,375 @@
+/**
+ * @file PB7200Modbus.cpp
+ * @brief Modbus RTU slave serving PB7200P80 snapshot data
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ */
+
+#include "PB7200Modbus.h"
+
+// The CRC table lives in flash on AVR
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define PB7200_CRC_TABLE_READ(i) pgm_read_word(&crcTable[i])
+#else
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#define PB7200_CRC_TABLE_READ(i) crcTable[i]
+#endif
+
+/**
+ * @brief CRC-16/MODBUS of every byte value (reflected polynomial 0xA001)
+ */
+static const uint16_t crcTable[256] PROGMEM = {
+    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+    0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+    0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+    0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+    0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+    0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+    0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+    0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+    0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+    0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+    0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+    0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+    0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+    0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+    0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+    0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+    0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+    0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+    0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+    0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+    0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+    0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+    0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+    0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+    0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+    0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+    0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+    0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+    0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+    0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+    0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
+};
+
+/**
+ * @brief Modbus CRC-16
+ */
+uint16_t pb7200ModbusCrc(const uint8_t *data, uint16_t length) {
+    uint16_t crc = 0xFFFF;
+    for (uint16_t i = 0; i < length; i++) {
+        crc = (crc >> 8) ^ PB7200_CRC_TABLE_READ((crc ^ data[i]) & 0xFF);
+    }
+    return crc;
+}
+
+/**
+ * @brief Temperature in register counts, rounded to nearest
+ */
+static uint16_t tempToRegister(float celsius) {
+    float counts = celsius / PB7200_TEMP_LSB;
+    return (uint16_t)(int16_t)(counts + (counts < 0 ? -0.5f : 0.5f));
+}
+
+/**
+ * @brief Constructor
+ */
+PB7200ModbusSlave::PB7200ModbusSlave(uint8_t address) {
+    _address = address;
+    _snapshot = nullptr;
+    _stats = nullptr;
+    _writeCallback = nullptr;
+    _writeContext = nullptr;
+    _requests = 0;
+    _crcErrors = 0;
+    for (uint8_t i = 0; i < PB7200_MODBUS_HOLDING_COUNT; i++) {
+        _holding[i] = 0;
+    }
+}
+
+/**
+ * @brief Set slave address
+ */
+void PB7200ModbusSlave::setAddress(uint8_t address) {
+    _address = address;
+}
+
+/**
+ * @brief Set data served in input registers
+ */
+void PB7200ModbusSlave::setSource(const PackSnapshot *snapshot, const PackStats *stats) {
+    _snapshot = snapshot;
+    _stats = stats;
+}
+
+/**
+ * @brief Load protection limits into holding registers
+ */
+void PB7200ModbusSlave::setLimits(const ProtectionConfig &config) {
+    _holding[0] = (uint16_t)(config.overVoltageThreshold / PB7200_VOLTAGE_LSB + 0.5);
+    _holding[1] = (uint16_t)(config.underVoltageThreshold / PB7200_VOLTAGE_LSB + 0.5);
+    _holding[2] = (uint16_t)(config.overCurrentThreshold / PB7200_CURRENT_LSB + 0.5);
+    _holding[3] = tempToRegister(config.overTempThreshold);
+    _holding[4] = tempToRegister(config.underTempThreshold);
+    _holding[5] = config.overVoltageDelay;
+    _holding[6] = config.underVoltageDelay;
+    _holding[7] = config.overCurrentDelay;
+}
+
+/**
+ * @brief Read protection limits from holding registers
+ */
+void PB7200ModbusSlave::getLimits(ProtectionConfig &config) const {
+    config.overVoltageThreshold = _holding[0] * PB7200_VOLTAGE_LSB;
+    config.underVoltageThreshold = _holding[1] * PB7200_VOLTAGE_LSB;
+    config.overCurrentThreshold = _holding[2] * PB7200_CURRENT_LSB;
+    config.overTempThreshold = (int16_t)_holding[3] * PB7200_TEMP_LSB;
+    config.underTempThreshold = (int16_t)_holding[4] * PB7200_TEMP_LSB;
+    config.overVoltageDelay = _holding[5];
+    config.underVoltageDelay = _holding[6];
+    config.overCurrentDelay = _holding[7];
+}
+
+/**
+ * @brief Set function called after a write request
+ */
+void PB7200ModbusSlave::setWriteCallback(PB7200_ModbusWriteCallback callback, void *context) {
+    _writeCallback = callback;
+    _writeContext = context;
+}
+
+/**
+ * @brief Process one received frame
+ */
+uint16_t PB7200ModbusSlave::handleFrame(const uint8_t *request, uint16_t length,
+                                        uint8_t *response) {
+    // Shortest request: address, function, CRC
+    if (length < 4 || length > PB7200_MODBUS_MAX_FRAME) {
+        return 0;
+    }
+
+    uint8_t address = request[0];
+    if (address != _address && address != 0) {
+        return 0;
+    }
+
+    uint16_t crc = request[length - 2] | ((uint16_t)request[length - 1] << 8);
+    if (pb7200ModbusCrc(request, length - 2) != crc) {
+        _crcErrors++;
+        return 0;
+    }
+    _requests++;
+
+    // Broadcasts are executed but never answered
+    bool broadcast = address == 0;
+    uint8_t function = request[1];
+    uint16_t pduLength = length - 4;
+    const uint8_t *pdu = request + 2;
+
+    response[0] = _address;
+    response[1] = function;
+
+    switch (function) {
+        case 0x03:
+        case 0x04: {
+            if (broadcast) {
+                return 0;
+            }
+            if (pduLength != 4) {
+                return exception(function, PB7200_MODBUS_ILLEGAL_VALUE, response);
+            }
+            uint16_t start = ((uint16_t)pdu[0] << 8) | pdu[1];
+            uint16_t count = ((uint16_t)pdu[2] << 8) | pdu[3];
+            if (count == 0 || count > 125 || 5 + 2 * count > PB7200_MODBUS_MAX_FRAME) {
+                return exception(function, PB7200_MODBUS_ILLEGAL_VALUE, response);
+            }
+
+            response[2] = count * 2;
+            uint8_t *p = response + 3;
+            for (uint16_t i = 0; i < count; i++) {
+                uint16_t value;
+                uint16_t reg = start + i;
+                if (function == 0x03) {
+                    if (reg >= PB7200_MODBUS_HOLDING_COUNT) {
+                        return exception(function, PB7200_MODBUS_ILLEGAL_ADDRESS, response);
+                    }
+                    value = _holding[reg];
+                } else if (!inputRegister(reg, value)) {
+                    return exception(function, PB7200_MODBUS_ILLEGAL_ADDRESS, response);
+                }
+                p[2 * i] = value >> 8;
+                p[2 * i + 1] = value & 0xFF;
+            }
+            return finish(response, 3 + 2 * count);
+        }
+
+        case 0x06: {
+            if (pduLength != 4) {
+                return broadcast ? 0 : exception(function, PB7200_MODBUS_ILLEGAL_VALUE, response);
+            }
+            uint16_t reg = ((uint16_t)pdu[0] << 8) | pdu[1];
+            if (reg >= PB7200_MODBUS_HOLDING_COUNT) {
+                return broadcast ? 0 : exception(function, PB7200_MODBUS_ILLEGAL_ADDRESS, response);
+            }
+            _holding[reg] = ((uint16_t)pdu[2] << 8) | pdu[3];
+            if (_writeCallback != nullptr) {
+                _writeCallback(reg, 1, _writeContext);
+            }
+
+            // Echo of the request
+            if (broadcast) {
+                return 0;
+            }
+            for (uint8_t i = 0; i < 4; i++) {
+                response[2 + i] = pdu[i];
+            }
+            return finish(response, 6);
+        }
+
+        case 0x10: {
+            if (pduLength < 5) {
+                return broadcast ? 0 : exception(function, PB7200_MODBUS_ILLEGAL_VALUE, response);
+            }
+            uint16_t start = ((uint16_t)pdu[0] << 8) | pdu[1];
+            uint16_t count = ((uint16_t)pdu[2] << 8) | pdu[3];
+            uint8_t bytes = pdu[4];
+            if (count == 0 || count > 123 || bytes != count * 2 || pduLength != 5 + bytes) {
+                return broadcast ? 0 : exception(function, PB7200_MODBUS_ILLEGAL_VALUE, response);
+            }
+            if (start + count > PB7200_MODBUS_HOLDING_COUNT) {
+                return broadcast ? 0 : exception(function, PB7200_MODBUS_ILLEGAL_ADDRESS, response);
+            }
+
+            for (uint16_t i = 0; i < count; i++) {
+                _holding[start + i] = ((uint16_t)pdu[5 + 2 * i] << 8) | pdu[6 + 2 * i];
+            }
+            if (_writeCallback != nullptr) {
+                _writeCallback(start, count, _writeContext);
+            }
+
+            if (broadcast) {
+                return 0;
+            }
+            for (uint8_t i = 0; i < 4; i++) {
+                response[2 + i] = pdu[i];
+            }
+            return finish(response, 6);
+        }
+
+        default:
+            return broadcast ? 0 : exception(function, PB7200_MODBUS_ILLEGAL_FUNCTION, response);
+    }
+}
+
+/**
+ * @brief Get number of frames addressed to this slave
+ */
+uint32_t PB7200ModbusSlave::getRequestCount() const {
+    return _requests;
+}
+
+/**
+ * @brief Get number of frames dropped for a bad CRC
+ */
+uint32_t PB7200ModbusSlave::getCrcErrors() const {
+    return _crcErrors;
+}
+
+/**
+ * @brief Compute one input register from the snapshot
+ */
+bool PB7200ModbusSlave::inputRegister(uint16_t address, uint16_t &value) const {
+    if (_snapshot == nullptr) {
+        return false;
+    }
+    const PackSnapshot &s = *_snapshot;
+
+    if (address >= PB7200_MODBUS_CELL_BASE && address < PB7200_MODBUS_CELL_BASE + PB7200_MAX_CELLS) {
+        uint8_t cell = address - PB7200_MODBUS_CELL_BASE;
+        value = cell < s.cellCount ? s.cellRaw[cell] : 0;
+        return true;
+    }
+    if (address >= PB7200_MODBUS_TEMP_BASE && address < PB7200_MODBUS_TEMP_BASE + PB7200_MAX_TEMPS) {
+        uint8_t sensor = address - PB7200_MODBUS_TEMP_BASE;
+        value = sensor < s.tempCount ? (uint16_t)s.tempRaw[sensor] : 0;
+        return true;
+    }
+    if (address >= PB7200_MODBUS_INPUT_COUNT) {
+        return false;
+    }
+
+    switch (address) {
+        case 0: value = s.cellCount; return true;
+        case 1: value = s.tempCount; return true;
+        case 2: value = s.status; return true;
+        case 3: value = s.faultStatus; return true;
+        case 4: value = s.balanceMask & 0xFFFF; return true;
+        case 5: value = s.balanceMask >> 16; return true;
+        case 6: value = (uint16_t)s.currentRaw; return true;
+        case 13: {
+            float soc = _stats != nullptr ? _stats->soc : 0.0;
+            value = soc <= 0.0 ? 0 : (uint16_t)(soc * 10.0 + 0.5);
+            return true;
+        }
+        case 14: value = s.sequence; return true;
+        default: break;
+    }
+
+    // Pack-level values: one pass over the cells or sensors
+    if (address <= 10) {
+        uint32_t total = 0;
+        uint16_t maxRaw = 0;
+        uint16_t minRaw = s.cellCount ? 0xFFFF : 0;
+        for (uint8_t i = 0; i < s.cellCount; i++) {
+            uint16_t raw = s.cellRaw[i];
+            total += raw;
+            maxRaw = raw > maxRaw ? raw : maxRaw;
+            minRaw = raw < minRaw ? raw : minRaw;
+        }
+        if (address == 7) {
+            uint32_t pack10mV = (total + 5) / 10;
+            value = pack10mV > 0xFFFF ? 0xFFFF : (uint16_t)pack10mV;
+        } else if (address == 8) {
+            value = maxRaw;
+        } else if (address == 9) {
+            value = minRaw;
+        } else {
+            value = s.cellCount ? (uint16_t)((total + s.cellCount / 2) / s.cellCount) : 0;
+        }
+        return true;
+    }
+
+    int16_t maxTemp = s.tempCount ? s.tempRaw[0] : 0;
+    int16_t minTemp = maxTemp;
+    for (uint8_t i = 1; i < s.tempCount; i++) {
+        maxTemp = s.tempRaw[i] > maxTemp ? s.tempRaw[i] : maxTemp;
+        minTemp = s.tempRaw[i] < minTemp ? s.tempRaw[i] : minTemp;
+    }
+    value = (uint16_t)(address == 11 ? maxTemp : minTemp);
+    return true;
+}
+
+/**
+ * @brief Build an exception response
+ */
+uint16_t PB7200ModbusSlave::exception(uint8_t function, uint8_t code, uint8_t *response) const {
+    response[0] = _address;
+    response[1] = function | 0x80;
+    response[2] = code;
+    return finish(response, 3);
+}
+
+/**
+ * @brief Append the CRC to a response
+ */
+uint16_t PB7200ModbusSlave::finish(uint8_t *response, uint16_t length) const {
+    uint16_t crc = pb7200ModbusCrc(response, length);
+    response[length] = crc & 0xFF;
+    response[length + 1] = crc >> 8;
+    return length + 2;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file PB7200Modbus.h
+ * @brief Modbus RTU slave serving PB7200P80 snapshot data
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * The slave is a pure frame handler: give it a received RTU frame and
+ * it returns the response built from the last snapshot, without any
+ * access to the chip. Serial framing lives in PB7200ModbusSerial.h
+ * (Arduino Stream) so the handler also runs on a Linux host, e.g.
+ * behind a pseudo-terminal.
+ *
+ * Input registers (function 0x04), read-only:
+ *   0 cell count            7 pack voltage (10 mV)   12 min temp (0.1 °C)
+ *   1 sensor count          8 max cell (mV)          13 SOC (0.1 %)
+ *   2 status                9 min cell (mV)          14 snapshot sequence
+ *   3 fault status         10 mean cell (mV)
+ *   4 balance mask (low)   11 max temp (0.1 °C)
+ *   5 balance mask (high)
+ *   6 current (10 mA, signed)
+ *   32-51 cell voltages (mV), 64-71 temperatures (0.1 °C, signed)
+ *
+ * Holding registers (functions 0x03, 0x06, 0x10), protection limits:
+ *   0 over-voltage (mV)     3 over-temp (0.1 °C)     5 over-voltage delay (ms)
+ *   1 under-voltage (mV)    4 under-temp (0.1 °C)    6 under-voltage delay (ms)
+ *   2 over-current (10 mA)                           7 over-current delay (ms)
+ */
+
+#ifndef PB7200MODBUS_H
+#define PB7200MODBUS_H
+
+#include "PB7200Types.h"
+
+// Largest RTU frame (address + PDU + CRC)
+#ifndef PB7200_MODBUS_MAX_FRAME
+#define PB7200_MODBUS_MAX_FRAME 256
+#endif
+
+// Register map
+#define PB7200_MODBUS_INPUT_COUNT 15
+#define PB7200_MODBUS_CELL_BASE 32
+#define PB7200_MODBUS_TEMP_BASE 64
+#define PB7200_MODBUS_HOLDING_COUNT 8
+
+// Exception codes
+#define PB7200_MODBUS_ILLEGAL_FUNCTION 0x01
+#define PB7200_MODBUS_ILLEGAL_ADDRESS 0x02
+#define PB7200_MODBUS_ILLEGAL_VALUE 0x03
+
+/**
+ * @brief Called after holding registers were written
+ */
+typedef void (*PB7200_ModbusWriteCallback)(uint16_t address, uint16_t count, void *context);
+
+/**
+ * @brief Modbus RTU slave frame handler
+ */
+class PB7200ModbusSlave {
+public:
+    /**
+     * @brief Constructor
+     * @param address Slave address (1-247)
+     */
+    PB7200ModbusSlave(uint8_t address = 1);
+
+    /**
+     * @brief Set slave address
+     * @param address Slave address (1-247)
+     */
+    void setAddress(uint8_t address);
+
+    /**
+     * @brief Set data served in input registers
+     * @param snapshot Snapshot (read on every request, not copied)
+     * @param stats Statistics for SOC (optional)
+     */
+    void setSource(const PackSnapshot *snapshot, const PackStats *stats = nullptr);
+
+    /**
+     * @brief Load protection limits into holding registers
+     * @param config Protection configuration
+     */
+    void setLimits(const ProtectionConfig &config);
+
+    /**
+     * @brief Read protection limits from holding registers
+     * @param config Structure to store configuration
+     */
+    void getLimits(ProtectionConfig &config) const;
+
+    /**
+     * @brief Set function called after a write request
+     * @param callback Callback (nullptr = none)
+     * @param context Passed to the callback
+     */
+    void setWriteCallback(PB7200_ModbusWriteCallback callback, void *context = nullptr);
+
+    /**
+     * @brief Process one received frame
+     * @param request Frame including CRC
+     * @param length Frame length
+     * @param response Buffer of PB7200_MODBUS_MAX_FRAME bytes
+     * @return Response length (0 = no reply)
+     */
+    uint16_t handleFrame(const uint8_t *request, uint16_t length, uint8_t *response);
+
+    /**
+     * @brief Get number of frames addressed to this slave
+     * @return Request count
+     */
+    uint32_t getRequestCount() const;
+
+    /**
+     * @brief Get number of frames dropped for a bad CRC
+     * @return Error count
+     */
+    uint32_t getCrcErrors() const;
+
+private:
+    const PackSnapshot *_snapshot;
+    const PackStats *_stats;
+    PB7200_ModbusWriteCallback _writeCallback;
+    void *_writeContext;
+    uint16_t _holding[PB7200_MODBUS_HOLDING_COUNT];
+    uint32_t _requests;
+    uint32_t _crcErrors;
+    uint8_t _address;
+
+    bool inputRegister(uint16_t address, uint16_t &value) const;
+    uint16_t exception(uint8_t function, uint8_t code, uint8_t *response) const;
+    uint16_t finish(uint8_t *response, uint16_t length) const;
+};
+
+/**
+ * @brief Modbus CRC-16 (polynomial 0xA001, table-driven)
+ * @param data Bytes
+ * @param length Number of bytes
+ * @return CRC (low byte is sent first)
+ */
+uint16_t pb7200ModbusCrc(const uint8_t *data, uint16_t length);
+
+#endif // PB7200MODBUS_H
@@ -0,0 +1,87 @@
+/**
+ * @file PB7200ModbusSerial.h
+ * @brief Modbus RTU framing on an Arduino Stream
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ * 
+ * Header-only so that the frame handler in PB7200Modbus.h stays
+ * Arduino-free. A frame ends after 3.5 character times of silence
+ * (fixed 1.75 ms above 19200 baud, as the specification allows).
+ */
+
+#ifndef PB7200MODBUSSERIAL_H
+#define PB7200MODBUSSERIAL_H
+
+#include <Arduino.h>
+#include "PB7200Modbus.h"
+
+/**
+ * @brief Serves a PB7200ModbusSlave on a serial port
+ */
+class PB7200ModbusSerial {
+public:
+    /**
+     * @brief Constructor
+     * @param slave Frame handler
+     * @param stream Serial port (already started)
+     * @param baud Baud rate of the port
+     * @param txEnablePin RS-485 driver enable pin (-1 = none)
+     */
+    PB7200ModbusSerial(PB7200ModbusSlave &slave, Stream &stream, uint32_t baud,
+                       int8_t txEnablePin = -1)
+        : _slave(slave), _stream(stream), _txEnablePin(txEnablePin), _length(0), _lastByte(0) {
+        // 11 bits per character
+        _frameGap = baud > 19200 ? 1750 : (uint32_t)(3.5 * 11 * 1000000.0 / baud);
+        if (_txEnablePin >= 0) {
+            pinMode(_txEnablePin, OUTPUT);
+            digitalWrite(_txEnablePin, LOW);
+        }
+    }
+
+    /**
+     * @brief Receive bytes and answer complete frames (call every loop)
+     * @return true if a response was sent
+     */
+    bool poll() {
+        while (_stream.available() > 0) {
+            uint8_t c = _stream.read();
+            if (_length < PB7200_MODBUS_MAX_FRAME) {
+                _buffer[_length++] = c;
+            }
+            _lastByte = micros();
+        }
+
+        if (_length == 0 || micros() - _lastByte < _frameGap) {
+            return false;
+        }
+
+        uint8_t response[PB7200_MODBUS_MAX_FRAME];
+        uint16_t responseLength = _slave.handleFrame(_buffer, _length, response);
+        _length = 0;
+        if (responseLength == 0) {
+            return false;
+        }
+
+        if (_txEnablePin >= 0) {
+            digitalWrite(_txEnablePin, HIGH);
+        }
+        _stream.write(response, responseLength);
+        _stream.flush();
+        if (_txEnablePin >= 0) {
+            digitalWrite(_txEnablePin, LOW);
+        }
+        return true;
+    }
+
+private:
+    PB7200ModbusSlave &_slave;
+    Stream &_stream;
+    int8_t _txEnablePin;
+    uint16_t _length;
+    unsigned long _lastByte;
+    uint32_t _frameGap;
+    uint8_t _buffer[PB7200_MODBUS_MAX_FRAME];
+};
+
+#endif // PB7200MODBUSSERIAL_H
@@ -7,6 +7,8 @@
  */
 
 #include "PB7200P80.h"
+#include "PB7200Stats.h"
+#include "PB7200Format.h"
 
 /**
  * @brief Class constructor
@@ -16,12 +18,86 @@ PB7200P80::PB7200P80(PB7200_Interface interface, uint8_t address, TwoWire *wire)
     _i2cAddress = address;
     _wire = wire;
     _serial = nullptr;
+    _transport = nullptr;
+    init();
+}
+
+/**
+ * @brief Constructor for a chip reached through a custom transport
+ */
+PB7200P80::PB7200P80(PB7200Transport &transport) {
+    _interface = PB7200_INTERFACE_TRANSPORT;
+    _i2cAddress = 0;
+    _wire = nullptr;
+    _serial = nullptr;
+    _transport = &transport;
+    init();
+}
+
+/**
+ * @brief Reset all driver state to power-on defaults
+ */
+void PB7200P80::init() {
     _cellCount = 0;
-    _tempSensorCount = 8;
+    _tempSensorCount = 0;
+    _cellMask = 0;
+    _tempMask = 0;
+    _cellBurstCount = 0;
+    _tempBurstCount = 0;
     _current = 0.0;
     _status = 0;
     _faultStatus = 0;
     _lastUpdate = 0;
+    memset(&_snapshot, 0, sizeof(_snapshot));
+    memset(&_stats, 0, sizeof(_stats));
+    memset(&_counters, 0, sizeof(_counters));
+    memset(&_robust, 0, sizeof(_robust));
+    memset(&_ranking, 0, sizeof(_ranking));
+    resetAnomaly(_anomaly, PB7200_ANOMALY_WINDOW, PB7200_ANOMALY_ALARM_Z);
+    
+    for (uint8_t i = 0; i < PB7200_RECORD_COUNT; i++) {
+        _records[i].raw = 0;
+        _records[i].timestamp = 0;
+        _records[i].index = 0xFF;
+    }
+    _recordsDirty = 0;
+    _recordsFlushed = false;
+    _recordFlushInterval = PB7200_RECORD_FLUSH_MS;
+    _lastRecordFlush = 0;
+    _timeSource = nullptr;
+    
+    _checkpointCharge = 0;
+    _checkpointBalance = 0;
+    _checkpointEnergy = 0;
+    _checkpointStep = PB7200_CHECKPOINT_STEP;
+    _checkpointMinInterval = PB7200_CHECKPOINT_MIN_MS;
+    _checkpointMaxInterval = PB7200_CHECKPOINT_MAX_MS;
+    _lastCheckpoint = 0;
+    
+    _loggedFaults = 0;
+    _loggedBalanceMask = 0;
+    _balanceStartTime = 0;
+    _commOk = true;
+    _commLostTime = 0;
+    memset(_sortedCells, 0, sizeof(_sortedCells));
+    memset(_sortedTemps, 0, sizeof(_sortedTemps));
+    _packConfig.parallelCount = 1;
+    _packConfig.groupCapacityAh = 0.0;
+    _packConfig.balanceResistance = 0.0;
+    
+    _coherentMode = false;
+    _conversionTimeout = PB7200_CONVERSION_TIMEOUT_MS;
+    _acqState = PB7200_ACQ_IDLE;
+    _conversionStart = 0;
+    _conversionTime = 0;
+    _expectedConversionTime = 0;
+    _conversionPolls = 0;
+    
+    _retries = PB7200_DEFAULT_RETRIES;
+    _recoveryThreshold = PB7200_RECOVERY_FAILURES;
+    _failedUpdates = 0;
+    _confirmFaults = true;
+    memset(&_timing, 0, sizeof(_timing));
     
     // Initialize arrays
     for (uint8_t i = 0; i < PB7200_MAX_CELLS; i++) {
@@ -30,6 +106,9 @@ PB7200P80::PB7200P80(PB7200_Interface interface, uint8_t address, TwoWire *wire)
     for (uint8_t i = 0; i < PB7200_MAX_TEMPS; i++) {
         _temperatures[i] = 0.0;
     }
+    
+    // All sensors fitted by default
+    setTempSensorMask(0xFF);
 }
 
 /**
@@ -40,10 +119,23 @@ bool PB7200P80::begin(uint8_t cellCount) {
         return false;
     }
     
-    _cellCount = cellCount;
+    // Keep a custom tap mask (set before begin() or across reset())
+    // as long as it matches the cell count
+    uint32_t mask = _cellMask;
+    uint8_t maskCount = 0;
+    for (; mask; mask &= mask - 1) {
+        maskCount++;
+    }
+    if (maskCount != cellCount) {
+        setCellMask((1UL << cellCount) - 1);
+    }
     
     // Initialize communication interface
-    if (_interface == PB7200_INTERFACE_I2C) {
+    if (_interface == PB7200_INTERFACE_TRANSPORT) {
+        if (!_transport->begin()) {
+            return false;
+        }
+    } else if (_interface == PB7200_INTERFACE_I2C) {
         _wire->begin();
         _wire->setClock(100000); // 100kHz default
     } else {
@@ -69,6 +161,7 @@ bool PB7200P80::begin(uint8_t cellCount) {
     // First reading
     update();
     
+    logEvent(PB7200_EVENT_BOOT, _cellCount);
     return true;
 }
 
@@ -92,6 +185,101 @@ uint8_t PB7200P80::getDeviceID() {
     return deviceID;
 }
 
+/**
+ * @brief Select which cell taps are wired
+ */
+bool PB7200P80::setCellMask(uint32_t tapMask) {
+    if (tapMask == 0 || (tapMask >> PB7200_MAX_CELLS) != 0) {
+        return false;
+    }
+    
+    // Logical order follows tap order
+    uint8_t taps[PB7200_MAX_CELLS];
+    uint8_t count = 0;
+    for (uint8_t tap = 0; tap < PB7200_MAX_CELLS; tap++) {
+        if (tapMask & (1UL << tap)) {
+            taps[count++] = tap;
+        }
+    }
+    
+    return setCellTapMap(taps, count);
+}
+
+/**
+ * @brief Map logical cells to arbitrary physical taps
+ */
+bool PB7200P80::setCellTapMap(const uint8_t *taps, uint8_t count) {
+    if (count == 0 || count > PB7200_MAX_CELLS) {
+        return false;
+    }
+    
+    uint32_t mask = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (taps[i] >= PB7200_MAX_CELLS || (mask & (1UL << taps[i]))) {
+            return false;
+        }
+        mask |= (1UL << taps[i]);
+    }
+    
+    memset(_tapCell, 0xFF, sizeof(_tapCell));
+    for (uint8_t i = 0; i < count; i++) {
+        _cellTap[i] = taps[i];
+        _tapCell[taps[i]] = i;
+    }
+    
+    _cellMask = mask;
+    _cellCount = count;
+    buildCellPlan();
+    return true;
+}
+
+/**
+ * @brief Get physical tap of a logical cell
+ */
+uint8_t PB7200P80::getCellTap(uint8_t cellIndex) {
+    if (!isValidCellIndex(cellIndex)) {
+        return 0xFF;
+    }
+    return _cellTap[cellIndex];
+}
+
+/**
+ * @brief Get the cell tap mask
+ */
+uint32_t PB7200P80::getCellMask() {
+    return _cellMask;
+}
+
+/**
+ * @brief Get number of configured cells
+ */
+uint8_t PB7200P80::getCellCount() {
+    return _cellCount;
+}
+
+/**
+ * @brief Select which temperature sensors are fitted
+ */
+bool PB7200P80::setTempSensorMask(uint8_t sensorMask) {
+    _tempMask = sensorMask;
+    buildTempPlan();
+    return true;
+}
+
+/**
+ * @brief Get the temperature sensor mask
+ */
+uint8_t PB7200P80::getTempSensorMask() {
+    return _tempMask;
+}
+
+/**
+ * @brief Get number of configured temperature sensors
+ */
+uint8_t PB7200P80::getTempSensorCount() {
+    return _tempSensorCount;
+}
+
 // ========== Voltage Reading ==========
 
 /**
@@ -102,7 +290,7 @@ float PB7200P80::getCellVoltage(uint8_t cellIndex) {
         return 0.0;
     }
     
-    uint8_t regAddr = PB7200_REG_CELL_VOLTAGE_BASE + (cellIndex * 2);
+    uint8_t regAddr = PB7200_REG_CELL_VOLTAGE_BASE + (_cellTap[cellIndex] * 2);
     uint8_t data[2];
     
     if (readRegisters(regAddr, data, 2)) {
@@ -122,13 +310,12 @@ bool PB7200P80::getAllCellVoltages(float *voltages, uint8_t count) {
         return false;
     }
     
-    uint8_t dataLength = count * 2;
-    uint8_t data[PB7200_MAX_CELLS * 2];
-    
-    if (readRegisters(PB7200_REG_CELL_VOLTAGE_BASE, data, dataLength)) {
+    // Read outside the snapshot so it stays one coherent acquisition
+    uint16_t raw[PB7200_MAX_CELLS];
+    if (readChannels(PB7200_REG_CELL_VOLTAGE_BASE, _cellBursts, _cellBurstCount,
+                     _tapCell, raw)) {
         for (uint8_t i = 0; i < count; i++) {
-            uint16_t raw = (data[i * 2] << 8) | data[i * 2 + 1];
-            voltages[i] = rawToVoltage(raw);
+            voltages[i] = rawToVoltage(raw[i]);
             _cellVoltages[i] = voltages[i];
         }
         return true;
@@ -210,7 +397,7 @@ float PB7200P80::getTemperature(uint8_t tempIndex) {
         return 0.0;
     }
     
-    uint8_t regAddr = PB7200_REG_TEMP_BASE + (tempIndex * 2);
+    uint8_t regAddr = PB7200_REG_TEMP_BASE + (_tempSensor[tempIndex] * 2);
     uint8_t data[2];
     
     if (readRegisters(regAddr, data, 2)) {
@@ -226,17 +413,16 @@ float PB7200P80::getTemperature(uint8_t tempIndex) {
  * @brief Read all temperatures
  */
 bool PB7200P80::getAllTemperatures(float *temperatures, uint8_t count) {
-    if (count > PB7200_MAX_TEMPS) {
+    if (count > _tempSensorCount) {
         return false;
     }
     
-    uint8_t dataLength = count * 2;
-    uint8_t data[PB7200_MAX_TEMPS * 2];
-    
-    if (readRegisters(PB7200_REG_TEMP_BASE, data, dataLength)) {
+    // Read outside the snapshot so it stays one coherent acquisition
+    int16_t raw[PB7200_MAX_TEMPS];
+    if (readChannels(PB7200_REG_TEMP_BASE, _tempBursts, _tempBurstCount,
+                     _sensorTemp, (uint16_t *)raw)) {
         for (uint8_t i = 0; i < count; i++) {
-            int16_t raw = (data[i * 2] << 8) | data[i * 2 + 1];
-            temperatures[i] = rawToTemp(raw);
+            temperatures[i] = rawToTemp(raw[i]);
             _temperatures[i] = temperatures[i];
         }
         return true;
@@ -352,7 +538,14 @@ bool PB7200P80::isUnderTemperature() {
  * @brief Clear fault flags
  */
 bool PB7200P80::clearFaults() {
-    return writeRegister(PB7200_REG_FAULT_STATUS, 0x00);
+    if (!writeRegister(PB7200_REG_FAULT_STATUS, 0x00)) {
+        return false;
+    }
+    
+    logEvent(PB7200_EVENT_FAULTS_CLEARED, _loggedFaults);
+    _loggedFaults = 0;
+    _faultStatus = 0;
+    return true;
 }
 
 // ========== Cell Balancing ==========
@@ -365,9 +558,10 @@ bool PB7200P80::setBalancing(uint8_t cellIndex, bool enable) {
         return false;
     }
     
-    // Determine which control register to use (3 registers for 20 cells)
-    uint8_t regOffset = cellIndex / 8;
-    uint8_t bitOffset = cellIndex % 8;
+    // Determine which control register to use (3 registers for 20 taps)
+    uint8_t tap = _cellTap[cellIndex];
+    uint8_t regOffset = tap / 8;
+    uint8_t bitOffset = tap % 8;
     uint8_t regAddr = PB7200_REG_BALANCE_CTRL1 + regOffset;
     
     uint8_t currentValue;
@@ -410,8 +604,9 @@ bool PB7200P80::isBalancing(uint8_t cellIndex) {
         return false;
     }
     
-    uint8_t regOffset = cellIndex / 8;
-    uint8_t bitOffset = cellIndex % 8;
+    uint8_t tap = _cellTap[cellIndex];
+    uint8_t regOffset = tap / 8;
+    uint8_t bitOffset = tap % 8;
     uint8_t regAddr = PB7200_REG_BALANCE_CTRL1 + regOffset;
     
     uint8_t value;
@@ -422,6 +617,33 @@ bool PB7200P80::isBalancing(uint8_t cellIndex) {
     return false;
 }
 
+/**
+ * @brief Set balancing for all cells at once
+ */
+bool PB7200P80::setBalancingMask(uint32_t cellMask) {
+    uint32_t tapBits = 0;
+    for (uint8_t i = 0; i < _cellCount; i++) {
+        if (cellMask & (1UL << i)) {
+            tapBits |= (1UL << _cellTap[i]);
+        }
+    }
+    
+    uint8_t values[3];
+    values[0] = tapBits & 0xFF;
+    values[1] = (tapBits >> 8) & 0xFF;
+    values[2] = (tapBits >> 16) & 0xFF;
+    
+    return writeRegisters(PB7200_REG_BALANCE_CTRL1, values, 3);
+}
+
+/**
+ * @brief Balance the highest cells
+ */
+bool PB7200P80::balanceTopCells(uint8_t k, uint16_t threshold) {
+    uint16_t thresholdRaw = voltageToRaw(threshold / 1000.0);
+    return setBalancingMask(selectBalanceCells(_snapshot, _ranking, k, thresholdRaw));
+}
+
 /**
  * @brief Disable balancing for all cells
  */
@@ -464,6 +686,7 @@ bool PB7200P80::setProtectionConfig(const ProtectionConfig &config) {
     success &= writeRegister(PB7200_REG_CONFIG_UTP, (utpRaw >> 8) & 0xFF);
     success &= writeRegister(PB7200_REG_CONFIG_UTP + 1, utpRaw & 0xFF);
     
+    logEvent(PB7200_EVENT_CONFIG_CHANGE, success);
     return success;
 }
 
@@ -535,6 +758,8 @@ bool PB7200P80::setMode(PB7200_Mode mode) {
  * @brief Reset device
  */
 bool PB7200P80::reset() {
+    logEvent(PB7200_EVENT_RESET);
+    
     // Write reset command
     if (writeRegister(PB7200_REG_CONTROL, 0x80)) {
         delay(100);
@@ -575,268 +800,918 @@ bool PB7200P80::getPackStats(PackStats &stats) {
         return false;
     }
     
-    stats.totalVoltage = 0.0;
-    stats.maxCellVoltage = 0.0;
-    stats.minCellVoltage = 5.0;
-    stats.avgCellVoltage = 0.0;
-    stats.maxCellIndex = 0;
-    stats.minCellIndex = 0;
-    
-    // Process voltages
-    for (uint8_t i = 0; i < _cellCount; i++) {
-        stats.totalVoltage += _cellVoltages[i];
-        
-        if (_cellVoltages[i] > stats.maxCellVoltage) {
-            stats.maxCellVoltage = _cellVoltages[i];
-            stats.maxCellIndex = i;
-        }
-        
-        if (_cellVoltages[i] < stats.minCellVoltage && _cellVoltages[i] > 0.0) {
-            stats.minCellVoltage = _cellVoltages[i];
-            stats.minCellIndex = i;
-        }
+    stats = _stats;
+    return true;
+}
+
+/**
+ * @brief Get median and quartiles of the last snapshot
+ */
+bool PB7200P80::getRobustStats(RobustStats &robust) {
+    robust = _robust;
+    return _snapshot.sequence != 0;
+}
+
+/**
+ * @brief Get a cell voltage percentile of the last snapshot
+ */
+float PB7200P80::getCellVoltagePercentile(uint8_t percent) {
+    return percentileRaw(_sortedCells, _snapshot.cellCount, percent) * PB7200_VOLTAGE_LSB;
+}
+
+/**
+ * @brief Get a temperature percentile of the last snapshot
+ */
+float PB7200P80::getTemperaturePercentile(uint8_t percent) {
+    return percentileRaw(_sortedTemps, _snapshot.tempCount, percent) * PB7200_TEMP_LSB;
+}
+
+/**
+ * @brief Get the k highest cells of the last snapshot
+ */
+uint8_t PB7200P80::getTopCells(uint8_t *cells, uint8_t k) {
+    uint8_t n = min(k, _ranking.count);
+    for (uint8_t i = 0; i < n; i++) {
+        cells[i] = _ranking.order[_ranking.count - 1 - i];
     }
-    
-    stats.avgCellVoltage = stats.totalVoltage / _cellCount;
-    stats.voltageDelta = stats.maxCellVoltage - stats.minCellVoltage;
-    
-    // Process temperatures
-    stats.maxTemp = -100.0;
-    stats.minTemp = 200.0;
-    stats.maxTempIndex = 0;
-    stats.minTempIndex = 0;
-    
-    for (uint8_t i = 0; i < _tempSensorCount; i++) {
-        if (_temperatures[i] > stats.maxTemp) {
-            stats.maxTemp = _temperatures[i];
-            stats.maxTempIndex = i;
-        }
-        
-        if (_temperatures[i] < stats.minTemp && _temperatures[i] > -50.0) {
-            stats.minTemp = _temperatures[i];
-            stats.minTempIndex = i;
+    return n;
+}
+
+/**
+ * @brief Get the k lowest cells of the last snapshot
+ */
+uint8_t PB7200P80::getBottomCells(uint8_t *cells, uint8_t k) {
+    uint8_t n = min(k, _ranking.count);
+    for (uint8_t i = 0; i < n; i++) {
+        cells[i] = _ranking.order[i];
+    }
+    return n;
+}
+
+/**
+ * @brief Get rank of a cell in the last snapshot
+ */
+uint8_t PB7200P80::getCellRank(uint8_t cellIndex) {
+    for (uint8_t i = 0; i < _ranking.count; i++) {
+        if (_ranking.order[i] == cellIndex) {
+            return i;
         }
     }
-    
-    // Current and power
-    stats.current = _current;
-    stats.power = stats.totalVoltage * _current;
-    
-    return true;
+    return 0xFF;
+}
+
+/**
+ * @brief Configure per-cell anomaly scoring
+ */
+void PB7200P80::setAnomalyDetection(float alarmZ, uint16_t window) {
+    resetAnomaly(_anomaly, window, alarmZ);
+}
+
+/**
+ * @brief Get smoothed anomaly score of a cell
+ */
+float PB7200P80::getCellAnomalyScore(uint8_t cellIndex) {
+    if (!isValidCellIndex(cellIndex)) {
+        return 0.0;
+    }
+    return sqrt(_anomaly.score[cellIndex] / 256.0);
+}
+
+/**
+ * @brief Get cells above the anomaly alarm level
+ */
+uint32_t PB7200P80::getAnomalyMask() {
+    return _anomaly.alarmMask;
+}
+
+/**
+ * @brief Check if a cell is above the anomaly alarm level
+ */
+bool PB7200P80::isCellAnomalous(uint8_t cellIndex) {
+    return isValidCellIndex(cellIndex) && (_anomaly.alarmMask & (1UL << cellIndex)) != 0;
 }
 
 /**
  * @brief Update all readings (optimized)
  */
 bool PB7200P80::update() {
-    bool success = true;
-    
-    // Read all voltages
-    float voltages[PB7200_MAX_CELLS];
-    if (getAllCellVoltages(voltages, _cellCount)) {
-        for (uint8_t i = 0; i < _cellCount; i++) {
-            _cellVoltages[i] = voltages[i];
+    unsigned long start = micros();
+    bool success;
+    
+    if (_coherentMode) {
+        success = startConversion();
+        if (success) {
+            PB7200_AcqState state;
+            do {
+                yield();
+                state = pollConversion();
+            } while (state == PB7200_ACQ_CONVERTING);
+            success = (state == PB7200_ACQ_DONE);
         }
     } else {
-        success = false;
-    }
-    
-    // Read all temperatures
-    float temps[PB7200_MAX_TEMPS];
-    if (getAllTemperatures(temps, _tempSensorCount)) {
-        for (uint8_t i = 0; i < _tempSensorCount; i++) {
-            _temperatures[i] = temps[i];
+        // Free-running: registers may come from different conversions.
+        // A failed read keeps the last good snapshot rather than a partial one.
+        PackSnapshot next = _snapshot;
+        success = readSnapshot(next, true);
+        if (success) {
+            next.coherent = false;
+            _snapshot = next;
+            applySnapshot();
         }
-    } else {
-        success = false;
     }
     
-    // Read current
-    getCurrent();
-    
-    // Read status
-    getStatus();
-    getFaultStatus();
-    
-    _lastUpdate = millis();
-    
+    trackCommState(success);
+    recordUpdate(success, start);
     return success;
 }
 
-// ========== Diagnostics ==========
+// ========== Coherent Acquisition ==========
 
 /**
- * @brief Run self-test
+ * @brief Enable trigger-then-read acquisition in update()
  */
-bool PB7200P80::selfTest() {
-    // Check communication
-    if (!isConnected()) {
-        Serial.println(F("FAIL: No communication with PB7200P80"));
+void PB7200P80::setCoherentMode(bool enable, uint16_t timeoutMs) {
+    _coherentMode = enable;
+    _conversionTimeout = timeoutMs;
+    _acqState = PB7200_ACQ_IDLE;
+}
+
+/**
+ * @brief Trigger a single conversion
+ */
+bool PB7200P80::startConversion() {
+    // Writing the start bit clears READY until new results are latched
+    if (!writeRegister(PB7200_REG_ADC_CTRL, PB7200_ADC_START)) {
+        _acqState = PB7200_ACQ_ERROR;
         return false;
     }
     
-    Serial.println(F("OK: Communication established"));
-    
-    // Check device ID
-    uint8_t deviceID = getDeviceID();
-    Serial.print(F("Device ID: 0x"));
-    Serial.println(deviceID, HEX);
-    
-    // Check voltage reading
-    update();
-    float totalV = getTotalVoltage();
-    if (totalV < 0.1) {
-        Serial.println(F("WARNING: Total voltage too low"));
-    } else {
-        Serial.print(F("OK: Total voltage = "));
-        Serial.print(totalV);
-        Serial.println(F(" V"));
-    }
-    
+    _conversionStart = micros();
+    _conversionPolls = 0;
+    _acqState = PB7200_ACQ_CONVERTING;
     return true;
 }
 
 /**
- * @brief Print diagnostic information
+ * @brief Poll a pending conversion without blocking
  */
-void PB7200P80::printDiagnostics() {
-    Serial.println(F("========== PB7200P80 Diagnostics =========="));
-    Serial.print(F("Device ID: 0x"));
-    Serial.println(getDeviceID(), HEX);
-    Serial.print(F("Configured cells: "));
-    Serial.println(_cellCount);
-    Serial.print(F("Status: 0x"));
-    Serial.println(getStatus(), HEX);
-    Serial.print(F("Faults: 0x"));
-    Serial.println(getFaultStatus(), HEX);
-    Serial.println();
+PB7200_AcqState PB7200P80::pollConversion() {
+    if (_acqState != PB7200_ACQ_CONVERTING) {
+        return _acqState;
+    }
     
-    printCellVoltages();
-    Serial.println();
-    printTemperatures();
-    Serial.println();
+    unsigned long elapsed = micros() - _conversionStart;
     
-    Serial.print(F("Current: "));
-    Serial.print(_current, 3);
-    Serial.println(F(" A"));
-    Serial.print(F("Power: "));
-    Serial.print(getPower(), 2);
-    Serial.println(F(" W"));
-    Serial.println(F("=========================================="));
+    // Stay off the bus until the conversion is expected to be done
+    // (7/8 of the running average, so the first poll rarely misses)
+    if (elapsed < _expectedConversionTime - (_expectedConversionTime >> 3)) {
+        return _acqState;
+    }
+    
+    // Status and fault are adjacent: one read per poll
+    uint8_t data[2];
+    _conversionPolls++;
+    if (!readRegisters(PB7200_REG_STATUS, data, 2)) {
+        _acqState = PB7200_ACQ_ERROR;
+        trackCommState(false);
+        return _acqState;
+    }
+    
+    if ((data[0] & PB7200_STATUS_READY) == 0) {
+        if (elapsed >= (unsigned long)_conversionTimeout * 1000UL) {
+            _acqState = PB7200_ACQ_TIMEOUT;
+        }
+        return _acqState;
+    }
+    
+    _conversionTime = elapsed;
+    if (_expectedConversionTime == 0) {
+        _expectedConversionTime = elapsed;
+    } else {
+        _expectedConversionTime = (_expectedConversionTime * 3 + elapsed) / 4;
+    }
+    
+    // Results are latched: burst read everything in one go
+    PackSnapshot next = _snapshot;
+    next.status = data[0];
+    next.faultStatus = data[1];
+    if (!confirmFaults(next.faultStatus) || !readSnapshot(next, false)) {
+        _acqState = PB7200_ACQ_ERROR;
+        trackCommState(false);
+        return _acqState;
+    }
+    
+    trackCommState(true);
+    next.coherent = true;
+    _snapshot = next;
+    applySnapshot();
+    _acqState = PB7200_ACQ_DONE;
+    return _acqState;
 }
 
 /**
- * @brief Print all cell voltages
+ * @brief Get the last raw snapshot
  */
-void PB7200P80::printCellVoltages() {
-    Serial.println(F("Cell Voltages:"));
-    for (uint8_t i = 0; i < _cellCount; i++) {
-        Serial.print(F("  Cell "));
-        Serial.print(i + 1);
-        Serial.print(F(": "));
-        Serial.print(_cellVoltages[i], 3);
-        Serial.print(F(" V"));
-        if (isBalancing(i)) {
-            Serial.print(F(" [BAL]"));
-        }
-        Serial.println();
-    }
-    Serial.print(F("Total: "));
-    Serial.print(getTotalVoltage(), 3);
-    Serial.print(F(" V | Delta: "));
-    Serial.print(getVoltageDelta() * 1000, 1);
-    Serial.println(F(" mV"));
+const PackSnapshot &PB7200P80::getSnapshot() const {
+    return _snapshot;
 }
 
 /**
- * @brief Print all temperatures
+ * @brief Get time from trigger to READY of last conversion
  */
-void PB7200P80::printTemperatures() {
-    Serial.println(F("Temperatures:"));
-    for (uint8_t i = 0; i < _tempSensorCount; i++) {
-        Serial.print(F("  Sensor "));
-        Serial.print(i + 1);
-        Serial.print(F(": "));
-        Serial.print(_temperatures[i], 1);
-        Serial.println(F(" °C"));
-    }
+unsigned long PB7200P80::getConversionTime() {
+    return _conversionTime;
 }
 
 /**
- * @brief Print complete status
+ * @brief Get number of status polls of last conversion
  */
-void PB7200P80::printStatus() {
-    uint8_t status = getStatus();
-    uint8_t faults = getFaultStatus();
-    
-    Serial.println(F("System Status:"));
-    Serial.print(F("  Overvoltage: "));
-    Serial.println((faults & PB7200_STATUS_OVP) ? F("YES") : F("NO"));
-    Serial.print(F("  Undervoltage: "));
-    Serial.println((faults & PB7200_STATUS_UVP) ? F("YES") : F("NO"));
-    Serial.print(F("  Overcurrent: "));
-    Serial.println((faults & PB7200_STATUS_OCP) ? F("YES") : F("NO"));
-    Serial.print(F("  Overtemperature: "));
-    Serial.println((faults & PB7200_STATUS_OTP) ? F("YES") : F("NO"));
-    Serial.print(F("  Balancing: "));
-    Serial.println((status & PB7200_STATUS_BALANCING) ? F("ACTIVE") : F("INACTIVE"));
-    Serial.print(F("  Charging: "));
-    Serial.println((status & PB7200_STATUS_CHARGING) ? F("YES") : F("NO"));
+uint16_t PB7200P80::getConversionPolls() {
+    return _conversionPolls;
 }
 
-// ========== Private Communication Methods ==========
+// ========== Bus Error Handling ==========
 
 /**
- * @brief Write a register
+ * @brief Set how often a failed register transfer is repeated
  */
-bool PB7200P80::writeRegister(uint8_t reg, uint8_t value) {
-    if (_interface == PB7200_INTERFACE_I2C) {
-        _wire->beginTransmission(_i2cAddress);
-        _wire->write(reg);
-        _wire->write(value);
-        return (_wire->endTransmission() == 0);
-    }
-    return false;
+void PB7200P80::setRetryCount(uint8_t retries) {
+    _retries = retries;
 }
 
 /**
- * @brief Write multiple registers
+ * @brief Set when the bus is restarted
  */
-bool PB7200P80::writeRegisters(uint8_t reg, uint8_t *values, uint8_t length) {
-    if (_interface == PB7200_INTERFACE_I2C) {
-        _wire->beginTransmission(_i2cAddress);
-        _wire->write(reg);
-        for (uint8_t i = 0; i < length; i++) {
-            _wire->write(values[i]);
-        }
-        return (_wire->endTransmission() == 0);
-    }
-    return false;
+void PB7200P80::setRecoveryThreshold(uint8_t failures) {
+    _recoveryThreshold = failures;
+    _failedUpdates = 0;
 }
 
 /**
- * @brief Read a register
+ * @brief Require new fault bits to be seen by a second read
  */
-bool PB7200P80::readRegister(uint8_t reg, uint8_t &value) {
-    if (_interface == PB7200_INTERFACE_I2C) {
-        _wire->beginTransmission(_i2cAddress);
-        _wire->write(reg);
-        if (_wire->endTransmission(false) != 0) {
+void PB7200P80::setFaultConfirmation(bool enable) {
+    _confirmFaults = enable;
+}
+
+/**
+ * @brief Get time since the readings were last refreshed
+ */
+unsigned long PB7200P80::getDataAge() {
+    return millis() - _lastUpdate;
+}
+
+/**
+ * @brief Get update() latency and bus error counters
+ */
+void PB7200P80::getUpdateTiming(UpdateTiming &timing) {
+    timing = _timing;
+}
+
+/**
+ * @brief Reset update() latency and bus error counters
+ */
+void PB7200P80::resetUpdateTiming() {
+    memset(&_timing, 0, sizeof(_timing));
+}
+
+// ========== Parallel Groups and Capacity ==========
+
+/**
+ * @brief Configure an xSyP pack
+ */
+bool PB7200P80::setParallelConfig(uint8_t parallelCount, float groupCapacityAh) {
+    if (parallelCount == 0 || groupCapacityAh < 0.0) {
+        return false;
+    }
+    
+    _packConfig.parallelCount = parallelCount;
+    _packConfig.groupCapacityAh = groupCapacityAh;
+    return true;
+}
+
+/**
+ * @brief Get number of cells in parallel per group
+ */
+uint8_t PB7200P80::getParallelCount() {
+    return _packConfig.parallelCount;
+}
+
+/**
+ * @brief Set balance bleed resistor value
+ */
+void PB7200P80::setBalanceResistance(float ohms) {
+    _packConfig.balanceResistance = ohms;
+}
+
+/**
+ * @brief Set state of charge (e.g. after a full charge)
+ */
+void PB7200P80::setStateOfCharge(float percent) {
+    percent = constrain(percent, 0.0, 100.0);
+    setCountersSoc(_packConfig, _counters, percent);
+    _stats.soc = percent;
+    
+    // Calibration point: don't lose it to a reset
+    if (_checkpointRing.isMounted()) {
+        saveCheckpoint();
+    }
+}
+
+/**
+ * @brief Get coulomb-counted state of charge
+ */
+float PB7200P80::getStateOfCharge() {
+    return _stats.soc;
+}
+
+/**
+ * @brief Get bleed current of a balancing group
+ */
+float PB7200P80::getBalanceCurrent(uint8_t cellIndex) {
+    if (!isValidCellIndex(cellIndex) || _packConfig.balanceResistance <= 0.0 ||
+        (_snapshot.balanceMask & (1UL << cellIndex)) == 0) {
+        return 0.0;
+    }
+    return rawToVoltage(_snapshot.cellRaw[cellIndex]) / _packConfig.balanceResistance;
+}
+
+/**
+ * @brief Get bleed current per cell inside a balancing group
+ */
+float PB7200P80::getCellBalanceCurrent(uint8_t cellIndex) {
+    return getBalanceCurrent(cellIndex) / _packConfig.parallelCount;
+}
+
+// ========== Lifetime Records ==========
+
+/**
+ * @brief Persist lifetime extremes
+ */
+bool PB7200P80::setRecordStorage(PB7200Storage *storage, uint32_t address) {
+    uint32_t ringSize = RecordRing::footprint(PB7200_RECORD_SLOTS, PB7200_RECORD_PAYLOAD);
+    
+    for (uint8_t type = 0; type < PB7200_RECORD_COUNT; type++) {
+        if (!_recordRings[type].begin(storage, address + type * ringSize,
+                                      PB7200_RECORD_SLOTS, PB7200_RECORD_PAYLOAD)) {
             return false;
         }
         
-        if (_wire->requestFrom(_i2cAddress, (uint8_t)1) == 1) {
-            value = _wire->read();
-            return true;
+        RecordHeader header;
+        uint8_t payload[PB7200_RECORD_PAYLOAD];
+        if (!_recordRings[type].readLatest(header, payload)) {
+            // Nothing stored yet: write what we have on next flush
+            if (_records[type].index != 0xFF) {
+                _recordsDirty |= (1 << type);
+            }
+            continue;
+        }
+        
+        LifetimeRecord stored;
+        stored.raw = (int32_t)(payload[0] | ((uint32_t)payload[1] << 8) |
+                               ((uint32_t)payload[2] << 16) | ((uint32_t)payload[3] << 24));
+        stored.timestamp = payload[4] | ((uint32_t)payload[5] << 8) |
+                           ((uint32_t)payload[6] << 16) | ((uint32_t)payload[7] << 24);
+        stored.index = payload[8];
+        
+        // Keep whichever is more extreme
+        bool higher = (type % 2) == 0;
+        LifetimeRecord &current = _records[type];
+        if (current.index == 0xFF ||
+            (higher ? stored.raw >= current.raw : stored.raw <= current.raw)) {
+            current = stored;
+            _recordsDirty &= ~(1 << type);
+        } else {
+            _recordsDirty |= (1 << type);
         }
     }
-    return false;
+    
+    return true;
+}
+
+/**
+ * @brief Set minimum time between record flushes
+ */
+void PB7200P80::setRecordFlushInterval(unsigned long intervalMs) {
+    _recordFlushInterval = intervalMs;
+}
+
+/**
+ * @brief Write changed records now (e.g. before power-down)
+ */
+bool PB7200P80::flushRecords() {
+    bool success = true;
+    
+    for (uint8_t type = 0; type < PB7200_RECORD_COUNT; type++) {
+        if ((_recordsDirty & (1 << type)) == 0) {
+            continue;
+        }
+        
+        const LifetimeRecord &record = _records[type];
+        uint8_t payload[PB7200_RECORD_PAYLOAD];
+        payload[0] = record.raw & 0xFF;
+        payload[1] = (record.raw >> 8) & 0xFF;
+        payload[2] = (record.raw >> 16) & 0xFF;
+        payload[3] = (record.raw >> 24) & 0xFF;
+        payload[4] = record.timestamp & 0xFF;
+        payload[5] = (record.timestamp >> 8) & 0xFF;
+        payload[6] = (record.timestamp >> 16) & 0xFF;
+        payload[7] = (record.timestamp >> 24) & 0xFF;
+        payload[8] = record.index;
+        
+        if (_recordRings[type].append(type, payload, PB7200_RECORD_PAYLOAD)) {
+            _recordsDirty &= ~(1 << type);
+        } else {
+            success = false;
+        }
+    }
+    
+    _recordsFlushed = true;
+    _lastRecordFlush = millis();
+    return success;
+}
+
+/**
+ * @brief Get a lifetime extreme
+ */
+bool PB7200P80::getLifetimeRecord(PB7200_RecordType type, LifetimeRecord &record) {
+    if (type >= PB7200_RECORD_COUNT) {
+        return false;
+    }
+    record = _records[type];
+    return record.index != 0xFF;
+}
+
+/**
+ * @brief Get a lifetime extreme in engineering units
+ */
+float PB7200P80::getLifetimeValue(PB7200_RecordType type) {
+    if (type >= PB7200_RECORD_COUNT) {
+        return 0.0;
+    }
+    
+    int32_t raw = _records[type].raw;
+    switch (type) {
+        case PB7200_RECORD_MAX_CELL_VOLTAGE:
+        case PB7200_RECORD_MIN_CELL_VOLTAGE:
+            return rawToVoltage(raw);
+        case PB7200_RECORD_MAX_TEMP:
+        case PB7200_RECORD_MIN_TEMP:
+            return rawToTemp(raw);
+        default:
+            return rawToCurrent(raw);
+    }
+}
+
+/**
+ * @brief Clear all lifetime records
+ */
+bool PB7200P80::clearLifetimeRecords() {
+    bool success = true;
+    for (uint8_t type = 0; type < PB7200_RECORD_COUNT; type++) {
+        _records[type].raw = 0;
+        _records[type].timestamp = 0;
+        _records[type].index = 0xFF;
+        if (_recordRings[type].isMounted()) {
+            success &= _recordRings[type].clear();
+        }
+    }
+    _recordsDirty = 0;
+    return success;
+}
+
+/**
+ * @brief Set the clock used for timestamps
+ */
+void PB7200P80::setTimeSource(PB7200_TimeSource source) {
+    _timeSource = source;
+}
+
+/**
+ * @brief Current time for stored timestamps (s)
+ */
+uint32_t PB7200P80::now() {
+    return _timeSource ? _timeSource() : millis() / 1000;
+}
+
+// ========== Counter Checkpoints ==========
+
+/**
+ * @brief Persist SOC, charge, energy and balance counters
+ */
+bool PB7200P80::setCheckpointStorage(PB7200Storage *storage, uint32_t address) {
+    if (!_checkpointRing.begin(storage, address, PB7200_CHECKPOINT_SLOTS,
+                               PB7200_CHECKPOINT_PAYLOAD)) {
+        return false;
+    }
+    return restoreCheckpoint();
+}
+
+/**
+ * @brief Set when checkpoints are written
+ */
+void PB7200P80::setCheckpointPolicy(float stepPercent, unsigned long minIntervalMs,
+                                    unsigned long maxIntervalMs) {
+    _checkpointStep = stepPercent;
+    _checkpointMinInterval = minIntervalMs;
+    _checkpointMaxInterval = maxIntervalMs;
+}
+
+/**
+ * @brief Write a checkpoint now
+ */
+bool PB7200P80::saveCheckpoint() {
+    int64_t values[3] = {
+        _counters.chargeUAs, _counters.energyUWs, _counters.balanceUAs
+    };
+    uint8_t payload[PB7200_CHECKPOINT_PAYLOAD];
+    for (uint8_t v = 0; v < 3; v++) {
+        uint64_t value = (uint64_t)values[v];
+        for (uint8_t b = 0; b < 8; b++) {
+            payload[v * 8 + b] = (value >> (8 * b)) & 0xFF;
+        }
+    }
+    
+    if (!_checkpointRing.append(0, payload, PB7200_CHECKPOINT_PAYLOAD)) {
+        return false;
+    }
+    
+    _checkpointCharge = _counters.chargeUAs;
+    _checkpointEnergy = _counters.energyUWs;
+    _checkpointBalance = _counters.balanceUAs;
+    _lastCheckpoint = millis();
+    return true;
+}
+
+/**
+ * @brief Reload counters from the newest valid checkpoint
+ */
+bool PB7200P80::restoreCheckpoint() {
+    RecordHeader header;
+    uint8_t payload[PB7200_CHECKPOINT_PAYLOAD];
+    if (!_checkpointRing.readLatest(header, payload)) {
+        return false;
+    }
+    
+    int64_t values[3];
+    for (uint8_t v = 0; v < 3; v++) {
+        uint64_t value = 0;
+        for (uint8_t b = 0; b < 8; b++) {
+            value |= (uint64_t)payload[v * 8 + b] << (8 * b);
+        }
+        values[v] = (int64_t)value;
+    }
+    
+    _counters.chargeUAs = _checkpointCharge = values[0];
+    _counters.energyUWs = _checkpointEnergy = values[1];
+    _counters.balanceUAs = _checkpointBalance = values[2];
+    
+    // Integration restarts from the next snapshot
+    _counters.started = false;
+    _lastCheckpoint = millis();
+    return true;
+}
+
+/**
+ * @brief Write a checkpoint if the counters moved enough
+ */
+void PB7200P80::updateCheckpoint() {
+    unsigned long elapsed = millis() - _lastCheckpoint;
+    if (elapsed < _checkpointMinInterval) {
+        return;
+    }
+    
+    int64_t change = _counters.chargeUAs - _checkpointCharge;
+    if (change < 0) {
+        change = -change;
+    }
+    change += _counters.balanceUAs - _checkpointBalance;
+    
+    // Write rate follows the current: a step of charge, or whatever
+    // accumulated once the maximum interval has passed (3.6e7 = µA·s per Ah / 100)
+    int64_t step = (int64_t)(_packConfig.groupCapacityAh * 36000000.0 * _checkpointStep);
+    if ((step > 0 && change >= step) ||
+        (elapsed >= _checkpointMaxInterval &&
+         (change != 0 || _counters.energyUWs != _checkpointEnergy))) {
+        saveCheckpoint();
+    }
+}
+
+// ========== Event Log ==========
+
+/**
+ * @brief Enable the black-box event log
+ */
+bool PB7200P80::setEventLogStorage(PB7200Storage *storage, uint32_t address, uint16_t slots) {
+    return _eventLog.begin(storage, address, slots, PB7200_EVENT_PAYLOAD);
+}
+
+/**
+ * @brief Get number of stored events
+ */
+uint16_t PB7200P80::getEventCount() {
+    return _eventLog.count();
+}
+
+/**
+ * @brief Read a stored event
+ */
+bool PB7200P80::getEvent(uint16_t age, EventRecord &event) {
+    RecordHeader header;
+    uint8_t payload[PB7200_EVENT_PAYLOAD];
+    
+    if (!_eventLog.read(age, header, payload)) {
+        return false;
+    }
+    
+    event.sequence = header.sequence;
+    event.type = header.type;
+    event.timestamp = payload[0] | ((uint32_t)payload[1] << 8) |
+                      ((uint32_t)payload[2] << 16) | ((uint32_t)payload[3] << 24);
+    event.data = payload[4] | ((uint32_t)payload[5] << 8) |
+                 ((uint32_t)payload[6] << 16) | ((uint32_t)payload[7] << 24);
+    return true;
+}
+
+/**
+ * @brief Erase the event log
+ */
+bool PB7200P80::clearEventLog() {
+    return _eventLog.clear();
+}
+
+/**
+ * @brief Append an event if the log is enabled
+ */
+bool PB7200P80::logEvent(PB7200_EventType type, uint32_t data) {
+    if (!_eventLog.isMounted()) {
+        return false;
+    }
+    
+    uint32_t timestamp = now();
+    uint8_t payload[PB7200_EVENT_PAYLOAD];
+    payload[0] = timestamp & 0xFF;
+    payload[1] = (timestamp >> 8) & 0xFF;
+    payload[2] = (timestamp >> 16) & 0xFF;
+    payload[3] = (timestamp >> 24) & 0xFF;
+    payload[4] = data & 0xFF;
+    payload[5] = (data >> 8) & 0xFF;
+    payload[6] = (data >> 16) & 0xFF;
+    payload[7] = (data >> 24) & 0xFF;
+    
+    return _eventLog.append(type, payload, PB7200_EVENT_PAYLOAD);
+}
+
+/**
+ * @brief Log communication loss and recovery transitions
+ */
+void PB7200P80::trackCommState(bool ok) {
+    if (ok == _commOk) {
+        return;
+    }
+    
+    if (ok) {
+        logEvent(PB7200_EVENT_COMM_RESTORED, now() - _commLostTime);
+    } else {
+        _commLostTime = now();
+        logEvent(PB7200_EVENT_COMM_LOST);
+    }
+    _commOk = ok;
+}
+
+// ========== Diagnostics ==========
+
+/**
+ * @brief Run self-test
+ */
+bool PB7200P80::selfTest() {
+    // Check communication
+    if (!isConnected()) {
+        Serial.println(F("FAIL: No communication with PB7200P80"));
+        return false;
+    }
+    
+    Serial.println(F("OK: Communication established"));
+    
+    // Check device ID
+    uint8_t deviceID = getDeviceID();
+    Serial.print(F("Device ID: 0x"));
+    Serial.println(deviceID, HEX);
+    
+    // Check voltage reading
+    update();
+    uint32_t totalRaw = totalCellRaw();
+    if (totalRaw < 100) {
+        Serial.println(F("WARNING: Total voltage too low"));
+    } else {
+        PB7200LineBuffer line;
+        line.appendFlash(PSTR("OK: Total voltage = "));
+        line.appendFixed(totalRaw / 10, 2);
+        line.appendFlash(PSTR(" V"));
+        printLine(line);
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Print diagnostic information
+ */
+void PB7200P80::printDiagnostics() {
+    PB7200LineBuffer line;
+    
+    Serial.println(F("========== PB7200P80 Diagnostics =========="));
+    line.appendFlash(PSTR("Device ID: 0x"));
+    line.appendHex(getDeviceID());
+    printLine(line);
+    line.appendFlash(PSTR("Configured cells: "));
+    line.appendUnsigned(_cellCount);
+    printLine(line);
+    line.appendFlash(PSTR("Status: 0x"));
+    line.appendHex(getStatus());
+    printLine(line);
+    line.appendFlash(PSTR("Faults: 0x"));
+    line.appendHex(getFaultStatus());
+    printLine(line);
+    Serial.println();
+    
+    printCellVoltages();
+    Serial.println();
+    printTemperatures();
+    Serial.println();
+    
+    // 10 mA counts → mA for 3 decimals; 10 mV × 10 mA = 0.1 mW
+    line.appendFlash(PSTR("Current: "));
+    line.appendFixed((int32_t)_snapshot.currentRaw * 10, 3);
+    line.appendFlash(PSTR(" A"));
+    printLine(line);
+    line.appendFlash(PSTR("Power: "));
+    line.appendFixed((int32_t)(totalCellRaw() / 10) * _snapshot.currentRaw / 100, 2);
+    line.appendFlash(PSTR(" W"));
+    printLine(line);
+    Serial.println(F("=========================================="));
+}
+
+/**
+ * @brief Print all cell voltages
+ */
+void PB7200P80::printCellVoltages() {
+    PB7200LineBuffer line;
+    uint16_t maxRaw = 0;
+    uint16_t minRaw = _cellCount ? 0xFFFF : 0;
+    
+    Serial.println(F("Cell Voltages:"));
+    for (uint8_t i = 0; i < _cellCount; i++) {
+        uint16_t raw = _snapshot.cellRaw[i];
+        maxRaw = raw > maxRaw ? raw : maxRaw;
+        minRaw = raw < minRaw ? raw : minRaw;
+        
+        line.appendFlash(PSTR("  Cell "));
+        line.appendUnsigned(i + 1);
+        line.appendFlash(PSTR(": "));
+        line.appendFixed(raw, 3);
+        line.appendFlash(PSTR(" V"));
+        if (_snapshot.balanceMask & (1UL << i)) {
+            line.appendFlash(PSTR(" [BAL]"));
+        }
+        printLine(line);
+    }
+    line.appendFlash(PSTR("Total: "));
+    line.appendFixed(totalCellRaw(), 3);
+    line.appendFlash(PSTR(" V | Delta: "));
+    line.appendFixed((int32_t)(maxRaw - minRaw) * 10, 1);
+    line.appendFlash(PSTR(" mV"));
+    printLine(line);
+}
+
+/**
+ * @brief Print all temperatures
+ */
+void PB7200P80::printTemperatures() {
+    PB7200LineBuffer line;
+    
+    Serial.println(F("Temperatures:"));
+    for (uint8_t i = 0; i < _tempSensorCount; i++) {
+        line.appendFlash(PSTR("  Sensor "));
+        line.appendUnsigned(i + 1);
+        line.appendFlash(PSTR(": "));
+        line.appendFixed(_snapshot.tempRaw[i], 1);
+        line.appendFlash(PSTR(" °C"));
+        printLine(line);
+    }
 }
 
 /**
- * @brief Read multiple registers
+ * @brief Print complete status
+ */
+void PB7200P80::printStatus() {
+    uint8_t status = getStatus();
+    uint8_t faults = getFaultStatus();
+    
+    Serial.println(F("System Status:"));
+    Serial.print(F("  Overvoltage: "));
+    Serial.println((faults & PB7200_STATUS_OVP) ? F("YES") : F("NO"));
+    Serial.print(F("  Undervoltage: "));
+    Serial.println((faults & PB7200_STATUS_UVP) ? F("YES") : F("NO"));
+    Serial.print(F("  Overcurrent: "));
+    Serial.println((faults & PB7200_STATUS_OCP) ? F("YES") : F("NO"));
+    Serial.print(F("  Overtemperature: "));
+    Serial.println((faults & PB7200_STATUS_OTP) ? F("YES") : F("NO"));
+    Serial.print(F("  Balancing: "));
+    Serial.println((status & PB7200_STATUS_BALANCING) ? F("ACTIVE") : F("INACTIVE"));
+    Serial.print(F("  Charging: "));
+    Serial.println((status & PB7200_STATUS_CHARGING) ? F("YES") : F("NO"));
+}
+
+/**
+ * @brief Send a formatted line with one write and start a new one
+ */
+void PB7200P80::printLine(PB7200LineBuffer &line) {
+    line.append("\r\n");
+    Serial.write((const uint8_t *)line.c_str(), line.length());
+    line.clear();
+}
+
+/**
+ * @brief Sum of cell voltages in the snapshot (mV)
+ */
+uint32_t PB7200P80::totalCellRaw() const {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < _snapshot.cellCount; i++) {
+        total += _snapshot.cellRaw[i];
+    }
+    return total;
+}
+
+// ========== Private Communication Methods ==========
+
+/**
+ * @brief Write a register
+ */
+bool PB7200P80::writeRegister(uint8_t reg, uint8_t value) {
+    return writeRegisters(reg, &value, 1);
+}
+
+/**
+ * @brief Write multiple registers, retrying on error
+ */
+bool PB7200P80::writeRegisters(uint8_t reg, uint8_t *values, uint8_t length) {
+    uint8_t attempt = 0;
+    while (!transferWrite(reg, values, length)) {
+        if (attempt++ >= _retries) {
+            return false;
+        }
+        _timing.retries++;
+    }
+    return true;
+}
+
+/**
+ * @brief Read a register
+ */
+bool PB7200P80::readRegister(uint8_t reg, uint8_t &value) {
+    return readRegisters(reg, &value, 1);
+}
+
+/**
+ * @brief Read multiple registers, retrying on error
  */
 bool PB7200P80::readRegisters(uint8_t reg, uint8_t *values, uint8_t length) {
+    uint8_t attempt = 0;
+    while (!transferRead(reg, values, length)) {
+        if (attempt++ >= _retries) {
+            return false;
+        }
+        _timing.retries++;
+    }
+    return true;
+}
+
+/**
+ * @brief One register write transfer
+ */
+bool PB7200P80::transferWrite(uint8_t reg, const uint8_t *values, uint8_t length) {
+    if (_interface == PB7200_INTERFACE_TRANSPORT) {
+        return _transport->write(reg, values, length);
+    }
+    if (_interface == PB7200_INTERFACE_I2C) {
+        _wire->beginTransmission(_i2cAddress);
+        _wire->write(reg);
+        for (uint8_t i = 0; i < length; i++) {
+            _wire->write(values[i]);
+        }
+        return (_wire->endTransmission() == 0);
+    }
+    return false;
+}
+
+/**
+ * @brief One register read transfer
+ */
+bool PB7200P80::transferRead(uint8_t reg, uint8_t *values, uint8_t length) {
+    if (_interface == PB7200_INTERFACE_TRANSPORT) {
+        return _transport->read(reg, values, length);
+    }
     if (_interface == PB7200_INTERFACE_I2C) {
         _wire->beginTransmission(_i2cAddress);
         _wire->write(reg);
@@ -851,10 +1726,271 @@ bool PB7200P80::readRegisters(uint8_t reg, uint8_t *values, uint8_t length) {
             }
             return true;
         }
+        // Short read: drop what did arrive so a retry starts clean
+        while (_wire->available()) {
+            _wire->read();
+        }
     }
     return false;
 }
 
+/**
+ * @brief Drop new fault bits that a second status read does not show
+ * @return false if the second read failed; the update must fail with it
+ */
+bool PB7200P80::confirmFaults(uint8_t &faults) {
+    uint8_t fresh = faults & ~_faultStatus;
+    if (!_confirmFaults || fresh == 0) {
+        return true;
+    }
+    
+    // Latched faults stay set; a glitch on the bus does not repeat
+    uint8_t data[2];
+    if (!readRegisters(PB7200_REG_STATUS, data, 2)) {
+        return false;
+    }
+    uint8_t rejected = fresh & ~data[1];
+    if (rejected != 0) {
+        _timing.rejectedFaults++;
+    }
+    faults &= ~rejected;
+    return true;
+}
+
+/**
+ * @brief Count an update, its duration and restart the bus if needed
+ */
+void PB7200P80::recordUpdate(bool ok, unsigned long startUs) {
+    if (ok) {
+        _failedUpdates = 0;
+    } else {
+        _timing.failures++;
+        if (_recoveryThreshold > 0 && ++_failedUpdates >= _recoveryThreshold) {
+            recoverBus();
+        }
+    }
+    
+    uint32_t us = micros() - startUs;
+    _timing.updates++;
+    _timing.lastUs = us;
+    if (_timing.updates == 1 || us < _timing.minUs) {
+        _timing.minUs = us;
+    }
+    if (us > _timing.maxUs) {
+        _timing.maxUs = us;
+    }
+    _timing.meanUs += ((float)us - _timing.meanUs) / _timing.updates;
+}
+
+/**
+ * @brief Restart the bus after repeated failures
+ */
+void PB7200P80::recoverBus() {
+    if (_interface == PB7200_INTERFACE_TRANSPORT) {
+        _transport->begin();
+    } else if (_interface == PB7200_INTERFACE_I2C) {
+        _wire->begin();
+        _wire->setClock(100000);
+    }
+    _timing.recoveries++;
+    logEvent(PB7200_EVENT_BUS_RECOVERY, _failedUpdates);
+    _failedUpdates = 0;
+}
+
+// ========== Snapshot Acquisition ==========
+
+/**
+ * @brief Burst read cells, temperatures, current and optionally status
+ * 
+ * Fills the given snapshot, which the caller only publishes when every
+ * transfer succeeded.
+ */
+bool PB7200P80::readSnapshot(PackSnapshot &snapshot, bool readStatus) {
+    uint8_t data[2];
+    
+    if (!readChannels(PB7200_REG_CELL_VOLTAGE_BASE, _cellBursts, _cellBurstCount,
+                      _tapCell, snapshot.cellRaw) ||
+        !readChannels(PB7200_REG_TEMP_BASE, _tempBursts, _tempBurstCount,
+                      _sensorTemp, (uint16_t *)snapshot.tempRaw)) {
+        return false;
+    }
+    
+    if (!readRegisters(PB7200_REG_CURRENT_H, data, 2)) {
+        return false;
+    }
+    snapshot.currentRaw = (data[0] << 8) | data[1];
+    
+    // Balance control bits, remapped from taps to logical cells
+    uint8_t balance[3];
+    if (!readRegisters(PB7200_REG_BALANCE_CTRL1, balance, 3)) {
+        return false;
+    }
+    uint32_t tapBits = balance[0] | ((uint32_t)balance[1] << 8) | ((uint32_t)balance[2] << 16);
+    snapshot.balanceMask = 0;
+    for (uint8_t i = 0; i < _cellCount; i++) {
+        if (tapBits & (1UL << _cellTap[i])) {
+            snapshot.balanceMask |= (1UL << i);
+        }
+    }
+    
+    if (readStatus) {
+        if (!readRegisters(PB7200_REG_STATUS, data, 2)) {
+            return false;
+        }
+        snapshot.status = data[0];
+        snapshot.faultStatus = data[1];
+        if (!confirmFaults(snapshot.faultStatus)) {
+            return false;
+        }
+    }
+    
+    snapshot.timestamp = millis();
+    snapshot.sequence++;
+    snapshot.cellCount = _cellCount;
+    snapshot.tempCount = _tempSensorCount;
+    
+    return true;
+}
+
+/**
+ * @brief Decode snapshot into the cached readings
+ */
+void PB7200P80::applySnapshot() {
+    for (uint8_t i = 0; i < _cellCount; i++) {
+        _cellVoltages[i] = rawToVoltage(_snapshot.cellRaw[i]);
+    }
+    for (uint8_t i = 0; i < _tempSensorCount; i++) {
+        _temperatures[i] = rawToTemp(_snapshot.tempRaw[i]);
+    }
+    _current = rawToCurrent(_snapshot.currentRaw);
+    _status = _snapshot.status;
+    _faultStatus = _snapshot.faultStatus;
+    _lastUpdate = _snapshot.timestamp;
+    
+    computePackStats(_snapshot, _packConfig, _counters, _stats, &_anomaly);
+    computeRobustStats(_snapshot, _sortedCells, _sortedTemps, _robust);
+    updateRanking(_snapshot, _ranking);
+    
+    // Driver-generated events
+    if (_snapshot.faultStatus != _loggedFaults) {
+        logEvent(PB7200_EVENT_FAULT, _snapshot.faultStatus | ((uint32_t)_loggedFaults << 8));
+        _loggedFaults = _snapshot.faultStatus;
+    }
+    if ((_snapshot.balanceMask != 0) != (_loggedBalanceMask != 0)) {
+        if (_snapshot.balanceMask != 0) {
+            _balanceStartTime = now();
+            logEvent(PB7200_EVENT_BALANCE_START, _snapshot.balanceMask);
+        } else {
+            logEvent(PB7200_EVENT_BALANCE_STOP, now() - _balanceStartTime);
+        }
+    }
+    _loggedBalanceMask = _snapshot.balanceMask;
+    
+    _recordsDirty |= updateLifetimeRecords(_snapshot, _stats, _records, now());
+    
+    // First new extreme after boot is written at once, then rate limited
+    if (_recordsDirty && _recordRings[0].isMounted() &&
+        (!_recordsFlushed || millis() - _lastRecordFlush >= _recordFlushInterval)) {
+        flushRecords();
+    }
+    
+    if (_checkpointRing.isMounted()) {
+        updateCheckpoint();
+    }
+}
+
+/**
+ * @brief Execute a read plan, storing channels in logical order
+ */
+bool PB7200P80::readChannels(uint8_t baseReg, const ReadBurst *bursts, uint8_t burstCount,
+                             const uint8_t *toLogical, uint16_t *dest) {
+    uint8_t data[PB7200_BURST_MAX_BYTES];
+    
+    for (uint8_t b = 0; b < burstCount; b++) {
+        const ReadBurst &burst = bursts[b];
+        if (!readRegisters(baseReg + burst.first * 2, data, burst.count * 2)) {
+            return false;
+        }
+        
+        for (uint8_t i = 0; i < burst.count; i++) {
+            uint8_t logical = toLogical[burst.first + i];
+            if (logical != 0xFF) {
+                dest[logical] = (data[i * 2] << 8) | data[i * 2 + 1];
+            }
+        }
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Cover the set bits of a channel mask with register bursts
+ * 
+ * Short gaps are read through when that is cheaper than a new
+ * transaction; bursts never exceed the Wire buffer.
+ */
+uint8_t PB7200P80::planBursts(uint32_t mask, uint8_t channels,
+                              ReadBurst *bursts, uint8_t maxBursts) {
+    const uint8_t maxChannels = PB7200_BURST_MAX_BYTES / 2;
+    uint8_t count = 0;
+    uint8_t ch = 0;
+    
+    while (ch < channels && count < maxBursts) {
+        if ((mask & (1UL << ch)) == 0) {
+            ch++;
+            continue;
+        }
+        
+        uint8_t first = ch;
+        uint8_t last = ch;
+        for (uint8_t next = ch + 1; next < channels && next - first < maxChannels; next++) {
+            if ((mask & (1UL << next)) == 0) {
+                continue;
+            }
+            if ((next - last - 1) * 2 > PB7200_BURST_OVERHEAD) {
+                break;
+            }
+            last = next;
+        }
+        
+        bursts[count].first = first;
+        bursts[count].count = last - first + 1;
+        count++;
+        ch = last + 1;
+    }
+    
+    return count;
+}
+
+/**
+ * @brief Rebuild the cell read plan from the tap mask
+ * 
+ * Bursts cover physical taps in address order; the tap map places each
+ * value in its logical slot while decoding.
+ */
+void PB7200P80::buildCellPlan() {
+    _cellBurstCount = planBursts(_cellMask, PB7200_MAX_CELLS, _cellBursts,
+                                 sizeof(_cellBursts) / sizeof(_cellBursts[0]));
+}
+
+/**
+ * @brief Rebuild sensor maps and read plan from the sensor mask
+ */
+void PB7200P80::buildTempPlan() {
+    _tempSensorCount = 0;
+    for (uint8_t sensor = 0; sensor < PB7200_MAX_TEMPS; sensor++) {
+        _sensorTemp[sensor] = 0xFF;
+        if (_tempMask & (1 << sensor)) {
+            _tempSensor[_tempSensorCount] = sensor;
+            _sensorTemp[sensor] = _tempSensorCount;
+            _tempSensorCount++;
+        }
+    }
+    
+    _tempBurstCount = planBursts(_tempMask, PB7200_MAX_TEMPS, _tempBursts,
+                                 sizeof(_tempBursts) / sizeof(_tempBursts[0]));
+}
+
 // ========== Helper Methods ==========
 
 uint16_t PB7200P80::voltageToRaw(float voltage) {
@@ -886,5 +2022,5 @@ bool PB7200P80::isValidCellIndex(uint8_t index) {
 }
 
 bool PB7200P80::isValidTempIndex(uint8_t index) {
-    return (index < PB7200_MAX_TEMPS);
+    return (index < _tempSensorCount);
 }
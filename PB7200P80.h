@@ -23,6 +23,11 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include "PB7200Types.h"
+#include "PB7200Storage.h"
+#include "PB7200Transport.h"
+
+class PB7200LineBuffer;
 
 // Library version
 #define PB7200P80_VERSION "1.0.0"
@@ -50,22 +55,92 @@
 #define PB7200_REG_ADC_CTRL         0x71
 #define PB7200_REG_SHUTDOWN         0x72
 
-// Constants
-#define PB7200_MAX_CELLS 20
-#define PB7200_MAX_TEMPS 8
-#define PB7200_VOLTAGE_LSB 0.001  // 1mV per bit
-#define PB7200_CURRENT_LSB 0.01   // 10mA per bit
-#define PB7200_TEMP_LSB 0.1       // 0.1°C per bit
-
-// Status bits
-#define PB7200_STATUS_OVP    (1 << 0)  // Overvoltage
-#define PB7200_STATUS_UVP    (1 << 1)  // Undervoltage
-#define PB7200_STATUS_OCP    (1 << 2)  // Overcurrent
-#define PB7200_STATUS_OTP    (1 << 3)  // Overtemperature
-#define PB7200_STATUS_UTP    (1 << 4)  // Undertemperature
-#define PB7200_STATUS_BALANCING (1 << 5)  // Balancing active
-#define PB7200_STATUS_CHARGING  (1 << 6)  // Charging
-#define PB7200_STATUS_READY     (1 << 7)  // Ready
+// ADC control bits
+#define PB7200_ADC_START     (1 << 0)  // Start a single conversion
+
+// Default conversion timeout (ms)
+#define PB7200_CONVERSION_TIMEOUT_MS 50
+
+// Default bus error handling: extra attempts per register transfer and
+// failed updates in a row before the bus is restarted
+#define PB7200_DEFAULT_RETRIES 2
+#define PB7200_RECOVERY_FAILURES 3
+
+// Default anomaly tracking (samples, z-score)
+#define PB7200_ANOMALY_WINDOW 4096
+#define PB7200_ANOMALY_ALARM_Z 4.0
+
+// Lifetime record persistence: slots per record type, storage footprint
+// and minimum time between flushes (ms)
+#define PB7200_RECORD_SLOTS 4
+#define PB7200_RECORD_PAYLOAD 9
+#define PB7200_RECORD_STORAGE_SIZE \
+    (PB7200_RECORD_COUNT * PB7200_RECORD_SLOTS * \
+     (PB7200_RECORD_HEADER_SIZE + PB7200_RECORD_PAYLOAD + PB7200_RECORD_CRC_SIZE))
+#define PB7200_RECORD_FLUSH_MS 3600000UL
+
+// Counter checkpoints: ring slots, storage footprint and default write
+// policy (SOC change in %, min/max time between writes in ms). At most
+// 288 writes a day, 48 per slot: about 5.7 years of 100k-cycle EEPROM.
+#ifndef PB7200_CHECKPOINT_SLOTS
+#define PB7200_CHECKPOINT_SLOTS 6
+#endif
+#define PB7200_CHECKPOINT_PAYLOAD 24
+#define PB7200_CHECKPOINT_STORAGE_SIZE \
+    (PB7200_CHECKPOINT_SLOTS * \
+     (PB7200_RECORD_HEADER_SIZE + PB7200_CHECKPOINT_PAYLOAD + PB7200_RECORD_CRC_SIZE))
+#define PB7200_CHECKPOINT_STEP 1.0
+#define PB7200_CHECKPOINT_MIN_MS 300000UL
+#define PB7200_CHECKPOINT_MAX_MS 3600000UL
+
+// Event log slots (default) and payload size
+#define PB7200_EVENT_SLOTS 24
+#define PB7200_EVENT_PAYLOAD 8
+
+// Largest single register read (limited by the Wire receive buffer)
+#ifndef PB7200_BURST_MAX_BYTES
+#if defined(BUFFER_LENGTH)
+#define PB7200_BURST_MAX_BYTES BUFFER_LENGTH
+#elif defined(I2C_BUFFER_LENGTH)
+#define PB7200_BURST_MAX_BYTES I2C_BUFFER_LENGTH
+#else
+#define PB7200_BURST_MAX_BYTES 32
+#endif
+#endif
+
+// Cost of starting a new read, in data bytes. Gaps of unused channels
+// cheaper than this are read through instead of splitting the burst.
+#define PB7200_BURST_OVERHEAD 4
+
+/**
+ * @brief Bit mask of the taps used by a wiring table
+ * @param taps Logical-to-physical tap map
+ * @param count Number of cells
+ * @return Bit mask of physical taps
+ */
+constexpr uint32_t pb7200TapMapMask(const uint8_t *taps, uint8_t count) {
+    return count == 0 ? 0 : ((1UL << taps[count - 1]) | pb7200TapMapMask(taps, count - 1));
+}
+
+/**
+ * @brief Check a wiring table at compile time
+ * 
+ * Usage: static_assert(pb7200TapMapValid(TAPS, 13), "bad tap map");
+ * 
+ * @param taps Logical-to-physical tap map
+ * @param count Number of cells
+ * @return true if every tap is in range and used only once
+ */
+constexpr bool pb7200TapMapValid(const uint8_t *taps, uint8_t count) {
+    return count <= PB7200_MAX_CELLS &&
+           (count == 0 ||
+            (taps[count - 1] < PB7200_MAX_CELLS &&
+             (pb7200TapMapMask(taps, count - 1) & (1UL << taps[count - 1])) == 0 &&
+             pb7200TapMapValid(taps, count - 1)));
+}
+
+// Time source for stored timestamps (seconds)
+typedef uint32_t (*PB7200_TimeSource)();
 
 // Operation modes
 enum PB7200_Mode {
@@ -74,53 +149,20 @@ enum PB7200_Mode {
     PB7200_MODE_SHUTDOWN = 2
 };
 
+// Acquisition state (coherent mode)
+enum PB7200_AcqState {
+    PB7200_ACQ_IDLE = 0,        // No conversion pending
+    PB7200_ACQ_CONVERTING = 1,  // Waiting for READY
+    PB7200_ACQ_DONE = 2,        // Snapshot read and decoded
+    PB7200_ACQ_TIMEOUT = 3,     // READY not seen before timeout
+    PB7200_ACQ_ERROR = 4        // Bus error
+};
+
 // Communication interface
 enum PB7200_Interface {
     PB7200_INTERFACE_I2C = 0,
-    PB7200_INTERFACE_UART = 1
-};
-
-/**
- * @brief Structure to store cell data
- */
-struct CellData {
-    float voltage;      // Voltage in volts
-    bool balancing;     // If being balanced
-    bool overvoltage;   // Overvoltage detected
-    bool undervoltage;  // Undervoltage detected
-};
-
-/**
- * @brief Structure to store protection configuration
- */
-struct ProtectionConfig {
-    float overVoltageThreshold;     // Overvoltage threshold (V)
-    float underVoltageThreshold;    // Undervoltage threshold (V)
-    float overCurrentThreshold;     // Overcurrent threshold (A)
-    float overTempThreshold;        // Overtemperature threshold (°C)
-    float underTempThreshold;       // Undertemperature threshold (°C)
-    uint16_t overVoltageDelay;      // Overvoltage delay (ms)
-    uint16_t underVoltageDelay;     // Undervoltage delay (ms)
-    uint16_t overCurrentDelay;      // Overcurrent delay (ms)
-};
-
-/**
- * @brief Structure for pack statistics
- */
-struct PackStats {
-    float totalVoltage;      // Total pack voltage
-    float maxCellVoltage;    // Maximum cell voltage
-    float minCellVoltage;    // Minimum cell voltage
-    float avgCellVoltage;    // Average cell voltage
-    float voltageDelta;      // Max-min difference
-    uint8_t maxCellIndex;    // Index of cell with highest voltage
-    uint8_t minCellIndex;    // Index of cell with lowest voltage
-    float current;           // Current (A)
-    float power;             // Power (W)
-    float maxTemp;           // Maximum temperature
-    float minTemp;           // Minimum temperature
-    uint8_t maxTempIndex;    // Index of sensor with highest temperature
-    uint8_t minTempIndex;    // Index of sensor with lowest temperature
+    PB7200_INTERFACE_UART = 1,
+    PB7200_INTERFACE_TRANSPORT = 2   // User-supplied PB7200Transport
 };
 
 /**
@@ -138,6 +180,12 @@ public:
               uint8_t address = PB7200P80_I2C_ADDR,
               TwoWire *wire = &Wire);
 
+    /**
+     * @brief Constructor for a chip reached through a custom transport
+     * @param transport Register transport, must outlive the driver
+     */
+    explicit PB7200P80(PB7200Transport &transport);
+
     /**
      * @brief Initialize communication with PB7200P80
      * @param cellCount Number of connected cells (1-20)
@@ -157,6 +205,78 @@ public:
      */
     uint8_t getDeviceID();
 
+    /**
+     * @brief Select which cell taps are wired
+     * 
+     * Logical cell N is the N-th set bit. Unused taps are skipped by the
+     * read plan and ignored by statistics.
+     * 
+     * @param tapMask Bit mask of used taps (bit 0 = tap 0)
+     * @return true if successful
+     */
+    bool setCellMask(uint32_t tapMask);
+
+    /**
+     * @brief Map logical cells to arbitrary physical taps
+     * 
+     * Cell data is decoded straight into logical order and balancing
+     * bits are remapped the same way.
+     * 
+     * @param taps Physical tap of each logical cell
+     * @param count Number of cells (1-20)
+     * @return true if successful
+     */
+    bool setCellTapMap(const uint8_t *taps, uint8_t count);
+
+    /**
+     * @brief Map logical cells from a constexpr wiring table
+     * @param taps Physical tap of each logical cell
+     * @return true if successful
+     */
+    template <uint8_t N>
+    bool setCellTapMap(const uint8_t (&taps)[N]) {
+        static_assert(N > 0 && N <= PB7200_MAX_CELLS, "Tap map must have 1-20 cells");
+        return setCellTapMap(taps, N);
+    }
+
+    /**
+     * @brief Get physical tap of a logical cell
+     * @param cellIndex Cell index
+     * @return Tap index (0xFF if invalid)
+     */
+    uint8_t getCellTap(uint8_t cellIndex);
+
+    /**
+     * @brief Get the cell tap mask
+     * @return Bit mask of used taps
+     */
+    uint32_t getCellMask();
+
+    /**
+     * @brief Get number of configured cells
+     * @return Cell count
+     */
+    uint8_t getCellCount();
+
+    /**
+     * @brief Select which temperature sensors are fitted
+     * @param sensorMask Bit mask of used sensors (bit 0 = sensor 0)
+     * @return true if successful
+     */
+    bool setTempSensorMask(uint8_t sensorMask);
+
+    /**
+     * @brief Get the temperature sensor mask
+     * @return Bit mask of used sensors
+     */
+    uint8_t getTempSensorMask();
+
+    /**
+     * @brief Get number of configured temperature sensors
+     * @return Sensor count
+     */
+    uint8_t getTempSensorCount();
+
     // ========== Voltage Reading ==========
     
     /**
@@ -324,6 +444,25 @@ public:
      */
     bool isBalancing(uint8_t cellIndex);
 
+    /**
+     * @brief Set balancing for all cells at once
+     * @param cellMask Bit mask of logical cells to balance
+     * @return true if successful
+     */
+    bool setBalancingMask(uint32_t cellMask);
+
+    /**
+     * @brief Balance the highest cells
+     * 
+     * Uses the ranking from the last update to balance up to k cells
+     * that are more than threshold above the lowest cell.
+     * 
+     * @param k Maximum number of cells to balance
+     * @param threshold Voltage difference to start balancing (mV)
+     * @return true if successful
+     */
+    bool balanceTopCells(uint8_t k, uint16_t threshold = 50);
+
     /**
      * @brief Disable balancing for all cells
      * @return true if successful
@@ -386,12 +525,374 @@ public:
      */
     bool getPackStats(PackStats &stats);
 
+    /**
+     * @brief Get median and quartiles of the last snapshot
+     * 
+     * Computed with a constant-time sorting network on every update,
+     * so no bus access is made here.
+     * 
+     * @param robust Structure to store statistics
+     * @return true if a snapshot is available
+     */
+    bool getRobustStats(RobustStats &robust);
+
+    /**
+     * @brief Get a cell voltage percentile of the last snapshot
+     * @param percent Percentile (0-100)
+     * @return Voltage in volts
+     */
+    float getCellVoltagePercentile(uint8_t percent);
+
+    /**
+     * @brief Get a temperature percentile of the last snapshot
+     * @param percent Percentile (0-100)
+     * @return Temperature in °C
+     */
+    float getTemperaturePercentile(uint8_t percent);
+
+    /**
+     * @brief Get the k highest cells of the last snapshot
+     * @param cells Array to store cell indices (highest first)
+     * @param k Number of cells requested
+     * @return Number of indices stored
+     */
+    uint8_t getTopCells(uint8_t *cells, uint8_t k);
+
+    /**
+     * @brief Get the k lowest cells of the last snapshot
+     * @param cells Array to store cell indices (lowest first)
+     * @param k Number of cells requested
+     * @return Number of indices stored
+     */
+    uint8_t getBottomCells(uint8_t *cells, uint8_t k);
+
+    /**
+     * @brief Get rank of a cell in the last snapshot
+     * @param cellIndex Cell index
+     * @return Rank (0 = lowest voltage, 0xFF if invalid)
+     */
+    uint8_t getCellRank(uint8_t cellIndex);
+
+    /**
+     * @brief Configure per-cell anomaly scoring
+     * 
+     * Each cell's deviation from the pack mean is compared with its own
+     * long-term offset and normalized by the running noise level. A cell
+     * starting to drift shows a rising score long before it reaches the
+     * protection thresholds.
+     * 
+     * @param alarmZ Alarm level as a z-score (0 = no alarms)
+     * @param window Running-statistics window (samples)
+     */
+    void setAnomalyDetection(float alarmZ, uint16_t window = PB7200_ANOMALY_WINDOW);
+
+    /**
+     * @brief Get smoothed anomaly score of a cell
+     * @param cellIndex Cell index
+     * @return RMS z-score over recent samples
+     */
+    float getCellAnomalyScore(uint8_t cellIndex);
+
+    /**
+     * @brief Get cells above the anomaly alarm level
+     * @return Bit mask of cells
+     */
+    uint32_t getAnomalyMask();
+
+    /**
+     * @brief Check if a cell is above the anomaly alarm level
+     * @param cellIndex Cell index
+     * @return true if anomalous
+     */
+    bool isCellAnomalous(uint8_t cellIndex);
+
     /**
      * @brief Update all readings (optimized)
+     * 
+     * In coherent mode a conversion is triggered and all registers are
+     * read in one burst after READY, so every value belongs to the same
+     * conversion cycle. If any read fails, the readings and statistics
+     * keep their last good values (see getDataAge()).
+     * 
      * @return true if successful
      */
     bool update();
 
+    // ========== Coherent Acquisition ==========
+
+    /**
+     * @brief Enable trigger-then-read acquisition in update()
+     * @param enable true to trigger a conversion and wait for READY
+     * @param timeoutMs Maximum wait for READY (ms)
+     */
+    void setCoherentMode(bool enable, uint16_t timeoutMs = PB7200_CONVERSION_TIMEOUT_MS);
+
+    /**
+     * @brief Trigger a single conversion
+     * @return true if successful
+     */
+    bool startConversion();
+
+    /**
+     * @brief Poll a pending conversion without blocking
+     * 
+     * Reads the snapshot once READY is set. Polling is skipped until
+     * the expected conversion time has elapsed to keep the bus idle.
+     * 
+     * @return Current acquisition state
+     */
+    PB7200_AcqState pollConversion();
+
+    /**
+     * @brief Get the last raw snapshot
+     * @return Reference to snapshot
+     */
+    const PackSnapshot &getSnapshot() const;
+
+    /**
+     * @brief Get time from trigger to READY of last conversion
+     * @return Conversion time in microseconds
+     */
+    unsigned long getConversionTime();
+
+    /**
+     * @brief Get number of status polls of last conversion
+     * @return Poll count (1 means no idle bus traffic)
+     */
+    uint16_t getConversionPolls();
+
+    // ========== Bus Error Handling ==========
+
+    /**
+     * @brief Set how often a failed register transfer is repeated
+     * @param retries Extra attempts per transfer (0 = none)
+     */
+    void setRetryCount(uint8_t retries);
+
+    /**
+     * @brief Set when the bus is restarted
+     * 
+     * After this many failed update() calls in a row the I2C peripheral
+     * (or transport) is started again, which releases a bus left stuck
+     * by an interrupted transfer.
+     * 
+     * @param failures Failed updates before a restart (0 = never)
+     */
+    void setRecoveryThreshold(uint8_t failures);
+
+    /**
+     * @brief Require new fault bits to be seen by a second read
+     * 
+     * A bit that is not set again when status is re-read is dropped
+     * (counted in UpdateTiming::rejectedFaults); a real latched fault
+     * stays set and is accepted one read later. If the second read fails,
+     * the update fails and the previous readings are kept.
+     * 
+     * @param enable true to confirm new faults (default)
+     */
+    void setFaultConfirmation(bool enable);
+
+    /**
+     * @brief Get time since the readings were last refreshed
+     * @return Age in milliseconds
+     */
+    unsigned long getDataAge();
+
+    /**
+     * @brief Get update() latency and bus error counters
+     * @param timing Structure to store counters
+     */
+    void getUpdateTiming(UpdateTiming &timing);
+
+    /**
+     * @brief Reset update() latency and bus error counters
+     */
+    void resetUpdateTiming();
+
+    // ========== Parallel Groups and Capacity ==========
+
+    /**
+     * @brief Configure an xSyP pack
+     * 
+     * Every channel is treated as a group of parallel cells; statistics
+     * are reported per group with per-cell-in-group estimates.
+     * 
+     * @param parallelCount Cells in parallel per group (P)
+     * @param groupCapacityAh Capacity of one group (Ah)
+     * @return true if successful
+     */
+    bool setParallelConfig(uint8_t parallelCount, float groupCapacityAh);
+
+    /**
+     * @brief Get number of cells in parallel per group
+     * @return Parallel count
+     */
+    uint8_t getParallelCount();
+
+    /**
+     * @brief Set balance bleed resistor value
+     * @param ohms Resistance per channel (0 = unknown)
+     */
+    void setBalanceResistance(float ohms);
+
+    /**
+     * @brief Set state of charge (e.g. after a full charge)
+     * @param percent State of charge (0-100%)
+     */
+    void setStateOfCharge(float percent);
+
+    /**
+     * @brief Get coulomb-counted state of charge
+     * @return State of charge (%)
+     */
+    float getStateOfCharge();
+
+    /**
+     * @brief Get bleed current of a balancing group
+     * @param cellIndex Cell (group) index
+     * @return Current in amperes (0.0 if not balancing)
+     */
+    float getBalanceCurrent(uint8_t cellIndex);
+
+    /**
+     * @brief Get bleed current per cell inside a balancing group
+     * @param cellIndex Cell (group) index
+     * @return Current in amperes (0.0 if not balancing)
+     */
+    float getCellBalanceCurrent(uint8_t cellIndex);
+
+    // ========== Lifetime Records ==========
+
+    /**
+     * @brief Persist lifetime extremes
+     * 
+     * Loads stored records and keeps them in sync. Each record type has
+     * its own ring of PB7200_RECORD_SLOTS slots; only changed records are
+     * written, at most once per flush interval.
+     * 
+     * @param storage Storage backend
+     * @param address Start address (uses PB7200_RECORD_STORAGE_SIZE bytes)
+     * @return true if successful
+     */
+    bool setRecordStorage(PB7200Storage *storage, uint32_t address = 0);
+
+    /**
+     * @brief Set minimum time between record flushes
+     * @param intervalMs Interval in milliseconds
+     */
+    void setRecordFlushInterval(unsigned long intervalMs);
+
+    /**
+     * @brief Write changed records now (e.g. before power-down)
+     * @return true if successful
+     */
+    bool flushRecords();
+
+    /**
+     * @brief Get a lifetime extreme
+     * @param type Record type
+     * @param record Structure to store record
+     * @return true if a value has been recorded
+     */
+    bool getLifetimeRecord(PB7200_RecordType type, LifetimeRecord &record);
+
+    /**
+     * @brief Get a lifetime extreme in engineering units
+     * @param type Record type
+     * @return Value in V, °C or A
+     */
+    float getLifetimeValue(PB7200_RecordType type);
+
+    /**
+     * @brief Clear all lifetime records
+     * @return true if successful
+     */
+    bool clearLifetimeRecords();
+
+    /**
+     * @brief Set the clock used for timestamps
+     * @param source Function returning seconds (nullptr = seconds since boot)
+     */
+    void setTimeSource(PB7200_TimeSource source);
+
+    // ========== Counter Checkpoints ==========
+
+    /**
+     * @brief Persist SOC, charge, energy and balance counters
+     * 
+     * Restores the newest valid checkpoint right away, so attach it
+     * before begin(). PB7200_CHECKPOINT_SLOTS slots are written in turn
+     * to spread wear; a torn write falls back to the previous one.
+     * 
+     * @param storage Storage backend
+     * @param address Start address (uses PB7200_CHECKPOINT_STORAGE_SIZE bytes)
+     * @return true if a checkpoint was restored
+     */
+    bool setCheckpointStorage(PB7200Storage *storage, uint32_t address);
+
+    /**
+     * @brief Set when checkpoints are written
+     * 
+     * A checkpoint is written once the counters moved by stepPercent of
+     * capacity, but never more often than minIntervalMs. Smaller changes
+     * are written after maxIntervalMs; nothing is written at rest.
+     * 
+     * @param stepPercent Charge change in % of capacity
+     * @param minIntervalMs Minimum time between writes
+     * @param maxIntervalMs Maximum time a change stays unwritten
+     */
+    void setCheckpointPolicy(float stepPercent, unsigned long minIntervalMs,
+                             unsigned long maxIntervalMs);
+
+    /**
+     * @brief Write a checkpoint now (e.g. before power-down)
+     * @return true if successful
+     */
+    bool saveCheckpoint();
+
+    /**
+     * @brief Reload counters from the newest valid checkpoint
+     * @return true if a checkpoint was found
+     */
+    bool restoreCheckpoint();
+
+    // ========== Event Log ==========
+
+    /**
+     * @brief Enable the black-box event log
+     * 
+     * The driver appends faults, resets, communication losses, protection
+     * config changes and balance sessions by itself. Attach before begin()
+     * to capture the boot event.
+     * 
+     * @param storage Storage backend
+     * @param address Start address
+     * @param slots Number of events kept (oldest are overwritten)
+     * @return true if successful
+     */
+    bool setEventLogStorage(PB7200Storage *storage, uint32_t address,
+                            uint16_t slots = PB7200_EVENT_SLOTS);
+
+    /**
+     * @brief Get number of stored events
+     * @return Event count
+     */
+    uint16_t getEventCount();
+
+    /**
+     * @brief Read a stored event
+     * @param age 0 = newest
+     * @param event Structure to store event
+     * @return true if the event is valid
+     */
+    bool getEvent(uint16_t age, EventRecord &event);
+
+    /**
+     * @brief Erase the event log
+     * @return true if successful
+     */
+    bool clearEventLog();
+
     // ========== Diagnostics ==========
     
     /**
@@ -421,15 +922,36 @@ public:
     void printStatus();
 
 private:
+    // One register read covering a run of channels
+    struct ReadBurst {
+        uint8_t first;   // First physical channel
+        uint8_t count;   // Channels read (including gaps)
+    };
+    
     // Hardware configuration
     PB7200_Interface _interface;
     uint8_t _i2cAddress;
     TwoWire *_wire;
     HardwareSerial *_serial;
+    PB7200Transport *_transport;
     
     // Pack configuration
     uint8_t _cellCount;
     uint8_t _tempSensorCount;
+    uint32_t _cellMask;
+    uint8_t _tempMask;
+    
+    // Logical <-> physical channel maps (0xFF = unused)
+    uint8_t _cellTap[PB7200_MAX_CELLS];
+    uint8_t _tapCell[PB7200_MAX_CELLS];
+    uint8_t _tempSensor[PB7200_MAX_TEMPS];
+    uint8_t _sensorTemp[PB7200_MAX_TEMPS];
+    
+    // Read plans
+    ReadBurst _cellBursts[PB7200_MAX_CELLS / 2];
+    uint8_t _cellBurstCount;
+    ReadBurst _tempBursts[PB7200_MAX_TEMPS / 2];
+    uint8_t _tempBurstCount;
     
     // Data cache
     float _cellVoltages[PB7200_MAX_CELLS];
@@ -438,12 +960,88 @@ private:
     uint8_t _status;
     uint8_t _faultStatus;
     unsigned long _lastUpdate;
+    PackSnapshot _snapshot;
+    PackStats _stats;
+    PackConfig _packConfig;
+    RobustStats _robust;
+    CellRanking _ranking;
+    AnomalyState _anomaly;
+    
+    // Lifetime records
+    LifetimeRecord _records[PB7200_RECORD_COUNT];
+    RecordRing _recordRings[PB7200_RECORD_COUNT];
+    uint8_t _recordsDirty;
+    bool _recordsFlushed;
+    unsigned long _recordFlushInterval;
+    unsigned long _lastRecordFlush;
+    PB7200_TimeSource _timeSource;
+    
+    // Counter checkpoints
+    RecordRing _checkpointRing;
+    int64_t _checkpointCharge;
+    int64_t _checkpointBalance;
+    int64_t _checkpointEnergy;
+    float _checkpointStep;
+    unsigned long _checkpointMinInterval;
+    unsigned long _checkpointMaxInterval;
+    unsigned long _lastCheckpoint;
+    
+    // Event log
+    RecordRing _eventLog;
+    uint8_t _loggedFaults;
+    uint32_t _loggedBalanceMask;
+    uint32_t _balanceStartTime;
+    bool _commOk;
+    uint32_t _commLostTime;
+    uint16_t _sortedCells[PB7200_MAX_CELLS];
+    int16_t _sortedTemps[PB7200_MAX_TEMPS];
+    PackCounters _counters;
+    
+    // Coherent acquisition
+    bool _coherentMode;
+    uint16_t _conversionTimeout;
+    PB7200_AcqState _acqState;
+    unsigned long _conversionStart;
+    unsigned long _conversionTime;
+    unsigned long _expectedConversionTime;
+    uint16_t _conversionPolls;
+    
+    // Bus error handling
+    uint8_t _retries;
+    uint8_t _recoveryThreshold;
+    uint8_t _failedUpdates;
+    bool _confirmFaults;
+    UpdateTiming _timing;
+    
+    // Shared constructor body
+    void init();
     
     // Private communication methods
     bool writeRegister(uint8_t reg, uint8_t value);
     bool writeRegisters(uint8_t reg, uint8_t *values, uint8_t length);
     bool readRegister(uint8_t reg, uint8_t &value);
     bool readRegisters(uint8_t reg, uint8_t *values, uint8_t length);
+    bool transferWrite(uint8_t reg, const uint8_t *values, uint8_t length);
+    bool transferRead(uint8_t reg, uint8_t *values, uint8_t length);
+    bool confirmFaults(uint8_t &faults);
+    void recordUpdate(bool ok, unsigned long startUs);
+    void recoverBus();
+    
+    // Snapshot acquisition
+    bool readSnapshot(PackSnapshot &snapshot, bool readStatus);
+    void applySnapshot();
+    bool readChannels(uint8_t baseReg, const ReadBurst *bursts, uint8_t burstCount,
+                      const uint8_t *toLogical, uint16_t *dest);
+    static uint8_t planBursts(uint32_t mask, uint8_t channels,
+                              ReadBurst *bursts, uint8_t maxBursts);
+    void buildCellPlan();
+    void buildTempPlan();
+    uint32_t now();
+    void updateCheckpoint();
+    bool logEvent(PB7200_EventType type, uint32_t data = 0);
+    void trackCommState(bool ok);
+    void printLine(PB7200LineBuffer &line);
+    uint32_t totalCellRaw() const;
     
     // Helper methods
     uint16_t voltageToRaw(float voltage);
@@ -0,0 +1,489 @@
+/**
+ * @file PB7200Stats.cpp
+ * @brief Implementation of pack statistics kernel
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ */
+
+#include "PB7200Stats.h"
+
+// µA·s per Ah and µW·s per Wh
+#define PB7200_UAS_PER_AH 3600000000.0
+#define PB7200_UWS_PER_WH 3600000000.0
+
+// Samples before anomaly alarms are raised
+#define PB7200_ANOMALY_WARMUP 16
+
+// Variance floor: 1mV² (ADC resolution), in mV² × 65536
+#define PB7200_ANOMALY_MIN_VAR 65536UL
+
+// Residuals above z = 4 (z² × 256) do not feed the pooled variance, so
+// a drifting cell cannot hide itself by inflating it
+#define PB7200_ANOMALY_GATE 4096
+
+/**
+ * @brief Divide, rounding halves away from zero
+ *
+ * Running statistics move by (sample - mean) / count; truncating would
+ * freeze them once that step falls below one unit.
+ */
+template <typename T>
+static inline T roundedDiv(T num, T den) {
+    return num >= 0 ? (num + den / 2) / den : -((-num + den / 2) / den);
+}
+
+/**
+ * @brief Clear running anomaly statistics, keeping the settings
+ */
+static void clearAnomaly(AnomalyState &anomaly) {
+    for (uint8_t i = 0; i < PB7200_MAX_CELLS; i++) {
+        anomaly.meanQ16[i] = 0;
+        anomaly.score[i] = 0;
+    }
+    anomaly.varQ16 = 0;
+    anomaly.count = 0;
+    anomaly.alarmMask = 0;
+    anomaly.cellCount = 0;
+}
+
+/**
+ * @brief Compute pack statistics from a raw snapshot
+ */
+void computePackStats(const PackSnapshot &snapshot, const PackConfig &config,
+                      PackCounters &counters, PackStats &stats,
+                      AnomalyState *anomaly) {
+    PackSums sums;
+    accumulatePackSums(snapshot, sums);
+    finishPackStats(snapshot, sums, config, counters, stats, anomaly);
+}
+
+/**
+ * @brief Accumulation pass of computePackStats()
+ */
+void accumulatePackSums(const PackSnapshot &snapshot, PackSums &sums) {
+    uint32_t totalRaw = 0;
+    uint16_t maxRaw = 0;
+    uint16_t minRaw = 0xFFFF;
+    uint32_t balanceRaw = 0;
+    uint8_t balancingCount = 0;
+    
+    sums.maxCellIndex = 0;
+    sums.minCellIndex = 0;
+    
+    // Process voltages (integer counts, converted once at the end)
+    for (uint8_t i = 0; i < snapshot.cellCount; i++) {
+        uint16_t raw = snapshot.cellRaw[i];
+        totalRaw += raw;
+        
+        if (raw > maxRaw) {
+            maxRaw = raw;
+            sums.maxCellIndex = i;
+        }
+        
+        if (raw < minRaw) {
+            minRaw = raw;
+            sums.minCellIndex = i;
+        }
+        
+        if (snapshot.balanceMask & (1UL << i)) {
+            balanceRaw += raw;
+            balancingCount++;
+        }
+    }
+    
+    if (snapshot.cellCount == 0) {
+        minRaw = 0;
+    }
+    
+    // Process temperatures
+    int16_t maxTempRaw = INT16_MIN;
+    int16_t minTempRaw = INT16_MAX;
+    sums.maxTempIndex = 0;
+    sums.minTempIndex = 0;
+    
+    for (uint8_t i = 0; i < snapshot.tempCount; i++) {
+        int16_t raw = snapshot.tempRaw[i];
+        
+        if (raw > maxTempRaw) {
+            maxTempRaw = raw;
+            sums.maxTempIndex = i;
+        }
+        
+        if (raw < minTempRaw) {
+            minTempRaw = raw;
+            sums.minTempIndex = i;
+        }
+    }
+    
+    if (snapshot.tempCount == 0) {
+        maxTempRaw = 0;
+        minTempRaw = 0;
+    }
+    
+    sums.totalRaw = totalRaw;
+    sums.balanceRaw = balanceRaw;
+    sums.maxRaw = maxRaw;
+    sums.minRaw = minRaw;
+    sums.maxTempRaw = maxTempRaw;
+    sums.minTempRaw = minTempRaw;
+    sums.balancingCount = balancingCount;
+}
+
+/**
+ * @brief Conversion, integration and anomaly pass of computePackStats()
+ */
+void finishPackStats(const PackSnapshot &snapshot, const PackSums &sums,
+                     const PackConfig &config, PackCounters &counters, PackStats &stats,
+                     AnomalyState *anomaly) {
+    uint32_t totalRaw = sums.totalRaw;
+    uint32_t balanceRaw = sums.balanceRaw;
+    
+    stats.totalVoltage = totalRaw * PB7200_VOLTAGE_LSB;
+    stats.maxCellVoltage = sums.maxRaw * PB7200_VOLTAGE_LSB;
+    stats.minCellVoltage = sums.minRaw * PB7200_VOLTAGE_LSB;
+    stats.avgCellVoltage = snapshot.cellCount ? stats.totalVoltage / snapshot.cellCount : 0.0;
+    stats.voltageDelta = (sums.maxRaw - sums.minRaw) * PB7200_VOLTAGE_LSB;
+    stats.maxCellIndex = sums.maxCellIndex;
+    stats.minCellIndex = sums.minCellIndex;
+    
+    stats.maxTemp = sums.maxTempRaw * PB7200_TEMP_LSB;
+    stats.minTemp = sums.minTempRaw * PB7200_TEMP_LSB;
+    stats.maxTempIndex = sums.maxTempIndex;
+    stats.minTempIndex = sums.minTempIndex;
+    
+    // Current and power
+    stats.current = snapshot.currentRaw * PB7200_CURRENT_LSB;
+    stats.power = stats.totalVoltage * stats.current;
+    
+    // Integrate charge (mA·ms = µA·s) and energy (mV·mA·ms/1000 = µW·s)
+    int32_t currentMa = (int32_t)snapshot.currentRaw * 10;
+    uint32_t dt = counters.started ? snapshot.timestamp - counters.timestamp : 0;
+    counters.chargeUAs += (int64_t)currentMa * dt;
+    counters.energyUWs += (int64_t)totalRaw * currentMa * dt / 1000;
+    
+    // Bleed charge: mV / Ω = mA, times ms = µA·s
+    if (config.balanceResistance > 0.0) {
+        counters.balanceUAs += (int64_t)((float)balanceRaw * dt / config.balanceResistance);
+    }
+    counters.timestamp = snapshot.timestamp;
+    counters.started = true;
+    
+    int64_t capacityUAs = (int64_t)(config.groupCapacityAh * PB7200_UAS_PER_AH);
+    if (counters.chargeUAs > capacityUAs) {
+        counters.chargeUAs = capacityUAs;
+    } else if (counters.chargeUAs < 0) {
+        counters.chargeUAs = 0;
+    }
+    
+    // Per-group values; every channel is one group of parallelCount cells
+    uint8_t parallel = config.parallelCount ? config.parallelCount : 1;
+    stats.parallelCount = parallel;
+    stats.cellCurrent = stats.current / parallel;
+    stats.remainingAh = counters.chargeUAs / PB7200_UAS_PER_AH;
+    stats.cellRemainingAh = stats.remainingAh / parallel;
+    stats.soc = capacityUAs > 0 ? 100.0 * counters.chargeUAs / capacityUAs : 0.0;
+    stats.remainingWh = stats.remainingAh * stats.totalVoltage;
+    stats.energyWh = counters.energyUWs / PB7200_UWS_PER_WH;
+    stats.balanceCurrent = config.balanceResistance > 0.0
+        ? balanceRaw * PB7200_VOLTAGE_LSB / config.balanceResistance : 0.0;
+    stats.balancingCount = sums.balancingCount;
+    stats.balancedAh = counters.balanceUAs / PB7200_UAS_PER_AH;
+    
+    if (anomaly == nullptr || snapshot.cellCount == 0) {
+        return;
+    }
+    
+    // Deviation sweep: needs the pack mean, so it follows the first pass
+    AnomalyState &a = *anomaly;
+    if (a.cellCount != snapshot.cellCount) {
+        clearAnomaly(a);
+        a.cellCount = snapshot.cellCount;
+    }
+    if (a.count < a.window) {
+        a.count++;
+    }
+    
+    int32_t packMeanQ8 = (int32_t)((totalRaw << 8) / snapshot.cellCount);
+    uint32_t var = a.varQ16 > PB7200_ANOMALY_MIN_VAR ? a.varQ16 : PB7200_ANOMALY_MIN_VAR;
+    bool warm = a.count >= PB7200_ANOMALY_WARMUP;
+    uint32_t alarmMask = 0;
+    uint64_t residualSum = 0;
+    uint8_t residualCount = 0;
+    
+    for (uint8_t i = 0; i < snapshot.cellCount; i++) {
+        int32_t devQ8 = ((int32_t)snapshot.cellRaw[i] << 8) - packMeanQ8;
+        
+        // Welford mean of this cell's offset (exponential once count reaches window)
+        a.meanQ16[i] += roundedDiv(devQ8 * 256 - a.meanQ16[i], (int32_t)a.count);
+        int32_t residual = devQ8 - roundedDiv(a.meanQ16[i], (int32_t)256);
+        uint64_t squareQ16 = (uint64_t)((int64_t)residual * residual);
+        
+        // z² in 1/256 against the pooled variance, smoothed (1/8)
+        uint64_t z2 = (squareQ16 << 8) / var;
+        if (z2 > 0xFFFF) {
+            z2 = 0xFFFF;
+        }
+        a.score[i] += ((int32_t)z2 - (int32_t)a.score[i]) / 8;
+        
+        if (!warm || z2 < PB7200_ANOMALY_GATE) {
+            residualSum += squareQ16;
+            residualCount++;
+        }
+        
+        if (warm && a.alarmLevel != 0 && a.score[i] > a.alarmLevel) {
+            alarmMask |= (1UL << i);
+        }
+    }
+    
+    if (residualCount > 0) {
+        int64_t sampleVar = residualSum / residualCount;
+        int64_t varQ16 = a.varQ16 + roundedDiv(sampleVar - (int64_t)a.varQ16, (int64_t)a.count);
+        a.varQ16 = varQ16 > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)varQ16;
+    }
+    
+    a.alarmMask = alarmMask;
+}
+
+/**
+ * @brief Reset anomaly tracking
+ */
+void resetAnomaly(AnomalyState &anomaly, uint16_t window, float alarmZ) {
+    clearAnomaly(anomaly);
+    anomaly.window = window ? window : 1;
+    
+    // Alarm compares squared scores; 0 disables alarms
+    float level = alarmZ > 0.0 ? alarmZ * alarmZ * 256.0 : 0.0;
+    anomaly.alarmLevel = level > 65535.0 ? 65535 : (uint16_t)level;
+}
+
+/**
+ * @brief Set remaining charge from a state of charge
+ */
+void setCountersSoc(const PackConfig &config, PackCounters &counters, float soc) {
+    if (soc < 0.0) {
+        soc = 0.0;
+    } else if (soc > 100.0) {
+        soc = 100.0;
+    }
+    counters.chargeUAs = (int64_t)(config.groupCapacityAh * PB7200_UAS_PER_AH * soc / 100.0);
+}
+
+/**
+ * @brief Branch-free compare-exchange: a gets the smaller value
+ */
+template <typename T>
+static inline void compareExchange(T &a, T &b) {
+    int32_t diff = (int32_t)b - (int32_t)a;
+    int32_t swap = diff & (diff >> 31);  // diff if b < a, else 0
+    a = (T)(a + swap);
+    b = (T)(b - swap);
+}
+
+/**
+ * @brief Batcher merge-exchange network (Knuth, Algorithm 5.2.2M)
+ */
+template <typename T>
+static void mergeExchangeSort(T *values, uint8_t count) {
+    if (count < 2) {
+        return;
+    }
+    
+    uint8_t top = 1;
+    while (top < count) {
+        top <<= 1;
+    }
+    
+    for (uint8_t p = top >> 1; p > 0; p >>= 1) {
+        uint8_t q = top >> 1;
+        uint8_t r = 0;
+        uint8_t d = p;
+        
+        for (;;) {
+            for (uint8_t i = 0; i + d < count; i++) {
+                if ((i & p) == r) {
+                    compareExchange(values[i], values[i + d]);
+                }
+            }
+            if (q == p) {
+                break;
+            }
+            d = q - p;
+            q >>= 1;
+            r = p;
+        }
+    }
+}
+
+template <typename T>
+static float percentileOf(const T *sorted, uint8_t count, uint8_t percent) {
+    if (count == 0) {
+        return 0.0;
+    }
+    if (percent > 100) {
+        percent = 100;
+    }
+    
+    // Linear interpolation between closest ranks
+    uint16_t rank = (uint16_t)percent * (count - 1);
+    uint8_t index = rank / 100;
+    uint8_t frac = rank % 100;
+    if (frac == 0) {
+        return sorted[index];
+    }
+    return sorted[index] + ((int32_t)sorted[index + 1] - sorted[index]) * frac / 100.0;
+}
+
+/**
+ * @brief Sort values with a fixed sorting network
+ */
+void sortNetwork(uint16_t *values, uint8_t count) {
+    mergeExchangeSort(values, count);
+}
+
+void sortNetwork(int16_t *values, uint8_t count) {
+    mergeExchangeSort(values, count);
+}
+
+/**
+ * @brief Interpolated percentile of sorted values
+ */
+float percentileRaw(const uint16_t *sorted, uint8_t count, uint8_t percent) {
+    return percentileOf(sorted, count, percent);
+}
+
+float percentileRaw(const int16_t *sorted, uint8_t count, uint8_t percent) {
+    return percentileOf(sorted, count, percent);
+}
+
+/**
+ * @brief Compute median and quartiles of a snapshot
+ */
+void computeRobustStats(const PackSnapshot &snapshot, uint16_t *sortedCells,
+                        int16_t *sortedTemps, RobustStats &robust) {
+    // Pad with the largest value so unused slots sort to the top
+    for (uint8_t i = 0; i < PB7200_MAX_CELLS; i++) {
+        sortedCells[i] = i < snapshot.cellCount ? snapshot.cellRaw[i] : 0xFFFF;
+    }
+    for (uint8_t i = 0; i < PB7200_MAX_TEMPS; i++) {
+        sortedTemps[i] = i < snapshot.tempCount ? snapshot.tempRaw[i] : INT16_MAX;
+    }
+    
+    sortNetwork(sortedCells, PB7200_MAX_CELLS);
+    sortNetwork(sortedTemps, PB7200_MAX_TEMPS);
+    
+    uint8_t cells = snapshot.cellCount;
+    uint8_t temps = snapshot.tempCount;
+    
+    robust.medianCellVoltage = percentileOf(sortedCells, cells, 50) * PB7200_VOLTAGE_LSB;
+    robust.q1CellVoltage = percentileOf(sortedCells, cells, 25) * PB7200_VOLTAGE_LSB;
+    robust.q3CellVoltage = percentileOf(sortedCells, cells, 75) * PB7200_VOLTAGE_LSB;
+    robust.iqrCellVoltage = robust.q3CellVoltage - robust.q1CellVoltage;
+    
+    robust.medianTemp = percentileOf(sortedTemps, temps, 50) * PB7200_TEMP_LSB;
+    robust.q1Temp = percentileOf(sortedTemps, temps, 25) * PB7200_TEMP_LSB;
+    robust.q3Temp = percentileOf(sortedTemps, temps, 75) * PB7200_TEMP_LSB;
+    robust.iqrTemp = robust.q3Temp - robust.q1Temp;
+}
+
+/**
+ * @brief Repair the cell ranking for a new snapshot
+ */
+void updateRanking(const PackSnapshot &snapshot, CellRanking &ranking) {
+    const uint16_t *v = snapshot.cellRaw;
+    
+    if (ranking.count != snapshot.cellCount) {
+        ranking.count = snapshot.cellCount;
+        for (uint8_t i = 0; i < ranking.count; i++) {
+            ranking.order[i] = i;
+        }
+    }
+    
+    for (uint8_t i = 1; i < ranking.count; i++) {
+        uint8_t cell = ranking.order[i];
+        uint16_t value = v[cell];
+        uint8_t j = i;
+        while (j > 0 && v[ranking.order[j - 1]] > value) {
+            ranking.order[j] = ranking.order[j - 1];
+            j--;
+        }
+        ranking.order[j] = cell;
+    }
+}
+
+/**
+ * @brief Choose cells to balance from the ranking
+ */
+uint32_t selectBalanceCells(const PackSnapshot &snapshot, const CellRanking &ranking,
+                            uint8_t maxCells, uint16_t thresholdRaw) {
+    if (ranking.count == 0) {
+        return 0;
+    }
+    
+    uint32_t limit = (uint32_t)snapshot.cellRaw[ranking.order[0]] + thresholdRaw;
+    uint32_t mask = 0;
+    
+    // Walk down from the highest cell until below the threshold
+    for (uint8_t n = 0; n < maxCells && n < ranking.count; n++) {
+        uint8_t cell = ranking.order[ranking.count - 1 - n];
+        if (snapshot.cellRaw[cell] <= limit) {
+            break;
+        }
+        mask |= (1UL << cell);
+    }
+    
+    return mask;
+}
+
+/**
+ * @brief Replace a record if the new value is more extreme
+ */
+static bool updateRecord(LifetimeRecord &record, int32_t raw, uint8_t index,
+                         uint32_t timestamp, bool higher) {
+    if (record.index != 0xFF && (higher ? raw <= record.raw : raw >= record.raw)) {
+        return false;
+    }
+    record.raw = raw;
+    record.index = index;
+    record.timestamp = timestamp;
+    return true;
+}
+
+/**
+ * @brief Update lifetime extremes from the kernel's min/max outputs
+ */
+uint8_t updateLifetimeRecords(const PackSnapshot &snapshot, const PackStats &stats,
+                              LifetimeRecord *records, uint32_t timestamp) {
+    uint8_t changed = 0;
+    
+    if (snapshot.cellCount > 0) {
+        if (updateRecord(records[PB7200_RECORD_MAX_CELL_VOLTAGE], snapshot.cellRaw[stats.maxCellIndex],
+                         stats.maxCellIndex, timestamp, true)) {
+            changed |= (1 << PB7200_RECORD_MAX_CELL_VOLTAGE);
+        }
+        if (updateRecord(records[PB7200_RECORD_MIN_CELL_VOLTAGE], snapshot.cellRaw[stats.minCellIndex],
+                         stats.minCellIndex, timestamp, false)) {
+            changed |= (1 << PB7200_RECORD_MIN_CELL_VOLTAGE);
+        }
+    }
+    
+    if (snapshot.tempCount > 0) {
+        if (updateRecord(records[PB7200_RECORD_MAX_TEMP], snapshot.tempRaw[stats.maxTempIndex],
+                         stats.maxTempIndex, timestamp, true)) {
+            changed |= (1 << PB7200_RECORD_MAX_TEMP);
+        }
+        if (updateRecord(records[PB7200_RECORD_MIN_TEMP], snapshot.tempRaw[stats.minTempIndex],
+                         stats.minTempIndex, timestamp, false)) {
+            changed |= (1 << PB7200_RECORD_MIN_TEMP);
+        }
+    }
+    
+    if (updateRecord(records[PB7200_RECORD_MAX_CURRENT], snapshot.currentRaw, 0, timestamp, true)) {
+        changed |= (1 << PB7200_RECORD_MAX_CURRENT);
+    }
+    if (updateRecord(records[PB7200_RECORD_MIN_CURRENT], snapshot.currentRaw, 0, timestamp, false)) {
+        changed |= (1 << PB7200_RECORD_MIN_CURRENT);
+    }
+    
+    return changed;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file PB7200Stats.h
+ * @brief Pack statistics kernel for PB7200P80 snapshots
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ * 
+ * Integer single-pass kernel shared by the driver and host tools.
+ */
+
+#ifndef PB7200STATS_H
+#define PB7200STATS_H
+
+#include "PB7200Types.h"
+
+/**
+ * @brief Compute pack statistics from a raw snapshot
+ * 
+ * Only the cells and sensors present in the snapshot are considered,
+ * so masked-out channels never affect min/max. Charge and energy are
+ * integrated in the same pass, and group values are scaled to the
+ * cells inside each parallel group.
+ * 
+ * When anomaly state is given, each cell's deviation from the pack mean
+ * is scored in the deviation sweep that follows the accumulation pass.
+ * 
+ * @param snapshot Raw snapshot in logical order
+ * @param config Pack layout
+ * @param counters Integrators, advanced to the snapshot time
+ * @param stats Structure to store statistics
+ * @param anomaly Anomaly state to update (optional)
+ */
+void computePackStats(const PackSnapshot &snapshot, const PackConfig &config,
+                      PackCounters &counters, PackStats &stats,
+                      AnomalyState *anomaly = nullptr);
+
+/**
+ * @brief Accumulation pass of computePackStats()
+ * 
+ * Integer sums and extremes of one snapshot. Batch tools compute the
+ * same sums for many snapshots at once and pass them to
+ * finishPackStats(), so both paths share the rest of the kernel.
+ * 
+ * @param snapshot Raw snapshot in logical order
+ * @param sums Structure to store the sums
+ */
+void accumulatePackSums(const PackSnapshot &snapshot, PackSums &sums);
+
+/**
+ * @brief Conversion, integration and anomaly pass of computePackStats()
+ * @param snapshot Raw snapshot the sums were computed from
+ * @param sums Result of the accumulation pass
+ * @param config Pack layout
+ * @param counters Integrators, advanced to the snapshot time
+ * @param stats Structure to store statistics
+ * @param anomaly Anomaly state to update (optional)
+ */
+void finishPackStats(const PackSnapshot &snapshot, const PackSums &sums,
+                     const PackConfig &config, PackCounters &counters, PackStats &stats,
+                     AnomalyState *anomaly = nullptr);
+
+/**
+ * @brief Reset anomaly tracking
+ * @param anomaly State to reset
+ * @param window Running-stats window (samples)
+ * @param alarmZ Alarm level as a z-score (0 = no alarms)
+ */
+void resetAnomaly(AnomalyState &anomaly, uint16_t window, float alarmZ);
+
+/**
+ * @brief Set remaining charge from a state of charge
+ * @param config Pack layout
+ * @param counters Integrators to update
+ * @param soc State of charge (%)
+ */
+void setCountersSoc(const PackConfig &config, PackCounters &counters, float soc);
+
+/**
+ * @brief Sort values with a fixed sorting network
+ * 
+ * Batcher merge-exchange network: the sequence of compare-exchanges
+ * depends only on count, and each one is branch-free, so run time does
+ * not depend on the data.
+ * 
+ * @param values Array to sort in place
+ * @param count Number of values
+ */
+void sortNetwork(uint16_t *values, uint8_t count);
+void sortNetwork(int16_t *values, uint8_t count);
+
+/**
+ * @brief Interpolated percentile of sorted values
+ * @param sorted Sorted values
+ * @param count Number of values
+ * @param percent Percentile (0-100)
+ * @return Percentile in raw counts
+ */
+float percentileRaw(const uint16_t *sorted, uint8_t count, uint8_t percent);
+float percentileRaw(const int16_t *sorted, uint8_t count, uint8_t percent);
+
+/**
+ * @brief Compute median and quartiles of a snapshot
+ * 
+ * Cells are always sorted as PB7200_MAX_CELLS values and sensors as
+ * PB7200_MAX_TEMPS values, padded at the top, so the cost is constant.
+ * 
+ * @param snapshot Raw snapshot in logical order
+ * @param sortedCells Receives PB7200_MAX_CELLS sorted cell counts
+ * @param sortedTemps Receives PB7200_MAX_TEMPS sorted sensor counts
+ * @param robust Structure to store statistics
+ */
+void computeRobustStats(const PackSnapshot &snapshot, uint16_t *sortedCells,
+                        int16_t *sortedTemps, RobustStats &robust);
+
+/**
+ * @brief Repair the cell ranking for a new snapshot
+ * 
+ * Insertion sort starting from the previous order: cell voltages move
+ * little between samples, so this is close to O(n). Equal voltages keep
+ * their previous order to avoid churn.
+ * 
+ * @param snapshot Raw snapshot in logical order
+ * @param ranking Ranking to update
+ */
+void updateRanking(const PackSnapshot &snapshot, CellRanking &ranking);
+
+/**
+ * @brief Choose cells to balance from the ranking
+ * @param snapshot Raw snapshot in logical order
+ * @param ranking Current ranking
+ * @param maxCells Maximum number of cells to balance (k)
+ * @param thresholdRaw Minimum excess over the lowest cell (counts)
+ * @return Bit mask of logical cells to balance
+ */
+uint32_t selectBalanceCells(const PackSnapshot &snapshot, const CellRanking &ranking,
+                            uint8_t maxCells, uint16_t thresholdRaw);
+
+/**
+ * @brief Update lifetime extremes from the kernel's min/max outputs
+ * @param snapshot Raw snapshot in logical order
+ * @param stats Statistics of the same snapshot
+ * @param records Array of PB7200_RECORD_COUNT records
+ * @param timestamp Time to store with new extremes (s)
+ * @return Bit mask of changed records (bit = PB7200_RecordType)
+ */
+uint8_t updateLifetimeRecords(const PackSnapshot &snapshot, const PackStats &stats,
+                              LifetimeRecord *records, uint32_t timestamp);
+
+#endif // PB7200STATS_H
@@ -0,0 +1,316 @@
+/**
+ * @file PB7200Storage.cpp
+ * @brief Implementation of wear-leveled record rings
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ */
+
+#include "PB7200Storage.h"
+#include <string.h>
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define PB7200_CCITT_TABLE_READ(i) pgm_read_word(&ccittTable[i])
+#else
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#define PB7200_CCITT_TABLE_READ(i) ccittTable[i]
+#endif
+
+/**
+ * @brief CRC-16/CCITT of every byte value (polynomial 0x1021)
+ */
+static const uint16_t ccittTable[256] PROGMEM = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+/**
+ * @brief CRC-16/CCITT-FALSE
+ */
+uint16_t pb7200Crc16(const void *data, uint16_t length, uint16_t crc) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (uint16_t i = 0; i < length; i++) {
+        crc = (crc << 8) ^ PB7200_CCITT_TABLE_READ(((crc >> 8) ^ bytes[i]) & 0xFF);
+    }
+    return crc;
+}
+
+#ifndef ARDUINO
+/**
+ * @brief Open or create the backing file
+ */
+PB7200FileStorage::PB7200FileStorage(const char *path, uint32_t size) {
+    _size = size;
+    _file = fopen(path, "r+b");
+    if (_file == nullptr) {
+        _file = fopen(path, "w+b");
+    }
+    if (_file == nullptr) {
+        return;
+    }
+    
+    // Extend with erased bytes
+    fseek(_file, 0, SEEK_END);
+    long length = ftell(_file);
+    for (long i = length; i < (long)size; i++) {
+        fputc(0xFF, _file);
+    }
+    fflush(_file);
+}
+
+PB7200FileStorage::~PB7200FileStorage() {
+    if (_file != nullptr) {
+        fclose(_file);
+    }
+}
+
+bool PB7200FileStorage::isOpen() {
+    return _file != nullptr;
+}
+
+uint32_t PB7200FileStorage::size() {
+    return _file != nullptr ? _size : 0;
+}
+
+bool PB7200FileStorage::read(uint32_t address, void *data, uint16_t length) {
+    if (_file == nullptr || address + length > _size || fseek(_file, address, SEEK_SET) != 0) {
+        return false;
+    }
+    return fread(data, 1, length, _file) == length;
+}
+
+bool PB7200FileStorage::write(uint32_t address, const void *data, uint16_t length) {
+    if (_file == nullptr || address + length > _size || fseek(_file, address, SEEK_SET) != 0) {
+        return false;
+    }
+    return fwrite(data, 1, length, _file) == length;
+}
+
+bool PB7200FileStorage::commit() {
+    return _file != nullptr && fflush(_file) == 0;
+}
+#endif
+
+/**
+ * @brief Constructor
+ */
+RecordRing::RecordRing() {
+    _storage = nullptr;
+    _address = 0;
+    _sequence = 0;
+    _slots = 0;
+    _head = 0;
+    _count = 0;
+    _payloadSize = 0;
+}
+
+/**
+ * @brief Bytes needed for a ring
+ */
+uint32_t RecordRing::footprint(uint16_t slots, uint8_t payloadSize) {
+    return (uint32_t)slots * (PB7200_RECORD_HEADER_SIZE + payloadSize + PB7200_RECORD_CRC_SIZE);
+}
+
+/**
+ * @brief Mount a ring by scanning slot headers only
+ */
+bool RecordRing::begin(PB7200Storage *storage, uint32_t address, uint16_t slots, uint8_t payloadSize) {
+    if (storage == nullptr || slots == 0 || payloadSize > PB7200_RECORD_MAX_PAYLOAD ||
+        address + footprint(slots, payloadSize) > storage->size()) {
+        _storage = nullptr;
+        return false;
+    }
+    
+    _storage = storage;
+    _address = address;
+    _slots = slots;
+    _payloadSize = payloadSize;
+    _sequence = 0;
+    _head = 0;
+    _count = 0;
+    
+    // Newest slot has the highest sequence; erased slots read 0 or 0xFFFFFFFF
+    for (uint16_t slot = 0; slot < slots; slot++) {
+        uint8_t seq[4];
+        if (!_storage->read(slotAddress(slot), seq, 4)) {
+            _storage = nullptr;
+            return false;
+        }
+        
+        uint32_t sequence = seq[0] | ((uint32_t)seq[1] << 8) |
+                            ((uint32_t)seq[2] << 16) | ((uint32_t)seq[3] << 24);
+        if (sequence == 0 || sequence == 0xFFFFFFFF) {
+            continue;
+        }
+        
+        _count++;
+        if (sequence > _sequence) {
+            _sequence = sequence;
+            _head = (slot + 1) % slots;
+        }
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Append a record to the next slot
+ */
+bool RecordRing::append(uint8_t type, const void *payload, uint8_t length) {
+    if (_storage == nullptr || length > _payloadSize) {
+        return false;
+    }
+    
+    uint8_t slot[PB7200_RECORD_HEADER_SIZE + PB7200_RECORD_MAX_PAYLOAD + PB7200_RECORD_CRC_SIZE];
+    uint32_t sequence = _sequence + 1;
+    uint16_t size = slotSize();
+    
+    memset(slot, 0, size);
+    slot[0] = sequence & 0xFF;
+    slot[1] = (sequence >> 8) & 0xFF;
+    slot[2] = (sequence >> 16) & 0xFF;
+    slot[3] = (sequence >> 24) & 0xFF;
+    slot[4] = type;
+    slot[5] = length;
+    memcpy(slot + PB7200_RECORD_HEADER_SIZE, payload, length);
+    
+    uint16_t crc = pb7200Crc16(slot, size - PB7200_RECORD_CRC_SIZE);
+    slot[size - 2] = crc & 0xFF;
+    slot[size - 1] = crc >> 8;
+    
+    if (!_storage->write(slotAddress(_head), slot, size) || !_storage->commit()) {
+        return false;
+    }
+    
+    _sequence = sequence;
+    _head = (_head + 1) % _slots;
+    if (_count < _slots) {
+        _count++;
+    }
+    return true;
+}
+
+/**
+ * @brief Read a record by age
+ */
+bool RecordRing::read(uint16_t age, RecordHeader &header, void *payload) {
+    if (_storage == nullptr || age >= _count) {
+        return false;
+    }
+    
+    uint8_t slot[PB7200_RECORD_HEADER_SIZE + PB7200_RECORD_MAX_PAYLOAD + PB7200_RECORD_CRC_SIZE];
+    uint16_t size = slotSize();
+    uint16_t index = (_head + _slots - 1 - age) % _slots;
+    
+    if (!_storage->read(slotAddress(index), slot, size)) {
+        return false;
+    }
+    
+    uint16_t crc = slot[size - 2] | ((uint16_t)slot[size - 1] << 8);
+    if (crc != pb7200Crc16(slot, size - PB7200_RECORD_CRC_SIZE)) {
+        return false;
+    }
+    
+    header.sequence = slot[0] | ((uint32_t)slot[1] << 8) |
+                      ((uint32_t)slot[2] << 16) | ((uint32_t)slot[3] << 24);
+    header.type = slot[4];
+    header.length = slot[5] <= _payloadSize ? slot[5] : _payloadSize;
+    memcpy(payload, slot + PB7200_RECORD_HEADER_SIZE, header.length);
+    return header.sequence != 0;
+}
+
+/**
+ * @brief Read the newest record with a valid CRC
+ */
+bool RecordRing::readLatest(RecordHeader &header, void *payload) {
+    // A torn write only damages the newest slot; fall back to older ones
+    for (uint16_t age = 0; age < _count; age++) {
+        if (read(age, header, payload)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Erase all records
+ */
+bool RecordRing::clear() {
+    if (_storage == nullptr) {
+        return false;
+    }
+    
+    const uint8_t empty[4] = {0, 0, 0, 0};
+    for (uint16_t slot = 0; slot < _slots; slot++) {
+        if (!_storage->write(slotAddress(slot), empty, 4)) {
+            return false;
+        }
+    }
+    
+    _sequence = 0;
+    _head = 0;
+    _count = 0;
+    return _storage->commit();
+}
+
+/**
+ * @brief Get number of used slots
+ */
+uint16_t RecordRing::count() {
+    return _count;
+}
+
+/**
+ * @brief Get sequence number of the newest record
+ */
+uint32_t RecordRing::sequence() {
+    return _sequence;
+}
+
+/**
+ * @brief Check if the ring is mounted
+ */
+bool RecordRing::isMounted() {
+    return _storage != nullptr;
+}
+
+uint32_t RecordRing::slotAddress(uint16_t slot) {
+    return _address + (uint32_t)slot * slotSize();
+}
+
+uint16_t RecordRing::slotSize() {
+    return PB7200_RECORD_HEADER_SIZE + _payloadSize + PB7200_RECORD_CRC_SIZE;
+}
@@ -0,0 +1,208 @@
+/**
+ * @file PB7200Storage.h
+ * @brief Persistent storage interface and wear-leveled record rings
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ * 
+ * Storage is accessed through a small byte-addressed interface so the
+ * same code can run on EEPROM, emulated EEPROM (ESP32/ESP8266), flash
+ * or a file on a host. Records are kept in rings of fixed-size slots:
+ * every append goes to the next slot, which spreads wear evenly, and
+ * each slot carries a sequence number and a CRC.
+ */
+
+#ifndef PB7200STORAGE_H
+#define PB7200STORAGE_H
+
+#include <stdint.h>
+#ifndef ARDUINO
+#include <stdio.h>
+#endif
+
+// Slot header (sequence, type, length) and CRC trailer sizes
+#define PB7200_RECORD_HEADER_SIZE 6
+#define PB7200_RECORD_CRC_SIZE 2
+
+// Largest record payload
+#define PB7200_RECORD_MAX_PAYLOAD 32
+
+/**
+ * @brief Byte-addressed persistent storage
+ */
+class PB7200Storage {
+public:
+    virtual ~PB7200Storage() {}
+
+    /**
+     * @brief Get storage size
+     * @return Size in bytes
+     */
+    virtual uint32_t size() = 0;
+
+    /**
+     * @brief Read bytes
+     * @param address Start address
+     * @param data Buffer to store data
+     * @param length Number of bytes
+     * @return true if successful
+     */
+    virtual bool read(uint32_t address, void *data, uint16_t length) = 0;
+
+    /**
+     * @brief Write bytes
+     * @param address Start address
+     * @param data Data to write
+     * @param length Number of bytes
+     * @return true if successful
+     */
+    virtual bool write(uint32_t address, const void *data, uint16_t length) = 0;
+
+    /**
+     * @brief Make previous writes durable (emulated EEPROM, files)
+     * @return true if successful
+     */
+    virtual bool commit() { return true; }
+};
+
+#ifndef ARDUINO
+/**
+ * @brief Persistent storage in a file, for host testing
+ * 
+ * The file is created (filled with 0xFF like erased EEPROM) or extended
+ * to the requested size.
+ */
+class PB7200FileStorage : public PB7200Storage {
+public:
+    /**
+     * @brief Constructor
+     * @param path File name
+     * @param size Storage size in bytes
+     */
+    PB7200FileStorage(const char *path, uint32_t size);
+    ~PB7200FileStorage();
+
+    /**
+     * @brief Check if the file could be opened
+     * @return true if usable
+     */
+    bool isOpen();
+
+    uint32_t size() override;
+    bool read(uint32_t address, void *data, uint16_t length) override;
+    bool write(uint32_t address, const void *data, uint16_t length) override;
+    bool commit() override;
+
+private:
+    FILE *_file;
+    uint32_t _size;
+};
+#endif
+
+/**
+ * @brief Header of a stored record
+ */
+struct RecordHeader {
+    uint32_t sequence;   // Increments on every append (0 = empty slot)
+    uint8_t type;        // Record type (user defined)
+    uint8_t length;      // Payload length
+};
+
+/**
+ * @brief Ring of fixed-size CRC-protected records
+ */
+class RecordRing {
+public:
+    RecordRing();
+
+    /**
+     * @brief Bytes needed for a ring
+     * @param slots Number of slots
+     * @param payloadSize Payload bytes per slot
+     * @return Size in bytes
+     */
+    static uint32_t footprint(uint16_t slots, uint8_t payloadSize);
+
+    /**
+     * @brief Mount a ring by scanning slot headers only
+     * @param storage Storage backend
+     * @param address Start address of the ring
+     * @param slots Number of slots
+     * @param payloadSize Payload bytes per slot
+     * @return true if successful
+     */
+    bool begin(PB7200Storage *storage, uint32_t address, uint16_t slots, uint8_t payloadSize);
+
+    /**
+     * @brief Append a record to the next slot
+     * @param type Record type
+     * @param payload Payload data
+     * @param length Payload length (up to payloadSize)
+     * @return true if successful
+     */
+    bool append(uint8_t type, const void *payload, uint8_t length);
+
+    /**
+     * @brief Read a record by age
+     * @param age 0 = newest
+     * @param header Header of the record
+     * @param payload Buffer of at least payloadSize bytes
+     * @return true if the slot holds a record with a valid CRC
+     */
+    bool read(uint16_t age, RecordHeader &header, void *payload);
+
+    /**
+     * @brief Read the newest record with a valid CRC
+     * @param header Header of the record
+     * @param payload Buffer of at least payloadSize bytes
+     * @return true if found
+     */
+    bool readLatest(RecordHeader &header, void *payload);
+
+    /**
+     * @brief Erase all records
+     * @return true if successful
+     */
+    bool clear();
+
+    /**
+     * @brief Get number of used slots
+     * @return Record count
+     */
+    uint16_t count();
+
+    /**
+     * @brief Get sequence number of the newest record
+     * @return Sequence (0 if empty)
+     */
+    uint32_t sequence();
+
+    /**
+     * @brief Check if the ring is mounted
+     * @return true if begin() succeeded
+     */
+    bool isMounted();
+
+private:
+    PB7200Storage *_storage;
+    uint32_t _address;
+    uint32_t _sequence;
+    uint16_t _slots;
+    uint16_t _head;       // Next slot to write
+    uint16_t _count;
+    uint8_t _payloadSize;
+
+    uint32_t slotAddress(uint16_t slot);
+    uint16_t slotSize();
+};
+
+/**
+ * @brief CRC-16/CCITT-FALSE
+ * @param data Data
+ * @param length Number of bytes
+ * @param crc Initial value (to chain blocks)
+ * @return CRC
+ */
+uint16_t pb7200Crc16(const void *data, uint16_t length, uint16_t crc = 0xFFFF);
+
+#endif // PB7200STORAGE_H
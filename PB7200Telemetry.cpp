@@ -0,0 +1,300 @@
+/**
+ * @file PB7200Telemetry.cpp
+ * @brief Priority-packed telemetry frames for small radio payloads
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ */
+
+#include "PB7200Telemetry.h"
+
+/**
+ * @brief Store a 16-bit value little-endian
+ */
+static inline void put16(uint8_t *p, uint16_t value) {
+    p[0] = value & 0xFF;
+    p[1] = value >> 8;
+}
+
+/**
+ * @brief Load a 16-bit little-endian value
+ */
+static inline uint16_t get16(const uint8_t *p) {
+    return p[0] | ((uint16_t)p[1] << 8);
+}
+
+// ========== Packer ==========
+
+/**
+ * @brief Constructor
+ */
+PB7200TelemetryPacker::PB7200TelemetryPacker() {
+    reset();
+}
+
+/**
+ * @brief Restart the sequence and channel rotation
+ */
+void PB7200TelemetryPacker::reset() {
+    _sequence = 0;
+    _nextCell = 0;
+    _nextTemp = 0;
+}
+
+/**
+ * @brief Build one frame
+ */
+uint8_t PB7200TelemetryPacker::pack(const PackSnapshot &snapshot, const PackStats &stats,
+                                    uint8_t *frame, uint8_t budget) {
+    if (budget < PB7200_TELEMETRY_HEADER_SIZE) {
+        return 0;
+    }
+
+    uint8_t cellCount = snapshot.cellCount;
+    uint8_t tempCount = snapshot.tempCount;
+    if (_nextCell >= cellCount) {
+        _nextCell = 0;
+    }
+    if (_nextTemp >= tempCount) {
+        _nextTemp = 0;
+    }
+
+    // Faults first: they are part of the header
+    uint8_t sections = 0;
+    frame[0] = PB7200_TELEMETRY_VERSION;
+    frame[1] = _sequence++;
+    frame[2] = cellCount;
+    frame[4] = snapshot.status;
+    frame[5] = snapshot.faultStatus;
+    uint8_t length = PB7200_TELEMETRY_HEADER_SIZE;
+
+    uint32_t totalRaw = 0;
+    for (uint8_t i = 0; i < cellCount; i++) {
+        totalRaw += snapshot.cellRaw[i];
+    }
+
+    // Pack voltage, current and SOC
+    if (budget - length >= PB7200_TELEMETRY_PACK_SIZE) {
+        uint8_t *p = frame + length;
+        uint32_t pack10mV = (totalRaw + 5) / 10;
+        put16(p, pack10mV > 0xFFFF ? 0xFFFF : (uint16_t)pack10mV);
+        put16(p + 2, (uint16_t)snapshot.currentRaw);
+        float soc = stats.soc < 0.0 ? 0.0 : (stats.soc > 100.0 ? 100.0 : stats.soc);
+        p[4] = (uint8_t)(soc * 2.0 + 0.5);
+        length += PB7200_TELEMETRY_PACK_SIZE;
+        sections |= PB7200_TELEMETRY_PACK;
+    }
+
+    // Extreme cells and temperatures, exact
+    if (budget - length >= PB7200_TELEMETRY_EXTREMES_SIZE) {
+        uint8_t *p = frame + length;
+        p[0] = stats.maxCellIndex;
+        put16(p + 1, cellCount ? snapshot.cellRaw[stats.maxCellIndex] : 0);
+        p[3] = stats.minCellIndex;
+        put16(p + 4, cellCount ? snapshot.cellRaw[stats.minCellIndex] : 0);
+        p[6] = (stats.maxTempIndex << 4) | (stats.minTempIndex & 0x0F);
+        put16(p + 7, (uint16_t)(tempCount ? snapshot.tempRaw[stats.maxTempIndex] : 0));
+        put16(p + 9, (uint16_t)(tempCount ? snapshot.tempRaw[stats.minTempIndex] : 0));
+        length += PB7200_TELEMETRY_EXTREMES_SIZE;
+        sections |= PB7200_TELEMETRY_EXTREMES;
+    }
+
+    // Rotating cells as signed steps from the pack mean
+    if (cellCount > 0 && budget - length > PB7200_TELEMETRY_CELLS_HEADER_SIZE) {
+        uint16_t mean = (uint16_t)((totalRaw + cellCount / 2) / cellCount);
+
+        // Smallest step that fits the largest deviation in a signed byte
+        uint16_t spread = 0;
+        for (uint8_t i = 0; i < cellCount; i++) {
+            int32_t deviation = (int32_t)snapshot.cellRaw[i] - mean;
+            uint16_t magnitude = deviation < 0 ? -deviation : deviation;
+            if (magnitude > spread) {
+                spread = magnitude;
+            }
+        }
+        uint16_t step = (spread + 126) / 127;
+        if (step == 0) {
+            step = 1;
+        } else if (step > 255) {
+            step = 255;
+        }
+
+        uint8_t room = budget - length - PB7200_TELEMETRY_CELLS_HEADER_SIZE;
+        uint8_t count = room < cellCount ? room : cellCount;
+
+        uint8_t *p = frame + length;
+        put16(p, mean);
+        p[2] = _nextCell;
+        p[3] = count;
+        p[4] = (uint8_t)step;
+        p += PB7200_TELEMETRY_CELLS_HEADER_SIZE;
+
+        int16_t half = step / 2;
+        for (uint8_t n = 0; n < count; n++) {
+            int32_t deviation = (int32_t)snapshot.cellRaw[_nextCell] - mean;
+            int32_t q = (deviation >= 0 ? deviation + half : deviation - half) / step;
+            p[n] = (uint8_t)(int8_t)(q > 127 ? 127 : (q < -127 ? -127 : q));
+            _nextCell = _nextCell + 1 < cellCount ? _nextCell + 1 : 0;
+        }
+
+        length += PB7200_TELEMETRY_CELLS_HEADER_SIZE + count;
+        sections |= PB7200_TELEMETRY_CELLS;
+    }
+
+    // Rotating temperatures in whole degrees
+    if (tempCount > 0 && budget - length > PB7200_TELEMETRY_TEMPS_HEADER_SIZE) {
+        uint8_t room = budget - length - PB7200_TELEMETRY_TEMPS_HEADER_SIZE;
+        uint8_t count = room < tempCount ? room : tempCount;
+
+        uint8_t *p = frame + length;
+        p[0] = _nextTemp;
+        p[1] = count;
+        p += PB7200_TELEMETRY_TEMPS_HEADER_SIZE;
+
+        for (uint8_t n = 0; n < count; n++) {
+            int16_t raw = snapshot.tempRaw[_nextTemp];
+            int16_t degrees = (raw >= 0 ? raw + 5 : raw - 5) / 10;
+            p[n] = (uint8_t)(int8_t)(degrees > 127 ? 127 : (degrees < -128 ? -128 : degrees));
+            _nextTemp = _nextTemp + 1 < tempCount ? _nextTemp + 1 : 0;
+        }
+
+        length += PB7200_TELEMETRY_TEMPS_HEADER_SIZE + count;
+        sections |= PB7200_TELEMETRY_TEMPS;
+    }
+
+    frame[3] = (tempCount << 4) | sections;
+    return length;
+}
+
+// ========== Decoder ==========
+
+/**
+ * @brief Clear a telemetry view
+ */
+void resetTelemetryView(TelemetryView &view) {
+    uint8_t *bytes = (uint8_t *)&view;
+    for (uint16_t i = 0; i < sizeof(view); i++) {
+        bytes[i] = 0;
+    }
+}
+
+/**
+ * @brief Merge a received frame into a view
+ */
+bool decodeTelemetry(const uint8_t *frame, uint8_t length, TelemetryView &view) {
+    if (length < PB7200_TELEMETRY_HEADER_SIZE || frame[0] != PB7200_TELEMETRY_VERSION) {
+        return false;
+    }
+
+    uint8_t cellCount = frame[2];
+    uint8_t tempCount = frame[3] >> 4;
+    uint8_t sections = frame[3] & 0x0F;
+    if (cellCount > PB7200_MAX_CELLS || tempCount > PB7200_MAX_TEMPS) {
+        return false;
+    }
+
+    // Check that every announced section is complete before touching the view
+    uint8_t offset = PB7200_TELEMETRY_HEADER_SIZE;
+    if (sections & PB7200_TELEMETRY_PACK) {
+        offset += PB7200_TELEMETRY_PACK_SIZE;
+    }
+    if (sections & PB7200_TELEMETRY_EXTREMES) {
+        offset += PB7200_TELEMETRY_EXTREMES_SIZE;
+    }
+    uint8_t cellsOffset = offset;
+    if (sections & PB7200_TELEMETRY_CELLS) {
+        if (offset + PB7200_TELEMETRY_CELLS_HEADER_SIZE > length) {
+            return false;
+        }
+        const uint8_t *p = frame + offset;
+        if (p[2] >= cellCount || p[3] > cellCount || p[4] == 0) {
+            return false;
+        }
+        offset += PB7200_TELEMETRY_CELLS_HEADER_SIZE + p[3];
+    }
+    uint8_t tempsOffset = offset;
+    if (sections & PB7200_TELEMETRY_TEMPS) {
+        if (offset + PB7200_TELEMETRY_TEMPS_HEADER_SIZE > length) {
+            return false;
+        }
+        const uint8_t *p = frame + offset;
+        if (p[0] >= tempCount || p[1] > tempCount) {
+            return false;
+        }
+        offset += PB7200_TELEMETRY_TEMPS_HEADER_SIZE + p[1];
+    }
+    if (offset > length) {
+        return false;
+    }
+
+    if (cellCount != view.cellCount || tempCount != view.tempCount) {
+        resetTelemetryView(view);
+        view.cellCount = cellCount;
+        view.tempCount = tempCount;
+    }
+
+    view.sequence = frame[1];
+    view.sections = sections;
+    view.status = frame[4];
+    view.faultStatus = frame[5];
+    view.cellFresh = 0;
+    view.tempFresh = 0;
+
+    const uint8_t *p = frame + PB7200_TELEMETRY_HEADER_SIZE;
+    if (sections & PB7200_TELEMETRY_PACK) {
+        view.packVoltage10mV = get16(p);
+        view.currentRaw = (int16_t)get16(p + 2);
+        view.socHalfPercent = p[4];
+        p += PB7200_TELEMETRY_PACK_SIZE;
+    }
+
+    if (sections & PB7200_TELEMETRY_EXTREMES) {
+        view.maxCellIndex = p[0];
+        view.maxCellRaw = get16(p + 1);
+        view.minCellIndex = p[3];
+        view.minCellRaw = get16(p + 4);
+        view.maxTempIndex = p[6] >> 4;
+        view.minTempIndex = p[6] & 0x0F;
+        view.maxTempRaw = (int16_t)get16(p + 7);
+        view.minTempRaw = (int16_t)get16(p + 9);
+    }
+
+    if (sections & PB7200_TELEMETRY_CELLS) {
+        p = frame + cellsOffset;
+        int32_t mean = get16(p);
+        uint8_t cell = p[2];
+        uint8_t count = p[3];
+        int32_t step = p[4];
+        p += PB7200_TELEMETRY_CELLS_HEADER_SIZE;
+
+        for (uint8_t n = 0; n < count; n++) {
+            int32_t value = mean + (int8_t)p[n] * step;
+            view.cellRaw[cell] = value < 0 ? 0 : (uint16_t)value;
+            view.cellFresh |= 1UL << cell;
+            cell = cell + 1 < cellCount ? cell + 1 : 0;
+        }
+
+        // Extremes are exact: prefer them over the quantized values
+        if (sections & PB7200_TELEMETRY_EXTREMES) {
+            view.cellRaw[view.maxCellIndex % cellCount] = view.maxCellRaw;
+            view.cellRaw[view.minCellIndex % cellCount] = view.minCellRaw;
+        }
+        view.cellValid |= view.cellFresh;
+    }
+
+    if (sections & PB7200_TELEMETRY_TEMPS) {
+        p = frame + tempsOffset;
+        uint8_t sensor = p[0];
+        uint8_t count = p[1];
+        p += PB7200_TELEMETRY_TEMPS_HEADER_SIZE;
+
+        for (uint8_t n = 0; n < count; n++) {
+            view.tempRaw[sensor] = (int8_t)p[n] * 10;
+            view.tempFresh |= 1 << sensor;
+            sensor = sensor + 1 < tempCount ? sensor + 1 : 0;
+        }
+        view.tempValid |= view.tempFresh;
+    }
+
+    return true;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file PB7200Telemetry.h
+ * @brief Priority-packed telemetry frames for small radio payloads
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * The packer fills a frame of a given byte budget in priority order:
+ * status and faults, pack voltage/current/SOC, extreme cells and
+ * temperatures, then as many cells (relative to the pack mean) and
+ * temperature sensors as still fit. Channels that don't fit are sent
+ * in the following frames, so a receiver rebuilds the whole pack over
+ * a few uplinks. The decoder is Arduino-free and runs on a host.
+ *
+ * Frame layout (little-endian):
+ *   Header   version, sequence, cell count, temp count << 4 | sections,
+ *            status, fault status                              (6 bytes)
+ *   Pack     voltage (10 mV), current (10 mA), SOC (0.5 %)     (5 bytes)
+ *   Extremes max/min cell index + mV, temp indexes, max/min temp (11 bytes)
+ *   Cells    mean mV, first cell, count, step (mV), then one signed
+ *            byte per cell: (cell - mean) / step            (5 + n bytes)
+ *   Temps    first sensor, count, then one signed byte per
+ *            sensor in °C                                   (2 + n bytes)
+ */
+
+#ifndef PB7200TELEMETRY_H
+#define PB7200TELEMETRY_H
+
+#include "PB7200Types.h"
+
+// Frame format version
+#define PB7200_TELEMETRY_VERSION 1
+
+// Section sizes
+#define PB7200_TELEMETRY_HEADER_SIZE 6
+#define PB7200_TELEMETRY_PACK_SIZE 5
+#define PB7200_TELEMETRY_EXTREMES_SIZE 11
+#define PB7200_TELEMETRY_CELLS_HEADER_SIZE 5
+#define PB7200_TELEMETRY_TEMPS_HEADER_SIZE 2
+
+// Section flags (low nibble of header byte 3)
+#define PB7200_TELEMETRY_PACK (1 << 0)
+#define PB7200_TELEMETRY_EXTREMES (1 << 1)
+#define PB7200_TELEMETRY_CELLS (1 << 2)
+#define PB7200_TELEMETRY_TEMPS (1 << 3)
+
+/**
+ * @brief Pack picture rebuilt from telemetry frames
+ */
+struct TelemetryView {
+    uint8_t sequence;         // Sequence of the last frame
+    uint8_t sections;         // Sections in the last frame
+    uint8_t cellCount;        // Number of cells
+    uint8_t tempCount;        // Number of temperature sensors
+    uint8_t status;           // Status register
+    uint8_t faultStatus;      // Fault register
+    uint16_t packVoltage10mV; // Pack voltage (10 mV)
+    int16_t currentRaw;       // Current (10 mA)
+    uint8_t socHalfPercent;   // State of charge (0.5 %)
+    uint8_t maxCellIndex;     // Cell with highest voltage
+    uint8_t minCellIndex;     // Cell with lowest voltage
+    uint16_t maxCellRaw;      // Highest cell voltage (mV, exact)
+    uint16_t minCellRaw;      // Lowest cell voltage (mV, exact)
+    uint8_t maxTempIndex;     // Sensor with highest temperature
+    uint8_t minTempIndex;     // Sensor with lowest temperature
+    int16_t maxTempRaw;       // Highest temperature (0.1 °C)
+    int16_t minTempRaw;       // Lowest temperature (0.1 °C)
+    uint16_t cellRaw[PB7200_MAX_CELLS];  // Cell voltages (mV, within step / 2)
+    int16_t tempRaw[PB7200_MAX_TEMPS];   // Temperatures (0.1 °C, within 0.5 °C)
+    uint32_t cellValid;       // Cells received at least once
+    uint32_t cellFresh;       // Cells received in the last frame
+    uint8_t tempValid;        // Sensors received at least once
+    uint8_t tempFresh;        // Sensors received in the last frame
+};
+
+/**
+ * @brief Fills telemetry frames in priority order
+ */
+class PB7200TelemetryPacker {
+public:
+    /**
+     * @brief Constructor
+     */
+    PB7200TelemetryPacker();
+
+    /**
+     * @brief Restart the sequence and channel rotation
+     */
+    void reset();
+
+    /**
+     * @brief Build one frame
+     * @param snapshot Raw snapshot
+     * @param stats Statistics of the same snapshot
+     * @param frame Buffer to store the frame
+     * @param budget Maximum frame size in bytes
+     * @return Frame length (0 if budget is below the header size)
+     */
+    uint8_t pack(const PackSnapshot &snapshot, const PackStats &stats,
+                 uint8_t *frame, uint8_t budget);
+
+private:
+    uint8_t _sequence;
+    uint8_t _nextCell;
+    uint8_t _nextTemp;
+};
+
+/**
+ * @brief Clear a telemetry view
+ * @param view View to clear
+ */
+void resetTelemetryView(TelemetryView &view);
+
+/**
+ * @brief Merge a received frame into a view
+ *
+ * Fields of sections missing from the frame keep their previous value.
+ * A change of cell or sensor count clears the view first.
+ *
+ * @param frame Received frame
+ * @param length Frame length
+ * @param view View to update
+ * @return true if the frame was valid
+ */
+bool decodeTelemetry(const uint8_t *frame, uint8_t length, TelemetryView &view);
+
+#endif // PB7200TELEMETRY_H
@@ -0,0 +1,51 @@
+/**
+ * @file PB7200Transport.h
+ * @brief Register transport interface
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * The driver reaches the chip's registers through Wire by default. A
+ * transport replaces that path with anything that can read and write
+ * register ranges: a bus shared with other code, a bridge chip, or a
+ * simulated chip on a host.
+ */
+
+#ifndef PB7200TRANSPORT_H
+#define PB7200TRANSPORT_H
+
+#include <stdint.h>
+
+/**
+ * @brief Register-level access to one chip
+ */
+class PB7200Transport {
+public:
+    virtual ~PB7200Transport() {}
+
+    /**
+     * @brief Prepare the bus, called from begin()
+     * @return true if successful
+     */
+    virtual bool begin() { return true; }
+
+    /**
+     * @brief Write consecutive registers
+     * @param reg First register
+     * @param values Values to write
+     * @param length Number of registers
+     * @return true if the chip acknowledged every byte
+     */
+    virtual bool write(uint8_t reg, const uint8_t *values, uint8_t length) = 0;
+
+    /**
+     * @brief Read consecutive registers
+     * @param reg First register
+     * @param values Buffer for the values
+     * @param length Number of registers
+     * @return true if all length bytes were received
+     */
+    virtual bool read(uint8_t reg, uint8_t *values, uint8_t length) = 0;
+};
+
+#endif // PB7200TRANSPORT_H
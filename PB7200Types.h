@@ -0,0 +1,247 @@
+/**
+ * @file PB7200Types.h
+ * @brief Data types shared by the PB7200P80 driver and its kernels
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ * 
+ * Plain data structures and constants with no Arduino dependency, so
+ * snapshots can also be processed by host-side tools.
+ */
+
+#ifndef PB7200TYPES_H
+#define PB7200TYPES_H
+
+#include <stdint.h>
+
+// Constants
+#define PB7200_MAX_CELLS 20
+#define PB7200_MAX_TEMPS 8
+#define PB7200_VOLTAGE_LSB 0.001  // 1mV per bit
+#define PB7200_CURRENT_LSB 0.01   // 10mA per bit
+#define PB7200_TEMP_LSB 0.1       // 0.1°C per bit
+
+// Status bits
+#define PB7200_STATUS_OVP    (1 << 0)  // Overvoltage
+#define PB7200_STATUS_UVP    (1 << 1)  // Undervoltage
+#define PB7200_STATUS_OCP    (1 << 2)  // Overcurrent
+#define PB7200_STATUS_OTP    (1 << 3)  // Overtemperature
+#define PB7200_STATUS_UTP    (1 << 4)  // Undertemperature
+#define PB7200_STATUS_BALANCING (1 << 5)  // Balancing active
+#define PB7200_STATUS_CHARGING  (1 << 6)  // Charging
+#define PB7200_STATUS_READY     (1 << 7)  // Ready
+
+// Lifetime extreme records
+enum PB7200_RecordType {
+    PB7200_RECORD_MAX_CELL_VOLTAGE = 0,
+    PB7200_RECORD_MIN_CELL_VOLTAGE = 1,
+    PB7200_RECORD_MAX_TEMP = 2,
+    PB7200_RECORD_MIN_TEMP = 3,
+    PB7200_RECORD_MAX_CURRENT = 4,
+    PB7200_RECORD_MIN_CURRENT = 5,
+    PB7200_RECORD_COUNT = 6
+};
+
+// Black-box event types
+enum PB7200_EventType {
+    PB7200_EVENT_BOOT = 1,            // begin() completed (data: cell count)
+    PB7200_EVENT_RESET = 2,           // reset() requested
+    PB7200_EVENT_FAULT = 3,           // Fault bits changed (data: new | old << 8)
+    PB7200_EVENT_FAULTS_CLEARED = 4,  // clearFaults() (data: faults before)
+    PB7200_EVENT_COMM_LOST = 5,       // First failed acquisition
+    PB7200_EVENT_COMM_RESTORED = 6,   // Acquisition works again (data: seconds lost)
+    PB7200_EVENT_CONFIG_CHANGE = 7,   // Protection config written
+    PB7200_EVENT_BALANCE_START = 8,   // Balancing started (data: cell mask)
+    PB7200_EVENT_BALANCE_STOP = 9,    // Balancing stopped (data: duration in s)
+    PB7200_EVENT_BUS_RECOVERY = 10    // Bus restarted (data: failed updates before)
+};
+
+/**
+ * @brief Structure to store cell data
+ */
+struct CellData {
+    float voltage;      // Voltage in volts
+    bool balancing;     // If being balanced
+    bool overvoltage;   // Overvoltage detected
+    bool undervoltage;  // Undervoltage detected
+};
+
+/**
+ * @brief Structure to store protection configuration
+ */
+struct ProtectionConfig {
+    float overVoltageThreshold;     // Overvoltage threshold (V)
+    float underVoltageThreshold;    // Undervoltage threshold (V)
+    float overCurrentThreshold;     // Overcurrent threshold (A)
+    float overTempThreshold;        // Overtemperature threshold (°C)
+    float underTempThreshold;       // Undertemperature threshold (°C)
+    uint16_t overVoltageDelay;      // Overvoltage delay (ms)
+    uint16_t underVoltageDelay;     // Undervoltage delay (ms)
+    uint16_t overCurrentDelay;      // Overcurrent delay (ms)
+};
+
+/**
+ * @brief Raw register values from a single acquisition
+ * 
+ * Cells and sensors are stored in logical order; unused channels
+ * are not part of the snapshot.
+ */
+struct PackSnapshot {
+    uint16_t cellRaw[PB7200_MAX_CELLS];  // Cell voltages (1mV per bit)
+    int16_t tempRaw[PB7200_MAX_TEMPS];   // Temperatures (0.1°C per bit)
+    int16_t currentRaw;                  // Current (10mA per bit)
+    uint8_t status;                      // Status register
+    uint8_t faultStatus;                 // Fault register
+    uint32_t balanceMask;                // Cells being balanced (bit = logical cell)
+    uint32_t timestamp;                  // millis() when read completed
+    uint16_t sequence;                   // Incremented on every snapshot
+    uint8_t cellCount;                   // Valid entries in cellRaw
+    uint8_t tempCount;                   // Valid entries in tempRaw
+    bool coherent;                       // All values from one triggered conversion
+};
+
+/**
+ * @brief Structure for pack statistics
+ */
+struct PackStats {
+    float totalVoltage;      // Total pack voltage
+    float maxCellVoltage;    // Maximum cell voltage
+    float minCellVoltage;    // Minimum cell voltage
+    float avgCellVoltage;    // Average cell voltage
+    float voltageDelta;      // Max-min difference
+    uint8_t maxCellIndex;    // Index of cell with highest voltage
+    uint8_t minCellIndex;    // Index of cell with lowest voltage
+    float current;           // Current (A)
+    float power;             // Power (W)
+    float maxTemp;           // Maximum temperature
+    float minTemp;           // Minimum temperature
+    uint8_t maxTempIndex;    // Index of sensor with highest temperature
+    uint8_t minTempIndex;    // Index of sensor with lowest temperature
+    
+    // Each channel is one parallel group of parallelCount cells
+    uint8_t parallelCount;   // Cells in parallel per group
+    float cellCurrent;       // Current per cell in a group (A)
+    float soc;               // State of charge (%)
+    float remainingAh;       // Remaining capacity of a group (= pack) (Ah)
+    float cellRemainingAh;   // Remaining capacity per cell in a group (Ah)
+    float remainingWh;       // Remaining pack energy estimate (Wh)
+    float energyWh;          // Net energy since counters were reset (Wh)
+    float balanceCurrent;    // Total bleed current of balancing groups (A)
+    uint8_t balancingCount;  // Number of groups being balanced
+    float balancedAh;        // Charge bled by balancing, all groups (Ah)
+};
+
+/**
+ * @brief Integer results of the statistics accumulation pass
+ */
+struct PackSums {
+    uint32_t totalRaw;       // Sum of cell counts
+    uint32_t balanceRaw;     // Sum of counts of balancing cells
+    uint16_t maxRaw;         // Highest cell (0 without cells)
+    uint16_t minRaw;         // Lowest cell (0 without cells)
+    int16_t maxTempRaw;      // Highest sensor (0 without sensors)
+    int16_t minTempRaw;      // Lowest sensor (0 without sensors)
+    uint8_t maxCellIndex;    // First cell holding maxRaw
+    uint8_t minCellIndex;    // First cell holding minRaw
+    uint8_t maxTempIndex;    // First sensor holding maxTempRaw
+    uint8_t minTempIndex;    // First sensor holding minTempRaw
+    uint8_t balancingCount;  // Cells being balanced
+};
+
+/**
+ * @brief Order statistics of one snapshot (insensitive to single outliers)
+ */
+struct RobustStats {
+    float medianCellVoltage; // Median cell voltage (V)
+    float q1CellVoltage;     // 25th percentile cell voltage (V)
+    float q3CellVoltage;     // 75th percentile cell voltage (V)
+    float iqrCellVoltage;    // Interquartile range (V)
+    float medianTemp;        // Median temperature (°C)
+    float q1Temp;            // 25th percentile temperature (°C)
+    float q3Temp;            // 75th percentile temperature (°C)
+    float iqrTemp;           // Interquartile range (°C)
+};
+
+/**
+ * @brief Pack layout for xSyP packs
+ */
+struct PackConfig {
+    uint8_t parallelCount;      // Cells in parallel per channel (P)
+    float groupCapacityAh;      // Capacity of one parallel group (Ah)
+    float balanceResistance;    // Bleed resistor per channel (ohm, 0 = unknown)
+};
+
+/**
+ * @brief Charge and energy integrators
+ */
+struct PackCounters {
+    int64_t chargeUAs;       // Remaining charge of a group (µA·s)
+    int64_t energyUWs;       // Net energy into the pack (µW·s)
+    int64_t balanceUAs;      // Charge bled by balancing, all groups (µA·s)
+    uint32_t timestamp;      // Snapshot time of last integration
+    bool started;            // timestamp is valid
+};
+
+/**
+ * @brief Lifetime extreme value
+ */
+struct LifetimeRecord {
+    int32_t raw;          // Value in register counts
+    uint32_t timestamp;   // Time source (s) when recorded
+    uint8_t index;        // Cell or sensor index (0xFF = no record yet)
+};
+
+/**
+ * @brief Entry of the black-box event log
+ */
+struct EventRecord {
+    uint32_t sequence;    // Log sequence number
+    uint32_t timestamp;   // Time source (s)
+    uint32_t data;        // Event specific value
+    uint8_t type;         // PB7200_EventType
+};
+
+/**
+ * @brief Cell order maintained across snapshots
+ */
+struct CellRanking {
+    uint8_t order[PB7200_MAX_CELLS];  // Logical cells, lowest voltage first
+    uint8_t count;                    // Valid entries in order
+};
+
+/**
+ * @brief Streaming per-cell anomaly state
+ * 
+ * Each cell's deviation from the pack mean is compared with its own
+ * running (Welford) mean, and the residual is normalized by a running
+ * variance pooled over all cells. Statistics turn exponential once
+ * window samples have been seen; the 16 fractional bits keep them
+ * adapting to changes well below 1 mV at the default window.
+ */
+struct AnomalyState {
+    int32_t meanQ16[PB7200_MAX_CELLS]; // Mean deviation from pack (mV × 65536)
+    uint16_t score[PB7200_MAX_CELLS];  // Smoothed z² (× 256)
+    uint32_t varQ16;                   // Pooled residual variance (mV² × 65536)
+    uint16_t count;                    // Samples seen (capped at window)
+    uint16_t window;                   // Running-stats window (samples)
+    uint16_t alarmLevel;               // Alarm threshold on score (z² × 256)
+    uint32_t alarmMask;                // Cells above alarm level
+    uint8_t cellCount;                 // Cells tracked
+};
+
+/**
+ * @brief update() latency and bus error counters
+ */
+struct UpdateTiming {
+    uint32_t updates;        // update() calls
+    uint32_t failures;       // update() calls that failed
+    uint32_t retries;        // Register transfers repeated after an error
+    uint16_t recoveries;     // Bus restarts after repeated failures
+    uint16_t rejectedFaults; // New fault bits not seen again on a second read
+    uint32_t lastUs;         // Duration of the last update() (µs)
+    uint32_t minUs;          // Shortest update() (µs)
+    uint32_t maxUs;          // Longest update() (µs)
+    float meanUs;            // Mean update() duration (µs)
+};
+
+#endif // PB7200TYPES_H
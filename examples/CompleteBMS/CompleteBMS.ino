@@ -21,6 +21,7 @@
  */
 
 #include <PB7200P80.h>
+#include <PB7200Format.h>
 
 PB7200P80 bms(PB7200_INTERFACE_I2C, 0x55);
 
@@ -197,17 +198,19 @@ void showQuickStatus() {
   }
   
   Serial.println(F("─────────────────────────────────────────"));
-  Serial.print(F("Pack: "));
-  Serial.print(stats.totalVoltage, 2);
-  Serial.print(F("V │ "));
-  Serial.print(stats.current, 2);
-  Serial.print(F("A │ "));
-  Serial.print(stats.power, 1);
-  Serial.print(F("W │ Δ:"));
-  Serial.print(stats.voltageDelta * 1000, 0);
-  Serial.print(F("mV │ "));
-  Serial.print(stats.maxTemp, 0);
-  Serial.println(F("°C"));
+  PB7200LineBuffer line;
+  line.appendFlash(PSTR("Pack: "));
+  line.appendFixed(pb7200ToFixed(stats.totalVoltage, 2), 2);
+  line.appendFlash(PSTR("V │ "));
+  line.appendFixed(pb7200ToFixed(stats.current, 2), 2);
+  line.appendFlash(PSTR("A │ "));
+  line.appendFixed(pb7200ToFixed(stats.power, 1), 1);
+  line.appendFlash(PSTR("W │ Δ:"));
+  line.appendFixed(pb7200ToFixed(stats.voltageDelta * 1000, 0), 0);
+  line.appendFlash(PSTR("mV │ "));
+  line.appendFixed(pb7200ToFixed(stats.maxTemp, 0), 0);
+  line.appendFlash(PSTR("°C\r\n"));
+  Serial.write((const uint8_t *)line.c_str(), line.length());
 }
 
 void showCompleteStats() {
@@ -273,18 +276,20 @@ void showCompleteStats() {
 }
 
 void printValue(float value, uint8_t decimals, const char* unit) {
-  char buffer[20];
-  dtostrf(value, 6, decimals, buffer);
-  Serial.print(buffer);
-  Serial.print(" ");
-  Serial.print(unit);
+  // Integer digit extraction instead of dtostrf, right-aligned to 6
+  char digits[PB7200_FORMAT_MAX];
+  uint8_t len = pb7200FormatFixed(digits, pb7200ToFixed(value, decimals), decimals);
   
-  // Preenche espaços
-  int len = strlen(buffer) + strlen(unit) + 1;
-  for (int i = len; i < 19; i++) {
-    Serial.print(" ");
-  }
-  Serial.println("│");
+  PB7200LineBuffer line;
+  line.padTo(len < 6 ? 6 - len : 0);
+  line.append(digits);
+  line.appendChar(' ');
+  line.append(unit);
+  
+  // Fill up to the box border, then send the whole line at once
+  line.padTo(19);
+  line.append("│\r\n");
+  Serial.write((const uint8_t *)line.c_str(), line.length());
 }
 
 void checkCriticalAlerts() {
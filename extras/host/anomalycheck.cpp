@@ -0,0 +1,223 @@
+/**
+ * @file anomalycheck.cpp
+ * @brief Check that anomaly statistics keep adapting after warm-up
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Feeds computePackStats() synthetic 4-cell snapshots with integer noise
+ * and checks the running statistics against what was fed in:
+ *
+ *   drift   one cell drifts 9 mV over 100k samples; the healthy cells
+ *           must never be flagged as the pack mean moves under them
+ *   step    one cell steps by 10 mV; its offset must be absorbed at the
+ *           rate of the window (63 % after one window, 98 % after four)
+ *   noise   the noise doubles; the pooled variance must follow within
+ *           four windows
+ *
+ * Exits with status 1 if any check fails.
+ *
+ * Build from the library root:
+ *   g++ -std=c++11 -O2 -I. extras/host/anomalycheck.cpp PB7200Stats.cpp \
+ *       -o anomalycheck
+ *
+ * Usage:
+ *   ./anomalycheck [-w window] [-R seed]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <random>
+
+#include "PB7200Stats.h"
+
+#define CHECK_CELLS 4
+#define CHECK_BASE_MV 3700
+#define CHECK_ALARM_Z 4.0f
+
+// Samples before a scenario changes anything
+#define CHECK_WARMUP_WINDOWS 5
+
+/**
+ * @brief Synthetic pack fed to the statistics kernel
+ */
+struct Pack {
+    PackConfig config;
+    PackCounters counters;
+    AnomalyState anomaly;
+    std::mt19937 random;
+    double offset[CHECK_CELLS];   // Added to each cell (mV)
+    int noise;                    // Noise is uniform in ±noise (mV)
+    uint32_t samples;
+    uint32_t falseAlarms;         // Samples with a healthy cell flagged
+    uint32_t healthyMask;
+};
+
+static void initPack(Pack &pack, uint16_t window, uint32_t seed) {
+    pack.config.parallelCount = 1;
+    pack.config.groupCapacityAh = 50.0f;
+    pack.config.balanceResistance = 0.0f;
+    pack.counters = PackCounters();
+    resetAnomaly(pack.anomaly, window, CHECK_ALARM_Z);
+    pack.random.seed(seed);
+    for (uint8_t i = 0; i < CHECK_CELLS; i++) {
+        pack.offset[i] = 0.0;
+    }
+    pack.noise = 2;
+    pack.samples = 0;
+    pack.falseAlarms = 0;
+    pack.healthyMask = (1UL << CHECK_CELLS) - 1;
+}
+
+/**
+ * @brief Run one snapshot through computePackStats()
+ */
+static void step(Pack &pack) {
+    std::uniform_int_distribution<int> noise(-pack.noise, pack.noise);
+    PackSnapshot snapshot = PackSnapshot();
+    snapshot.cellCount = CHECK_CELLS;
+    snapshot.timestamp = pack.samples * 100;
+    for (uint8_t i = 0; i < CHECK_CELLS; i++) {
+        snapshot.cellRaw[i] = (uint16_t)lround(CHECK_BASE_MV + pack.offset[i] + noise(pack.random));
+    }
+
+    PackStats stats;
+    computePackStats(snapshot, pack.config, pack.counters, stats, &pack.anomaly);
+    pack.samples++;
+    if (pack.anomaly.alarmMask & pack.healthyMask) {
+        pack.falseAlarms++;
+    }
+}
+
+/**
+ * @brief Tracked offset of a cell from the pack mean (mV)
+ */
+static double trackedOffset(const Pack &pack, uint8_t cell) {
+    return pack.anomaly.meanQ16[cell] / 65536.0;
+}
+
+/**
+ * @brief True offset of a cell from the pack mean (mV)
+ */
+static double trueOffset(const Pack &pack, uint8_t cell) {
+    double mean = 0.0;
+    for (uint8_t i = 0; i < CHECK_CELLS; i++) {
+        mean += pack.offset[i];
+    }
+    return pack.offset[cell] - mean / CHECK_CELLS;
+}
+
+static bool report(const char *name, bool ok, const char *detail) {
+    printf("%-6s %-4s %s\n", name, ok ? "ok" : "FAIL", detail);
+    return ok;
+}
+
+/**
+ * @brief Healthy cells stay quiet while another cell drifts slowly
+ */
+static bool checkDrift(uint16_t window, uint32_t seed) {
+    static Pack pack;
+    initPack(pack, window, seed);
+    for (uint32_t n = 0; n < CHECK_WARMUP_WINDOWS * (uint32_t)window; n++) {
+        step(pack);
+    }
+
+    pack.healthyMask &= ~(1UL << 2);
+    const uint32_t samples = 100000;
+    for (uint32_t n = 0; n < samples; n++) {
+        pack.offset[2] = 9.0 * n / samples;
+        step(pack);
+    }
+
+    char detail[128];
+    snprintf(detail, sizeof(detail),
+             "healthy cells flagged in %u of %u samples, cell 0 offset %.2f mV (true %.2f)",
+             pack.falseAlarms, samples, trackedOffset(pack, 0), trueOffset(pack, 0));
+    return report("drift", pack.falseAlarms == 0 &&
+                  fabs(trackedOffset(pack, 0) - trueOffset(pack, 0)) < 0.5, detail);
+}
+
+/**
+ * @brief A step in one cell's offset is absorbed at the window's rate
+ */
+static bool checkStep(uint16_t window, uint32_t seed) {
+    static Pack pack;
+    initPack(pack, window, seed);
+    for (uint32_t n = 0; n < CHECK_WARMUP_WINDOWS * (uint32_t)window; n++) {
+        step(pack);
+    }
+
+    const double stepMv = 10.0;
+    double before = trackedOffset(pack, 2);
+    pack.offset[2] = stepMv;
+    double target = trueOffset(pack, 2);
+    double absorbed[4];
+    for (uint8_t w = 0; w < 4; w++) {
+        for (uint32_t n = 0; n < window; n++) {
+            step(pack);
+        }
+        absorbed[w] = (trackedOffset(pack, 2) - before) / (target - before);
+    }
+
+    char detail[128];
+    snprintf(detail, sizeof(detail), "absorbed after 1-4 windows: %.0f %% %.0f %% %.0f %% %.0f %%",
+             100 * absorbed[0], 100 * absorbed[1], 100 * absorbed[2], 100 * absorbed[3]);
+    return report("step", absorbed[0] > 0.55 && absorbed[3] > 0.95, detail);
+}
+
+/**
+ * @brief The pooled variance follows a change in noise
+ */
+static bool checkNoise(uint16_t window, uint32_t seed) {
+    static Pack pack;
+    initPack(pack, window, seed);
+    for (uint32_t n = 0; n < CHECK_WARMUP_WINDOWS * (uint32_t)window; n++) {
+        step(pack);
+    }
+    double before = pack.anomaly.varQ16 / 65536.0;
+
+    // Uniform ±n has variance n(n+1)/3; residuals lose the pack mean's share
+    pack.noise = 4;
+    double expected = 4 * 5 / 3.0 * (CHECK_CELLS - 1) / CHECK_CELLS;
+    for (uint32_t n = 0; n < 4 * (uint32_t)window; n++) {
+        step(pack);
+    }
+    double after = pack.anomaly.varQ16 / 65536.0;
+
+    char detail[128];
+    snprintf(detail, sizeof(detail), "variance %.2f -> %.2f mV² (expected %.2f)", before, after,
+             expected);
+    return report("noise", fabs(after - expected) < 0.1 * expected, detail);
+}
+
+static void usage(const char *name) {
+    fprintf(stderr, "usage: %s [-w window] [-R seed]\n", name);
+}
+
+int main(int argc, char **argv) {
+    uint16_t window = 4096;
+    uint32_t seed = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "w:R:")) != -1) {
+        switch (opt) {
+            case 'w': window = (uint16_t)atoi(optarg); break;
+            case 'R': seed = (uint32_t)atoi(optarg); break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if (window < 16) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    printf("window %u, %u cells, ±2 mV noise, alarm at z = %.1f\n", window, CHECK_CELLS,
+           CHECK_ALARM_Z);
+    bool ok = checkDrift(window, seed);
+    ok = checkStep(window, seed) && ok;
+    ok = checkNoise(window, seed) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file Arduino.cpp
+ * @brief Minimal Arduino core for building the driver on a host
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ */
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+static thread_local ArduinoClock *boundClock = nullptr;
+
+/**
+ * @brief Use a simulated clock on the calling thread
+ */
+void arduinoBindClock(ArduinoClock *clock) {
+    boundClock = clock;
+}
+
+/**
+ * @brief Move the bound clock forward
+ */
+void arduinoAdvance(uint64_t us) {
+    ArduinoClock *clock = boundClock;
+    if (clock == nullptr) {
+        return;
+    }
+    clock->us += us;
+    if (clock->advance != nullptr) {
+        clock->advance(clock->context, clock->us);
+    }
+}
+
+/**
+ * @brief Current time (µs), simulated or monotonic
+ */
+static uint64_t nowUs() {
+    if (boundClock != nullptr) {
+        return boundClock->us;
+    }
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+unsigned long millis() {
+    return (unsigned long)(uint32_t)(nowUs() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)(uint32_t)nowUs();
+}
+
+void delay(unsigned long ms) {
+    if (boundClock != nullptr) {
+        arduinoAdvance((uint64_t)ms * 1000);
+    } else {
+        usleep((useconds_t)(ms * 1000));
+    }
+}
+
+void delayMicroseconds(unsigned int us) {
+    if (boundClock != nullptr) {
+        arduinoAdvance(us);
+    } else if (us > 0) {
+        usleep(us);
+    }
+}
+
+void yield() {
+    arduinoAdvance(ARDUINO_YIELD_US);
+}
+
+// ========== Print ==========
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (n < size && write(buffer[n])) {
+        n++;
+    }
+    return n;
+}
+
+// Number and float printing follow the Arduino core's Print.cpp, so host
+// timings of print(float) reflect the algorithm used on the board
+
+size_t Print::print(long value, int base) {
+    if (base == DEC && value < 0) {
+        return print('-') + print((unsigned long)-value, base);
+    }
+    return print((unsigned long)value, base);
+}
+
+size_t Print::print(unsigned long value, int base) {
+    char text[8 * sizeof(long) + 1];
+    char *digit = &text[sizeof(text) - 1];
+    *digit = '\0';
+    if (base < 2) {
+        base = DEC;
+    }
+    do {
+        char c = (char)(value % base);
+        value /= base;
+        *--digit = c < 10 ? c + '0' : c + 'A' - 10;
+    } while (value);
+    return write(digit);
+}
+
+size_t Print::print(double value, int digits) {
+    if (isnan(value)) {
+        return print("nan");
+    }
+    if (isinf(value)) {
+        return print("inf");
+    }
+    if (value > 4294967040.0 || value < -4294967040.0) {
+        return print("ovf");
+    }
+
+    size_t n = 0;
+    if (value < 0.0) {
+        n += print('-');
+        value = -value;
+    }
+    double rounding = 0.5;
+    for (int i = 0; i < digits; i++) {
+        rounding /= 10.0;
+    }
+    value += rounding;
+
+    // Integer part, then one print per decimal digit
+    unsigned long whole = (unsigned long)value;
+    double remainder = value - (double)whole;
+    n += print(whole);
+    if (digits > 0) {
+        n += print('.');
+    }
+    while (digits-- > 0) {
+        remainder *= 10.0;
+        unsigned int digit = (unsigned int)remainder;
+        n += print(digit);
+        remainder -= digit;
+    }
+    return n;
+}
+
+// ========== Serial ==========
+
+size_t HardwareSerial::write(uint8_t c) {
+    _writes++;
+    _bytes++;
+    return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+    _writes++;
+    _bytes += size;
+    return fwrite(buffer, 1, size, stdout);
+}
+
+void HardwareSerial::flush() {
+    fflush(stdout);
+}
@@ -0,0 +1,139 @@
+/**
+ * @file Arduino.h
+ * @brief Minimal Arduino core for building the driver on a host
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Just enough of the core for PB7200P80.cpp: timing, Print and Serial
+ * (to stdout). Put this directory first on the include path.
+ *
+ * Time comes from the monotonic clock unless the calling thread has
+ * bound an ArduinoClock; then millis() and micros() read it, and
+ * delay() and yield() move it forward. Simulators bind one clock per
+ * device, so a driver waiting on its chip advances only that chip.
+ */
+
+#ifndef PB7200_HOST_ARDUINO_H
+#define PB7200_HOST_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HEX 16
+#define DEC 10
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+template <class T> inline T min(T a, T b) { return b < a ? b : a; }
+template <class T> inline T max(T a, T b) { return a < b ? b : a; }
+
+// Time the clock moves on each yield() (µs)
+#define ARDUINO_YIELD_US 20
+
+/**
+ * @brief Simulated time of one device
+ */
+struct ArduinoClock {
+    uint64_t us;                                 // Current time (µs)
+    void (*advance)(void *context, uint64_t us); // Called after time moved (optional)
+    void *context;                               // Passed to advance
+};
+
+/**
+ * @brief Use a simulated clock on the calling thread
+ * @param clock Clock, nullptr for the monotonic clock
+ */
+void arduinoBindClock(ArduinoClock *clock);
+
+/**
+ * @brief Move the bound clock forward (no effect on the monotonic clock)
+ * @param us Time to add (µs)
+ */
+void arduinoAdvance(uint64_t us);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+/**
+ * @brief Character output
+ */
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *text) { return write((const uint8_t *)text, strlen(text)); }
+    size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+
+    size_t print(const __FlashStringHelper *text) { return write((const char *)text); }
+    size_t print(const char *text) { return write(text); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println() { return write("\r\n"); }
+    template <class T> size_t println(T value) { return print(value) + println(); }
+    template <class T> size_t println(T value, int format) {
+        return print(value, format) + println();
+    }
+
+    virtual void flush() {}
+};
+
+/**
+ * @brief Character input and output
+ */
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+/**
+ * @brief Serial port, writing to stdout and never receiving
+ *
+ * Counts write() calls and bytes, so benchmarks can see how output is
+ * chunked as well as how much there is.
+ */
+class HardwareSerial : public Stream {
+public:
+    HardwareSerial() : _writes(0), _bytes(0) {}
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    void flush() override;
+    operator bool() { return true; }
+    unsigned long writeCount() const { return _writes; }
+    unsigned long byteCount() const { return _bytes; }
+
+private:
+    unsigned long _writes;
+    unsigned long _bytes;
+};
+
+extern HardwareSerial Serial;
+
+#endif // PB7200_HOST_ARDUINO_H
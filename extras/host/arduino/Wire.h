@@ -0,0 +1,38 @@
+/**
+ * @file Wire.h
+ * @brief I2C stub for building the driver on a host
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * There is no bus on a host: every transfer fails. Give the driver a
+ * PB7200Transport (for example PB7200SimChip) instead.
+ */
+
+#ifndef PB7200_HOST_WIRE_H
+#define PB7200_HOST_WIRE_H
+
+#include "Arduino.h"
+
+#define BUFFER_LENGTH 32
+
+/**
+ * @brief I2C master that is never connected
+ */
+class TwoWire : public Stream {
+public:
+    void begin() {}
+    void setClock(uint32_t) {}
+    void beginTransmission(uint8_t) {}
+    uint8_t endTransmission(bool = true) { return 2; }
+    uint8_t requestFrom(uint8_t, uint8_t) { return 0; }
+    size_t write(uint8_t) override { return 0; }
+    using Print::write;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+};
+
+extern TwoWire Wire;
+
+#endif // PB7200_HOST_WIRE_H
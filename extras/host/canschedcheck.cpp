@@ -0,0 +1,293 @@
+/**
+ * @file canschedcheck.cpp
+ * @brief Check CAN frame spacing and contents from PB7200CanScheduler
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Drives a PB7200CanScheduler into a PB7200CanMemorySink on a simulated
+ * millisecond clock and checks what comes out:
+ *
+ *   steady   polled every millisecond, every cycle carries each slot
+ *            once, in order, one slot spacing apart
+ *   stall    polling stops part way through a cycle; after it resumes
+ *            no poll sends more than one frame, frames keep at least one
+ *            slot spacing and no slot is skipped
+ *   contents one cycle is decoded and compared with the snapshot
+ *
+ * Exits with status 1 if any check fails.
+ *
+ * Build from the library root:
+ *   g++ -std=c++11 -O2 -I. extras/host/canschedcheck.cpp PB7200CAN.cpp -o canschedcheck
+ *
+ * Usage:
+ *   ./canschedcheck [-p period ms] [-s cells] [-a stall start ms] [-b stall end ms]
+ *
+ * The period must allow at least a millisecond per frame.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "PB7200CAN.h"
+
+/**
+ * @brief A frame and the poll that sent it
+ */
+struct Sent {
+    uint32_t ms;
+    uint8_t slot;
+    CanFrame frame;
+};
+
+/**
+ * @brief Scheduler, sink and everything sent so far
+ */
+struct Bench {
+    PB7200CanMemorySink sink;
+    PB7200CanScheduler scheduler;
+    PackSnapshot snapshot;
+    std::vector<Sent> sent;
+    uint8_t frames;
+    uint8_t maxPerPoll;
+
+    Bench(uint32_t period) : scheduler(sink, period), snapshot(), frames(0), maxPerPoll(0) {}
+};
+
+static uint16_t get16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+}
+
+/**
+ * @brief Slot a frame was encoded from
+ */
+static uint8_t slotOf(const CanFrame &frame) {
+    uint8_t message = frame.id - PB7200_CAN_BASE_ID;
+    return message < PB7200_CAN_CELLS ? message : (uint8_t)(PB7200_CAN_CELLS + frame.data[0]);
+}
+
+static void initBench(Bench &bench, uint8_t cells) {
+    PackSnapshot &s = bench.snapshot;
+    s.cellCount = cells;
+    s.tempCount = 4;
+    for (uint8_t i = 0; i < cells; i++) {
+        s.cellRaw[i] = 3600 + 7 * (i % 8);
+    }
+    s.cellRaw[cells / 2] = 3710;   // Highest
+    s.cellRaw[cells - 1] = 3512;   // Lowest
+    s.tempRaw[0] = 251;
+    s.tempRaw[1] = -54;
+    s.tempRaw[2] = 304;
+    s.tempRaw[3] = 199;
+    s.currentRaw = -1234;
+    s.status = 0x81;
+    s.faultStatus = 0x04;
+    s.balanceMask = 0x10005;
+
+    ProtectionConfig config;
+    config.overVoltageThreshold = 4.2f;
+    config.underVoltageThreshold = 2.8f;
+    config.overCurrentThreshold = 50.0f;
+    config.overTempThreshold = 60.0f;
+    config.underTempThreshold = -10.0f;
+    bench.scheduler.encoder().setLimits(config, cells);
+    bench.scheduler.update(s, 62.5f);
+    bench.frames = bench.scheduler.encoder().frameCount(s);
+}
+
+/**
+ * @brief Poll once and record what was sent
+ */
+static void poll(Bench &bench, uint32_t ms) {
+    uint32_t before = bench.sink.total();
+    bench.scheduler.poll(ms);
+    uint32_t sent = bench.sink.total() - before;
+    if (sent > bench.maxPerPoll) {
+        bench.maxPerPoll = (uint8_t)sent;
+    }
+    for (uint32_t i = 0; i < sent && i < bench.sink.count(); i++) {
+        const CanFrame &frame = *bench.sink.at(bench.sink.count() - sent + i);
+        Sent record = {ms, slotOf(frame), frame};
+        bench.sent.push_back(record);
+    }
+}
+
+/**
+ * @brief Smallest gap between frames sent at or after a time (ms)
+ */
+static uint32_t minGap(const Bench &bench, uint32_t fromMs) {
+    uint32_t gap = 0xFFFFFFFF;
+    for (size_t i = 1; i < bench.sent.size(); i++) {
+        if (bench.sent[i - 1].ms >= fromMs) {
+            uint32_t d = bench.sent[i].ms - bench.sent[i - 1].ms;
+            gap = d < gap ? d : gap;
+        }
+    }
+    return gap;
+}
+
+/**
+ * @brief True if slots run 0..frames-1 over and over with none skipped
+ */
+static bool slotsInOrder(const Bench &bench) {
+    for (size_t i = 0; i < bench.sent.size(); i++) {
+        if (bench.sent[i].slot != i % bench.frames) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool report(const char *name, bool ok, const char *detail) {
+    printf("%-8s %-4s %s\n", name, ok ? "ok" : "FAIL", detail);
+    return ok;
+}
+
+/**
+ * @brief Polled every millisecond: full cycles, evenly spaced
+ */
+static bool checkSteady(uint32_t period, uint8_t cells) {
+    Bench bench(period);
+    initBench(bench, cells);
+    const uint32_t cycles = 10;
+    for (uint32_t ms = 0; ms < cycles * period; ms++) {
+        poll(bench, ms);
+    }
+
+    uint32_t spacing = period / bench.frames;
+    uint32_t gap = minGap(bench, 0);
+    char detail[128];
+    snprintf(detail, sizeof(detail), "%u frames in %u cycles of %u, min gap %u ms (slot %u ms)",
+             (unsigned)bench.sent.size(), cycles, bench.frames, gap, spacing);
+    return report("steady", bench.sent.size() == cycles * bench.frames && slotsInOrder(bench) &&
+                  bench.maxPerPoll == 1 && gap >= spacing, detail);
+}
+
+/**
+ * @brief No polls between two times: no burst once polling resumes
+ */
+static bool checkStall(uint32_t period, uint8_t cells, uint32_t stallStart, uint32_t stallEnd) {
+    Bench bench(period);
+    initBench(bench, cells);
+    const uint32_t end = stallEnd + 4 * period;
+    for (uint32_t ms = 0; ms < end; ms++) {
+        if (ms < stallStart || ms >= stallEnd) {
+            poll(bench, ms);
+        }
+    }
+
+    uint32_t spacing = period / bench.frames;
+    uint32_t gap = minGap(bench, stallEnd);
+    uint32_t atResume = 0;
+    for (size_t i = 0; i < bench.sent.size(); i++) {
+        atResume += bench.sent[i].ms == stallEnd;
+    }
+    char detail[128];
+    snprintf(detail, sizeof(detail),
+             "%u frames at %u ms, at most %u per poll, min gap after %u ms (slot %u ms)", atResume,
+             stallEnd, bench.maxPerPoll, gap, spacing);
+    return report("stall", bench.maxPerPoll == 1 && gap >= spacing && slotsInOrder(bench),
+                  detail);
+}
+
+/**
+ * @brief Decode one cycle and compare it with the snapshot
+ */
+static bool checkContents(uint32_t period, uint8_t cells) {
+    Bench bench(period);
+    initBench(bench, cells);
+    for (uint32_t ms = 0; ms < period; ms++) {
+        poll(bench, ms);
+    }
+    const PackSnapshot &s = bench.snapshot;
+
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < cells; i++) {
+        total += s.cellRaw[i];
+    }
+    uint8_t seen = 0;
+    uint32_t cellsSeen = 0;
+    bool ok = bench.sent.size() == bench.frames;
+    for (size_t n = 0; n < bench.sent.size(); n++) {
+        const CanFrame &f = bench.sent[n].frame;
+        const uint8_t *d = f.data;
+        switch (f.id - PB7200_CAN_BASE_ID) {
+            case PB7200_CAN_PACK:
+                ok = ok && f.length == 5 && get16(d) == (total + 5) / 10 &&
+                     (int16_t)get16(d + 2) == s.currentRaw && d[4] == 125;
+                break;
+            case PB7200_CAN_LIMITS:
+                ok = ok && f.length == 8 && get16(d) == 420 * cells &&
+                     get16(d + 2) == 280 * cells && get16(d + 4) == 5000 &&
+                     (int8_t)d[6] == 60 && (int8_t)d[7] == -10;
+                break;
+            case PB7200_CAN_EXTREMES:
+                ok = ok && f.length == 8 && get16(d) == 3710 && get16(d + 2) == 3512 &&
+                     d[4] == cells / 2 && d[5] == cells - 1 && (int8_t)d[6] == 30 &&
+                     (int8_t)d[7] == -5;
+                break;
+            case PB7200_CAN_FAULTS:
+                ok = ok && f.length == 7 && d[0] == s.status && d[1] == s.faultStatus &&
+                     (d[2] | (d[3] << 8) | ((uint32_t)d[4] << 16)) == s.balanceMask &&
+                     d[5] == cells && d[6] == s.tempCount;
+                break;
+            case PB7200_CAN_TEMPS:
+                ok = ok && f.length == s.tempCount && (int8_t)d[0] == 25 && (int8_t)d[1] == -5 &&
+                     (int8_t)d[2] == 30 && (int8_t)d[3] == 20;
+                break;
+            default: {
+                uint8_t first = d[0] * PB7200_CAN_CELLS_PER_FRAME;
+                ok = ok && f.id == PB7200_CAN_BASE_ID + PB7200_CAN_CELLS && first < cells;
+                for (uint8_t i = 0; ok && 1 + 2 * i < f.length; i++) {
+                    ok = get16(d + 1 + 2 * i) == s.cellRaw[first + i];
+                    cellsSeen++;
+                }
+                break;
+            }
+        }
+        seen++;
+    }
+
+    char detail[128];
+    snprintf(detail, sizeof(detail), "%u frames decoded, %u of %u cells", seen, cellsSeen, cells);
+    return report("contents", ok && cellsSeen == cells, detail);
+}
+
+static void usage(const char *name) {
+    fprintf(stderr, "usage: %s [-p period ms] [-s cells] [-a stall start ms] [-b stall end ms]\n",
+            name);
+}
+
+int main(int argc, char **argv) {
+    uint32_t period = 100;
+    uint8_t cells = 16;
+    uint32_t stallStart = 50;
+    uint32_t stallEnd = 195;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "p:s:a:b:")) != -1) {
+        switch (opt) {
+            case 'p': period = (uint32_t)atoi(optarg); break;
+            case 's': cells = (uint8_t)atoi(optarg); break;
+            case 'a': stallStart = (uint32_t)atoi(optarg); break;
+            case 'b': stallEnd = (uint32_t)atoi(optarg); break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    // One frame per poll and per millisecond at most
+    uint8_t frames = PB7200_CAN_CELLS + (cells + PB7200_CAN_CELLS_PER_FRAME - 1) /
+                     PB7200_CAN_CELLS_PER_FRAME;
+    if (cells < 4 || cells > PB7200_MAX_CELLS || period < frames || stallEnd <= stallStart) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    printf("period %u ms, %u cells, stall %u-%u ms\n", period, cells, stallStart, stallEnd);
+    bool ok = checkSteady(period, cells);
+    ok = checkStall(period, cells, stallStart, stallEnd) && ok;
+    ok = checkContents(period, cells) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+/**
+ * @file columns.cpp
+ * @brief Query column files written by ingestd
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Build from the library root:
+ *   g++ -std=c++11 -O2 -I. -Iextras/host extras/host/columns.cpp \
+ *       extras/host/pb7200_columns.cpp -o columns
+ *
+ * Usage:
+ *   ./columns info FILE...
+ *   ./columns index FILE...                  (build the summary index)
+ *   ./columns range FILE CHANNEL [FROM [TO]]
+ *   ./columns summary FILE CHANNEL [FROM [TO]]
+ *   ./columns windows FILE CHANNEL above|below THRESHOLD [FROM [TO]]
+ *   ./columns dump FILE CHANNEL [FROM [TO]]
+ *
+ * CHANNEL is cell1..cell20, temp1..temp8, current, voltage, delta or
+ * status. FROM and TO are Unix times in seconds (fractions allowed);
+ * values are printed in register units (mV, 0.1 °C, 10 mA, 10 mV).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pb7200_columns.h"
+
+/**
+ * @brief Parse a channel name
+ * @return Channel, PB7200_COLUMN_CHANNELS if unknown
+ */
+static uint8_t parseChannel(const char *name) {
+    static const struct {
+        const char *name;
+        uint8_t channel;
+    } fixed[] = {
+        {"current", PB7200_COLUMN_CURRENT},
+        {"voltage", PB7200_COLUMN_VOLTAGE},
+        {"delta", PB7200_COLUMN_DELTA},
+        {"status", PB7200_COLUMN_STATUS},
+    };
+
+    for (size_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++) {
+        if (strcmp(name, fixed[i].name) == 0) {
+            return fixed[i].channel;
+        }
+    }
+    int n;
+    if (sscanf(name, "cell%d", &n) == 1 && n >= 1 && n <= PB7200_MAX_CELLS) {
+        return (uint8_t)(PB7200_COLUMN_CELL + n - 1);
+    }
+    if (sscanf(name, "temp%d", &n) == 1 && n >= 1 && n <= PB7200_MAX_TEMPS) {
+        return (uint8_t)(PB7200_COLUMN_TEMP + n - 1);
+    }
+    return PB7200_COLUMN_CHANNELS;
+}
+
+/**
+ * @brief Parse a time argument (Unix seconds)
+ */
+static uint64_t parseTime(const char *text, uint64_t fallback) {
+    return text != nullptr ? (uint64_t)(atof(text) * 1e6) : fallback;
+}
+
+/**
+ * @brief Format a time as UTC with milliseconds
+ */
+static const char *formatTime(uint64_t us, char *text, size_t size) {
+    time_t seconds = (time_t)(us / 1000000);
+    struct tm tm;
+    gmtime_r(&seconds, &tm);
+    size_t n = strftime(text, size, "%Y-%m-%d %H:%M:%S", &tm);
+    snprintf(text + n, size - n, ".%03u", (unsigned)(us / 1000 % 1000));
+    return text;
+}
+
+/**
+ * @brief Print the layout of a file
+ */
+static int info(const char *path) {
+    ColumnReader reader;
+    if (!reader.open(path)) {
+        fprintf(stderr, "%s: not a column file\n", path);
+        return 1;
+    }
+
+    char first[32] = "-";
+    char last[32] = "-";
+    if (reader.blockCount() > 0) {
+        formatTime(reader.block(0).firstUs, first, sizeof(first));
+        formatTime(reader.block(reader.blockCount() - 1).lastUs, last, sizeof(last));
+    }
+    printf("%s: pack %u, %llu rows in %u blocks of %u, %s .. %s, %s\n", path, reader.packId(),
+           (unsigned long long)reader.rowCount(), reader.blockCount(), reader.blockRows(),
+           first, last, reader.hasIndex() ? "indexed" : "no index");
+    return 0;
+}
+
+/**
+ * @brief Build or update the summary index of a file
+ */
+static int index(const char *path) {
+    ColumnReader reader;
+    ColumnWriter writer;
+    if (!reader.open(path) || !writer.open(path, reader.packId(), reader.blockRows())) {
+        fprintf(stderr, "%s: cannot index\n", path);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 3 && (strcmp(argv[1], "info") == 0 || strcmp(argv[1], "index") == 0)) {
+        bool build = strcmp(argv[1], "index") == 0;
+        int status = 0;
+        for (int i = 2; i < argc; i++) {
+            status |= build ? index(argv[i]) : info(argv[i]);
+        }
+        return status;
+    }
+
+    const char *command = argc >= 4 ? argv[1] : "";
+    bool windows = argc >= 6 && strcmp(command, "windows") == 0;
+    int timeArg = windows ? 6 : 4;
+    if (strcmp(command, "range") != 0 && strcmp(command, "summary") != 0 &&
+        strcmp(command, "dump") != 0 && !windows) {
+        fprintf(stderr, "usage: %s info|index FILE...\n"
+                        "       %s range|summary|dump FILE CHANNEL [FROM [TO]]\n"
+                        "       %s windows FILE CHANNEL above|below THRESHOLD [FROM [TO]]\n",
+                argv[0], argv[0], argv[0]);
+        return 1;
+    }
+
+    ColumnReader reader;
+    if (!reader.open(argv[2])) {
+        fprintf(stderr, "%s: not a column file\n", argv[2]);
+        return 1;
+    }
+    uint8_t channel = parseChannel(argv[3]);
+    if (channel >= PB7200_COLUMN_CHANNELS) {
+        fprintf(stderr, "unknown channel %s\n", argv[3]);
+        return 1;
+    }
+    uint64_t fromUs = parseTime(argc > timeArg ? argv[timeArg] : nullptr, 0);
+    uint64_t toUs = parseTime(argc > timeArg + 1 ? argv[timeArg + 1] : nullptr, UINT64_MAX);
+
+    char text[32];
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if (strcmp(command, "range") == 0) {
+        ColumnExtremes result;
+        bool found = reader.extremes(channel, fromUs, toUs, result);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        if (!found) {
+            printf("no data\n");
+        } else {
+            printf("min %d at %s\n", result.minValue, formatTime(result.minUs, text, sizeof(text)));
+            printf("max %d at %s\n", result.maxValue, formatTime(result.maxUs, text, sizeof(text)));
+        }
+    } else if (strcmp(command, "summary") == 0) {
+        ColumnSummary summary;
+        reader.summarize(channel, fromUs, toUs, summary);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        if (summary.count == 0) {
+            printf("no data\n");
+        } else {
+            printf("count %u  min %d  max %d  mean %.2f\n", summary.count, summary.minValue,
+                   summary.maxValue, (double)summary.sum / summary.count);
+        }
+    } else if (windows) {
+        bool above = strcmp(argv[4], "below") != 0;
+        char last[32];
+        uint32_t count = reader.windows(channel, fromUs, toUs, (int16_t)atoi(argv[5]), above,
+            [&](uint64_t firstUs, uint64_t lastUs, int16_t peak) {
+                printf("%s .. %s  peak %d\n", formatTime(firstUs, text, sizeof(text)),
+                       formatTime(lastUs, last, sizeof(last)), peak);
+            });
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        fprintf(stderr, "%u windows\n", count);
+    } else {
+        uint64_t count = reader.scan(channel, fromUs, toUs, [&](uint64_t us, int16_t value) {
+            printf("%s %d\n", formatTime(us, text, sizeof(text)), value);
+        });
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        fprintf(stderr, "%llu values\n", (unsigned long long)count);
+    }
+
+    fprintf(stderr, "query took %.3f ms\n",
+            (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+    return 0;
+}
@@ -0,0 +1,416 @@
+/**
+ * @file cyclesim.cpp
+ * @brief One pack through a scripted cycle: driver, simulated chip and cells
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Runs the unmodified PB7200P80 driver against a PB7200SimChip fed by
+ * an equivalent-circuit PackModel (pb7200_packmodel.h), with the pack
+ * current taken from a CurrentProfile script (pb7200_profile.h). The
+ * driver balances the top cells while the pack charges or rests, and
+ * its balance registers switch the model's bleed resistors, so
+ * convergence, bleed heat and the driver's state of charge can be
+ * checked against the cells' true state over a whole cycle.
+ *
+ * Time is simulated, so a day of charging and balancing takes well
+ * under a second.
+ *
+ * With -E the lifetime records, counter checkpoints and event log are
+ * mounted on a PB7200FileStorage in the README layout, and the writes
+ * to each region are counted. At the end the file is mounted again and
+ * the checkpoint restored from it. -r reloads the counters from the last
+ * checkpoint part way through, as an MCU reset would.
+ *
+ * Build from the library root:
+ *   g++ -std=c++11 -O2 -Iextras/host/arduino -I. -Iextras/host \
+ *       extras/host/cyclesim.cpp extras/host/pb7200_simbench.cpp \
+ *       extras/host/pb7200_simchip.cpp extras/host/pb7200_faults.cpp \
+ *       extras/host/pb7200_packmodel.cpp extras/host/pb7200_profile.cpp \
+ *       extras/host/arduino/Arduino.cpp PB7200P80.cpp PB7200Stats.cpp \
+ *       PB7200Format.cpp PB7200Storage.cpp -o cyclesim
+ *
+ * Usage:
+ *   ./cyclesim [-p profile | -f profile file] [-s cells] [-a Ah] [-L]
+ *              [-q SOC spread %] [-k capacity spread %] [-m leakage spread mA]
+ *              [-A ambient °C] [-B balance mV, 0 = off] [-u update ms]
+ *              [-T step ms] [-C] [-R seed] [-o csv] [-i csv interval s]
+ *              [-E storage file] [-r reset s]
+ *
+ * -L uses the LFP voltage curve; -C uses coherent acquisition.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "PB7200P80.h"
+#include "pb7200_profile.h"
+#include "pb7200_simbench.h"
+
+// Discharge, then charge and balance through a long rest
+#define DEFAULT_PROFILE "discharge 25 3.4; rest 1800; charge 25 4.15 1; rest 28800"
+#define DEFAULT_PROFILE_LFP "discharge 25 3.0; rest 1800; charge 25 3.55 1; rest 28800"
+
+/**
+ * @brief Simulator settings
+ */
+struct Options {
+    std::string profile;
+    uint8_t cells;
+    float capacityAh;
+    CellChemistry chemistry;
+    float socSpread;
+    float capacitySpread;
+    float leakageSpread;
+    float ambient;
+    uint16_t balanceMv;
+    uint32_t updateMs;
+    uint32_t stepMs;
+    bool coherent;
+    uint32_t seed;
+    const char *csv;
+    float csvInterval;
+    const char *storage;
+    float resetAt;
+};
+
+// Storage regions, laid out as in the README
+enum StorageRegion {
+    REGION_RECORDS,
+    REGION_CHECKPOINTS,
+    REGION_EVENTS,
+    REGION_COUNT
+};
+
+static const char *const REGION_NAMES[REGION_COUNT] = {"records", "checkpoints", "events"};
+
+#define CHECKPOINT_ADDRESS PB7200_RECORD_STORAGE_SIZE
+#define EVENT_ADDRESS (CHECKPOINT_ADDRESS + PB7200_CHECKPOINT_STORAGE_SIZE)
+#define STORAGE_SIZE \
+    (EVENT_ADDRESS + RecordRing::footprint(PB7200_EVENT_SLOTS, PB7200_EVENT_PAYLOAD))
+
+/**
+ * @brief File storage that counts writes per region
+ */
+class CountingStorage : public PB7200FileStorage {
+public:
+    uint32_t writes[REGION_COUNT];
+
+    CountingStorage(const char *path) : PB7200FileStorage(path, STORAGE_SIZE) {
+        memset(writes, 0, sizeof(writes));
+    }
+
+    bool write(uint32_t address, const void *data, uint16_t length) override {
+        writes[address < CHECKPOINT_ADDRESS ? REGION_RECORDS
+               : address < EVENT_ADDRESS    ? REGION_CHECKPOINTS
+                                            : REGION_EVENTS]++;
+        return PB7200FileStorage::write(address, data, length);
+    }
+};
+
+/**
+ * @brief Lowest, highest and mean cell state of charge
+ */
+struct SocRange {
+    float min;
+    float max;
+    float mean;
+};
+
+static uint64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Spread of the cells' true state of charge
+ */
+static SocRange socRange(const PackModel &model) {
+    SocRange range = {1.0f, 0.0f, 0.0f};
+    for (uint8_t i = 0; i < model.cellCount(); i++) {
+        float soc = model.cell(i).soc;
+        range.min = soc < range.min ? soc : range.min;
+        range.max = soc > range.max ? soc : range.max;
+        range.mean += soc / model.cellCount();
+    }
+    return range;
+}
+
+/**
+ * @brief Mount records, checkpoints and the event log
+ * @return true if a checkpoint was restored
+ */
+static bool mountStorage(PB7200P80 &driver, PB7200Storage &storage) {
+    driver.setRecordStorage(&storage, 0);
+    bool restored = driver.setCheckpointStorage(&storage, CHECKPOINT_ADDRESS);
+    driver.setEventLogStorage(&storage, EVENT_ADDRESS);
+    return restored;
+}
+
+/**
+ * @brief Read a profile script from a file
+ */
+static bool readProfile(const char *path, std::string &profile) {
+    FILE *file = fopen(path, "r");
+    if (file == nullptr) {
+        return false;
+    }
+    char buffer[256];
+    size_t n;
+    profile.clear();
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        profile.append(buffer, n);
+    }
+    fclose(file);
+    return true;
+}
+
+static void usage(const char *name) {
+    fprintf(stderr,
+            "usage: %s [-p profile | -f profile file] [-s cells] [-a Ah] [-L]\n"
+            "          [-q SOC spread %%] [-k capacity spread %%] [-m leakage spread mA]\n"
+            "          [-A ambient C] [-B balance mV] [-u update ms] [-T step ms] [-C]\n"
+            "          [-R seed] [-o csv] [-i csv interval s] [-E storage file] [-r reset s]\n",
+            name);
+}
+
+int main(int argc, char **argv) {
+    Options options = {"", 16, 50.0f, CHEMISTRY_NMC, 0.5f, 1.0f, 0.0f, 25.0f,
+                       10, 1000, 1000, false, 1, nullptr, 60.0f, nullptr, -1.0f};
+
+    int opt;
+    while ((opt = getopt(argc, argv, "p:f:s:a:Lq:k:m:A:B:u:T:CR:o:i:E:r:")) != -1) {
+        switch (opt) {
+            case 'p': options.profile = optarg; break;
+            case 'f':
+                if (!readProfile(optarg, options.profile)) {
+                    perror(optarg);
+                    return 1;
+                }
+                break;
+            case 's': options.cells = (uint8_t)atoi(optarg); break;
+            case 'a': options.capacityAh = atof(optarg); break;
+            case 'L': options.chemistry = CHEMISTRY_LFP; break;
+            case 'q': options.socSpread = atof(optarg); break;
+            case 'k': options.capacitySpread = atof(optarg); break;
+            case 'm': options.leakageSpread = atof(optarg); break;
+            case 'A': options.ambient = atof(optarg); break;
+            case 'B': options.balanceMv = (uint16_t)atoi(optarg); break;
+            case 'u': options.updateMs = (uint32_t)atoi(optarg); break;
+            case 'T': options.stepMs = (uint32_t)atoi(optarg); break;
+            case 'C': options.coherent = true; break;
+            case 'R': options.seed = (uint32_t)atoi(optarg); break;
+            case 'o': options.csv = optarg; break;
+            case 'i': options.csvInterval = atof(optarg); break;
+            case 'E': options.storage = optarg; break;
+            case 'r': options.resetAt = atof(optarg); break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if (options.cells < 1 || options.cells > 16 || options.capacityAh <= 0 ||
+        options.updateMs == 0 || options.stepMs == 0 ||
+        (options.resetAt >= 0 && options.storage == nullptr)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (options.profile.empty()) {
+        options.profile = options.chemistry == CHEMISTRY_LFP ? DEFAULT_PROFILE_LFP : DEFAULT_PROFILE;
+    }
+    CurrentProfile profile;
+    if (!profile.parse(options.profile.c_str()) || profile.stepCount() == 0) {
+        fprintf(stderr, "bad profile: %s\n", options.profile.c_str());
+        return 1;
+    }
+
+    FILE *csv = nullptr;
+    if (options.csv != nullptr) {
+        csv = fopen(options.csv, "w");
+        if (csv == nullptr) {
+            perror(options.csv);
+            return 1;
+        }
+        fprintf(csv, "time_s,step,current_a,temp_c,soc_pct,driver_soc_pct,min_v,max_v,"
+                     "delta_mv,balance_mask,bled_ah\n");
+    }
+
+    PB7200SimBench bench;
+    CellSpread spread = {options.capacitySpread / 100.0f, 0.05f, options.leakageSpread / 1000.0f,
+                         options.socSpread / 100.0f};
+    bench.initPack(options.cells, options.capacityAh, 0.6f, options.ambient);
+    bench.model.setChemistry(options.chemistry);
+    bench.model.randomize(spread, options.seed);
+    for (uint8_t i = 0; i < PB7200_SIM_SENSORS; i++) {
+        bench.model.setSensorOffset(i, 0.5f * i);
+    }
+    if (options.chemistry == CHEMISTRY_LFP) {
+        ProtectionConfig limits = {3.65f, 2.50f, 100.0f, 60.0f, -20.0f, 0, 0, 0};
+        bench.chip.setLimits(limits);
+    }
+
+    // Checkpoints are restored before begin(); start() then seeds SOC from the model
+    CountingStorage *storage = nullptr;
+    bool restoredAtBoot = false;
+    if (options.storage != nullptr) {
+        storage = new CountingStorage(options.storage);
+        if (!storage->isOpen()) {
+            perror(options.storage);
+            return 1;
+        }
+        restoredAtBoot = mountStorage(bench.driver, *storage);
+    }
+
+    bench.bind();
+    if (!bench.start(options.cells)) {
+        fprintf(stderr, "driver begin() failed\n");
+        return 1;
+    }
+    SocRange start = socRange(bench.model);
+    bench.driver.setCoherentMode(options.coherent);
+
+    const float dt = options.stepMs / 1000.0f;
+    const uint32_t stepUs = options.stepMs * 1000;
+    const uint64_t updateUs = (uint64_t)options.updateMs * 1000;
+    float nextCsv = 0.0f;
+    uint32_t updates = 0;
+    uint32_t failures = 0;
+    uint8_t faults = 0;
+    float peakTemp = options.ambient;
+    float firstBalance = -1.0f;
+    float lastBalance = -1.0f;
+    float resetSoc = -1.0f;
+    float restoredSoc = -1.0f;
+    float resetTrueSoc = 0.0f;
+    PackStats stats;
+    memset(&stats, 0, sizeof(stats));
+
+    uint64_t wallStart = monotonicNs();
+    while (!profile.finished()) {
+        float current = profile.next(bench.model, dt);
+        if (profile.finished()) {
+            break;
+        }
+        bench.step(stepUs, current);
+        peakTemp = bench.model.temperature() > peakTemp ? bench.model.temperature() : peakTemp;
+
+        if (!bench.updateDue(updateUs)) {
+            continue;
+        }
+
+        updates++;
+        if (!bench.driver.update()) {
+            failures++;
+            continue;
+        }
+        bench.driver.getPackStats(stats);
+        faults |= bench.driver.getSnapshot().faultStatus;
+        float seconds = bench.now() / 1e6f;
+
+        // Counters reloaded as after an MCU reset; SOC shows on the next update
+        if (resetSoc >= 0 && restoredSoc < 0) {
+            restoredSoc = stats.soc;
+        }
+        if (options.resetAt >= 0 && seconds >= options.resetAt && resetSoc < 0) {
+            resetSoc = stats.soc;
+            resetTrueSoc = 100.0f * socRange(bench.model).mean;
+            bench.driver.restoreCheckpoint();
+        }
+
+        // Top balancing while charging or resting
+        bool balancing = bench.driver.getSnapshot().balanceMask != 0;
+        if (options.balanceMv > 0 && stats.current >= 0 &&
+            stats.voltageDelta * 1000.0f > options.balanceMv) {
+            bench.driver.balanceTopCells(options.cells / 4 + 1, options.balanceMv);
+            if (!balancing) {
+                firstBalance = firstBalance < 0 ? seconds : firstBalance;
+            }
+        } else if (balancing) {
+            bench.driver.stopAllBalancing();
+            lastBalance = seconds;
+        }
+
+        if (csv != nullptr && seconds >= nextCsv) {
+            nextCsv += options.csvInterval;
+            fprintf(csv, "%.0f,%u,%.3f,%.2f,%.3f,%.3f,%.4f,%.4f,%.1f,0x%05lx,%.4f\n", seconds,
+                    profile.stepIndex(), current, bench.model.temperature(),
+                    100.0f * socRange(bench.model).mean, stats.soc, stats.minCellVoltage,
+                    stats.maxCellVoltage, stats.voltageDelta * 1000.0f,
+                    (unsigned long)bench.driver.getSnapshot().balanceMask, bench.model.bledAh());
+        }
+    }
+    double wall = (monotonicNs() - wallStart) / 1e9;
+
+    // Save, then mount the file again and restore from what was written
+    float savedSoc = stats.soc;
+    float remountSoc = -1.0f;
+    bool remounted = false;
+    uint16_t events = 0;
+    uint16_t validEvents = 0;
+    uint32_t writes[REGION_COUNT];
+    if (storage != nullptr) {
+        bench.driver.saveCheckpoint();
+        bench.driver.flushRecords();
+        memcpy(writes, storage->writes, sizeof(writes));
+        delete storage;
+        storage = new CountingStorage(options.storage);
+        remounted = mountStorage(bench.driver, *storage);
+        if (remounted && bench.driver.update()) {
+            bench.driver.getPackStats(stats);
+            remountSoc = stats.soc;
+        }
+        EventRecord event;
+        events = bench.driver.getEventCount();
+        for (uint16_t age = 0; age < events; age++) {
+            validEvents += bench.driver.getEvent(age, event);
+        }
+    }
+    bench.unbind();
+    if (csv != nullptr) {
+        fclose(csv);
+    }
+
+    SocRange end = socRange(bench.model);
+    double simulated = bench.now() / 1e6;
+    printf("%u cells, %.0f Ah, %s, %u profile steps\n", options.cells, options.capacityAh,
+           options.chemistry == CHEMISTRY_LFP ? "LFP" : "NMC", profile.stepCount());
+    printf("simulated %.1f h in %.3f s (x%.0f), %u updates, %u failures, %u transfers\n",
+           simulated / 3600.0, wall, wall > 0 ? simulated / wall : 0.0, updates, failures,
+           bench.chip.transfers());
+    printf("cell SOC spread %.2f %% -> %.2f %%, bled %.3f Ah", 100.0f * (start.max - start.min),
+           100.0f * (end.max - end.min), bench.model.bledAh());
+    if (firstBalance >= 0) {
+        printf(", balancing %.1f h -> %.1f h", firstBalance / 3600.0f,
+               (lastBalance >= firstBalance ? lastBalance : simulated) / 3600.0f);
+    }
+    printf("\n");
+    printf("final delta %.1f mV, peak %.1f C, SOC true %.2f %% driver %.2f %% (error %+.2f)\n",
+           stats.voltageDelta * 1000.0f, peakTemp, 100.0f * end.mean, stats.soc,
+           stats.soc - 100.0f * end.mean);
+    if (faults != 0) {
+        printf("faults seen 0x%02x\n", faults);
+    }
+
+    if (storage != nullptr) {
+        printf("storage %s, %u bytes, checkpoint %s at boot\n", options.storage,
+               (unsigned)STORAGE_SIZE, restoredAtBoot ? "restored" : "not found");
+        for (uint8_t r = 0; r < REGION_COUNT; r++) {
+            printf("  %-11s %6u writes (%.0f per day)\n", REGION_NAMES[r], writes[r],
+                   simulated > 0 ? writes[r] * 86400.0 / simulated : 0.0);
+        }
+        if (resetSoc >= 0) {
+            printf("reset at %.1f h: SOC true %.2f %%, driver %.2f %% -> %.2f %% from checkpoint\n",
+                   options.resetAt / 3600.0f, resetTrueSoc, resetSoc, restoredSoc);
+        }
+        printf("remount: checkpoint %s, SOC %.2f %% -> %.2f %%, %u of %u events valid\n",
+               remounted ? "restored" : "MISSING", savedSoc, remountSoc, validEvents, events);
+        delete storage;
+    }
+    return 0;
+}
@@ -0,0 +1,287 @@
+/**
+ * @file faultbench.cpp
+ * @brief Acquisition latency and throughput under injected bus faults
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Runs the unmodified PB7200P80 driver against a PB7200SimChip behind a
+ * PB7200FaultTransport (pb7200_faults.h), one fault load at a time, and
+ * measures every update() on the simulated clock, so bus transfer times,
+ * retries, injected delays and conversion waits all count. Each load is
+ * run twice: with the driver's bus error handling off (no retries, no
+ * bus restart, no fault confirmation) and with its defaults.
+ *
+ * The chip's inputs change before every update, so each acquisition has
+ * its own expected readings. Per load it reports successful updates,
+ * update() latency (p50, p99, max), updates per simulated second,
+ * retries and bus restarts, the oldest data the application saw
+ * (getDataAge()), successful updates that returned corrupted readings,
+ * failed updates that changed the snapshot (a partial acquisition
+ * leaking out), and updates that reported a fault the chip never had.
+ *
+ * Build from the library root:
+ *   g++ -std=c++11 -O2 -Iextras/host/arduino -I. -Iextras/host \
+ *       extras/host/faultbench.cpp extras/host/pb7200_simbench.cpp \
+ *       extras/host/pb7200_simchip.cpp extras/host/pb7200_faults.cpp \
+ *       extras/host/pb7200_packmodel.cpp extras/host/arduino/Arduino.cpp \
+ *       PB7200P80.cpp PB7200Stats.cpp PB7200Format.cpp PB7200Storage.cpp \
+ *       -o faultbench
+ *
+ * Usage:
+ *   ./faultbench [-n updates] [-u update period ms] [-s cells] [-C]
+ *                [-k bus kHz] [-x probability scale] [-R seed]
+ *
+ * -C uses coherent acquisition; -x multiplies every fault probability.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "PB7200P80.h"
+#include "pb7200_simbench.h"
+
+// Inputs cycle through this many distinct values, one per update
+#define SIM_GENERATIONS 64
+
+/**
+ * @brief Benchmark settings
+ */
+struct Options {
+    uint32_t updates;
+    uint32_t periodMs;
+    uint8_t cells;
+    bool coherent;
+    uint32_t busKhz;
+    float scale;
+    uint32_t seed;
+};
+
+/**
+ * @brief One fault load
+ */
+struct FaultLoad {
+    const char *name;
+    uint8_t types;           // Bit per PB7200FaultType
+};
+
+static const FaultLoad LOADS[] = {
+    {"clean", 0},
+    {"nack", 1 << FAULT_NACK},
+    {"short-read", 1 << FAULT_SHORT_READ},
+    {"bit-flip", 1 << FAULT_BIT_FLIP},
+    {"stuck-bus", 1 << FAULT_STUCK_BUS},
+    {"delay", 1 << FAULT_DELAY},
+    {"spurious", 1 << FAULT_SPURIOUS_FAULT},
+    {"mixed", 0x3F},
+};
+
+// Probability per transfer and duration of each fault at scale 1
+static const FaultSchedule SCHEDULES[FAULT_TYPES] = {
+    {0.01f, 0, 0, 0, 0, 0},          // NACK
+    {0.01f, 0, 0, 0, 0, 0},          // Short read
+    {0.001f, 0, 0, 0, 0, 0},         // Bit flip
+    {0.0005f, 0, 0, 0, 0, 200000},   // Stuck bus, 200 ms
+    {0.02f, 0, 0, 0, 0, 2000},       // Delay, 2 ms
+    {0.01f, 0, 0, 0, 0, 0},          // Spurious fault bit
+};
+
+/**
+ * @brief Results of one load with one driver setting
+ */
+struct LoadResult {
+    uint32_t ok;
+    uint32_t p50Us;
+    uint32_t p99Us;
+    uint32_t maxUs;
+    float meanUs;
+    float updatesPerS;
+    UpdateTiming timing;
+    unsigned long maxAgeMs;
+    uint32_t corrupt;
+    uint32_t partial;
+    uint32_t falseFaults;
+    uint32_t injected;
+};
+
+/**
+ * @brief Check whether a snapshot holds the expected readings
+ */
+static bool sameReadings(const PackSnapshot &a, const PackSnapshot &b) {
+    return a.cellCount == b.cellCount && a.tempCount == b.tempCount &&
+           memcmp(a.cellRaw, b.cellRaw, a.cellCount * sizeof(a.cellRaw[0])) == 0 &&
+           memcmp(a.tempRaw, b.tempRaw, a.tempCount * sizeof(a.tempRaw[0])) == 0 &&
+           a.currentRaw == b.currentRaw && a.balanceMask == b.balanceMask;
+}
+
+/**
+ * @brief Give the chip the inputs of one generation and latch them
+ *
+ * Every channel moves by one count per generation, so readings from two
+ * acquisitions never match the expected set of either.
+ */
+static void setInputs(PB7200SimBench &bench, uint8_t cells, uint32_t generation,
+                      PackSnapshot &expected) {
+    uint16_t step = generation % SIM_GENERATIONS;
+    float volts[PB7200_MAX_CELLS];
+    float temps[PB7200_SIM_SENSORS];
+
+    memset(&expected, 0, sizeof(expected));
+    expected.cellCount = cells;
+    expected.tempCount = PB7200_SIM_SENSORS;
+    for (uint8_t i = 0; i < cells; i++) {
+        expected.cellRaw[i] = 3600 + 4 * i + step;
+        volts[i] = expected.cellRaw[i] * PB7200_VOLTAGE_LSB;
+    }
+    for (uint8_t i = 0; i < PB7200_SIM_SENSORS; i++) {
+        expected.tempRaw[i] = 240 + 10 * i + step;
+        temps[i] = expected.tempRaw[i] * PB7200_TEMP_LSB;
+    }
+    expected.currentRaw = -1250 + step;
+
+    bench.chip.setCellVoltages(volts, cells);
+    bench.chip.setTemperatures(temps, PB7200_SIM_SENSORS);
+    bench.chip.setCurrent(expected.currentRaw * PB7200_CURRENT_LSB);
+    bench.chip.convert();
+}
+
+/**
+ * @brief Run one fault load
+ */
+static LoadResult runLoad(const FaultLoad &load, bool handling, const Options &options) {
+    LoadResult result;
+    memset(&result, 0, sizeof(result));
+
+    PB7200SimBench bench(options.seed);
+    PackSnapshot expected;
+    uint32_t generation = 0;
+    setInputs(bench, options.cells, generation, expected);
+    bench.chip.setBusClock(options.busKhz * 1000);
+
+    // Start fault-free; the chip's inputs come from setInputs(), not a model
+    bench.bind();
+    if (!bench.start(options.cells) || !bench.driver.update()) {
+        bench.unbind();
+        return result;
+    }
+    bench.driver.setCoherentMode(options.coherent);
+    if (!handling) {
+        bench.driver.setRetryCount(0);
+        bench.driver.setRecoveryThreshold(0);
+        bench.driver.setFaultConfirmation(false);
+    }
+    bench.driver.resetUpdateTiming();
+
+    uint64_t start = bench.clock.us;
+    for (uint8_t t = 0; t < FAULT_TYPES; t++) {
+        if (load.types & (1 << t)) {
+            FaultSchedule schedule = SCHEDULES[t];
+            schedule.probability *= options.scale;
+            schedule.startUs = start;
+            bench.faults.setFault((PB7200FaultType)t, schedule);
+        }
+    }
+
+    std::vector<uint32_t> latency;
+    latency.reserve(options.updates);
+    const uint64_t periodUs = (uint64_t)options.periodMs * 1000;
+    uint64_t nextUs = start;
+    for (uint32_t n = 0; n < options.updates; n++) {
+        bench.sync(nextUs);
+        nextUs += periodUs;
+        setInputs(bench, options.cells, ++generation, expected);
+
+        PackSnapshot before = bench.driver.getSnapshot();
+        bool ok = bench.driver.update();
+        const PackSnapshot &after = bench.driver.getSnapshot();
+        UpdateTiming timing;
+        bench.driver.getUpdateTiming(timing);
+        latency.push_back(timing.lastUs);
+
+        unsigned long age = bench.driver.getDataAge();
+        result.maxAgeMs = age > result.maxAgeMs ? age : result.maxAgeMs;
+        if (after.faultStatus != 0) {
+            result.falseFaults++;
+        }
+        if (!ok) {
+            // A failed update must leave the previous snapshot untouched
+            if (!sameReadings(before, after) || before.status != after.status ||
+                before.faultStatus != after.faultStatus || before.sequence != after.sequence ||
+                before.timestamp != after.timestamp || before.coherent != after.coherent) {
+                result.partial++;
+            }
+            continue;
+        }
+        result.ok++;
+        if (!sameReadings(after, expected)) {
+            result.corrupt++;
+        }
+    }
+    uint64_t elapsedUs = bench.clock.us - start;
+    bench.unbind();
+
+    bench.driver.getUpdateTiming(result.timing);
+    std::sort(latency.begin(), latency.end());
+    result.p50Us = latency[latency.size() / 2];
+    result.p99Us = latency[latency.size() * 99 / 100];
+    result.maxUs = result.timing.maxUs;
+    result.meanUs = result.timing.meanUs;
+    result.updatesPerS = elapsedUs > 0 ? result.ok * 1e6f / elapsedUs : 0.0f;
+    for (uint8_t t = 0; t < FAULT_TYPES; t++) {
+        result.injected += bench.faults.injected((PB7200FaultType)t);
+    }
+    return result;
+}
+
+static void usage(const char *name) {
+    fprintf(stderr,
+            "usage: %s [-n updates] [-u update period ms] [-s cells] [-C]\n"
+            "          [-k bus kHz] [-x probability scale] [-R seed]\n",
+            name);
+}
+
+int main(int argc, char **argv) {
+    Options options = {20000, 10, 16, false, 100, 1.0f, 1};
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:u:s:Ck:x:R:")) != -1) {
+        switch (opt) {
+            case 'n': options.updates = (uint32_t)atoi(optarg); break;
+            case 'u': options.periodMs = (uint32_t)atoi(optarg); break;
+            case 's': options.cells = (uint8_t)atoi(optarg); break;
+            case 'C': options.coherent = true; break;
+            case 'k': options.busKhz = (uint32_t)atoi(optarg); break;
+            case 'x': options.scale = atof(optarg); break;
+            case 'R': options.seed = (uint32_t)atoi(optarg); break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if (options.updates == 0 || options.cells < 1 || options.cells > 16 ||
+        options.busKhz == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    printf("%u updates every %u ms, %u cells, %s, %u kHz bus, fault scale %.2f\n",
+           options.updates, options.periodMs, options.cells,
+           options.coherent ? "coherent" : "free-running", options.busKhz, options.scale);
+    printf("%-11s %-8s %7s %7s %7s %8s %8s %7s %7s %6s %7s %7s %7s %7s %7s\n",
+           "load", "handling", "ok %", "p50 us", "p99 us", "max us", "mean us", "upd/s",
+           "retries", "resets", "age ms", "corrupt", "partial", "false", "faults");
+    for (size_t i = 0; i < sizeof(LOADS) / sizeof(LOADS[0]); i++) {
+        for (int handling = 0; handling < 2; handling++) {
+            LoadResult r = runLoad(LOADS[i], handling != 0, options);
+            printf("%-11s %-8s %7.2f %7u %7u %8u %8.0f %7.1f %7u %6u %7lu %7u %7u %7u %7u\n",
+                   LOADS[i].name, handling ? "on" : "off", 100.0 * r.ok / options.updates,
+                   r.p50Us, r.p99Us, r.maxUs, r.meanUs, r.updatesPerS, r.timing.retries,
+                   r.timing.recoveries, r.maxAgeMs, r.corrupt, r.partial, r.falseFaults,
+                   r.injected);
+        }
+    }
+    return 0;
+}
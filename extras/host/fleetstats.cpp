@@ -0,0 +1,210 @@
+/**
+ * @file fleetstats.cpp
+ * @brief Reprocess column files with the pack statistics kernel
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Build from the library root:
+ *   g++ -std=c++11 -O2 -I. -Iextras/host extras/host/fleetstats.cpp \
+ *       extras/host/pb7200_batch.cpp extras/host/pb7200_columns.cpp \
+ *       PB7200Stats.cpp -o fleetstats
+ *
+ * Usage:
+ *   ./fleetstats [-s] [-p P] [-c AH] [-b MV] [-z Z] FILE...
+ *
+ *   -s  scalar path only (default: AVX2 when available)
+ *   -p  cells in parallel per group (default 1)
+ *   -c  capacity of one group in Ah, starting full (default 100)
+ *   -b  balance threshold over the lowest cell in mV (default 10)
+ *   -z  anomaly alarm level in standard deviations (default 3)
+ *
+ * Prints one line per pack (cell range, largest spread, net energy, final
+ * SOC, mean cells above the balance threshold, cells in anomaly alarm)
+ * and percentiles of every cell value.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "pb7200_batch.h"
+
+// Cell histogram: 1 mV bins from 2000 mV
+#define HISTOGRAM_LOW 2000
+#define HISTOGRAM_BINS 2600
+
+// Anomaly running-stats window (frames)
+#define ANOMALY_WINDOW 600
+
+/**
+ * @brief Results of one pack
+ */
+struct PackReport {
+    uint64_t rows;           // Frames in the file
+    uint64_t statRows;       // Frames without nulls
+    uint64_t aboveSum;       // Sum of cells above the balance threshold
+    float maxDelta;          // Largest cell spread (V)
+    float minCell;           // Lowest cell (V)
+    float maxCell;           // Highest cell (V)
+    float energyWh;          // Net energy over the file (Wh)
+    float lastSoc;           // State of charge at the end (%)
+    uint32_t alarmMask;      // Cells in anomaly alarm at any block end
+};
+
+/**
+ * @brief Value below which a share of the histogram lies
+ */
+static int percentile(const uint64_t *bins, uint64_t total, double share) {
+    uint64_t target = (uint64_t)(total * share);
+    uint64_t seen = 0;
+    for (int i = 0; i < HISTOGRAM_BINS; i++) {
+        seen += bins[i];
+        if (seen > target) {
+            return HISTOGRAM_LOW + i;
+        }
+    }
+    return HISTOGRAM_LOW + HISTOGRAM_BINS - 1;
+}
+
+/**
+ * @brief Process one column file
+ * @return false if the file cannot be read
+ */
+static bool processFile(const char *path, const PackConfig &config, uint16_t thresholdRaw,
+                        float alarmZ, uint64_t *histogram, PackReport &report) {
+    ColumnReader reader;
+    if (!reader.open(path)) {
+        return false;
+    }
+
+    PackCounters counters = {};
+    setCountersSoc(config, counters, 100.0f);
+    AnomalyState anomaly;
+    resetAnomaly(anomaly, ANOMALY_WINDOW, alarmZ);
+
+    std::vector<PackStats> stats(reader.blockRows());
+    std::vector<uint8_t> valid(reader.blockRows());
+    std::vector<PackSums> sums(reader.blockRows());
+    std::vector<BalanceMetrics> metrics(reader.blockRows());
+
+    report = PackReport();
+    report.minCell = 1e9f;
+    for (uint32_t block = 0; block < reader.blockCount(); block++) {
+        BatchFrames frames;
+        batchFramesFromBlock(reader, block, frames);
+        report.rows += frames.rows;
+
+        batchPackStats(frames, config, counters, stats.data(), valid.data(), &anomaly);
+        report.alarmMask |= anomaly.alarmMask;
+        batchPackSums(frames, 0, frames.rows, sums.data());
+        batchBalanceMetrics(frames, sums.data(), thresholdRaw, metrics.data());
+
+        for (uint32_t row = 0; row < frames.rows; row++) {
+            if (!valid[row]) {
+                continue;
+            }
+            const PackStats &s = stats[row];
+            report.statRows++;
+            report.aboveSum += metrics[row].aboveCount;
+            if (s.voltageDelta > report.maxDelta) {
+                report.maxDelta = s.voltageDelta;
+            }
+            report.minCell = s.minCellVoltage < report.minCell ? s.minCellVoltage : report.minCell;
+            report.maxCell = s.maxCellVoltage > report.maxCell ? s.maxCellVoltage : report.maxCell;
+            report.energyWh = s.energyWh;
+            report.lastSoc = s.soc;
+        }
+
+        for (uint8_t i = 0; i < frames.cellCount; i++) {
+            batchHistogram(frames.cells[i], frames.rows, HISTOGRAM_LOW, 1, histogram,
+                           HISTOGRAM_BINS);
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    PackConfig config = {1, 100.0f, 0.0f};
+    uint16_t thresholdRaw = 10;
+    float alarmZ = 3.0f;
+
+    int option;
+    while ((option = getopt(argc, argv, "sp:c:b:z:")) != -1) {
+        switch (option) {
+        case 's':
+            batchUseSimd(false);
+            break;
+        case 'p':
+            config.parallelCount = (uint8_t)atoi(optarg);
+            break;
+        case 'c':
+            config.groupCapacityAh = (float)atof(optarg);
+            break;
+        case 'b':
+            thresholdRaw = (uint16_t)atoi(optarg);
+            break;
+        case 'z':
+            alarmZ = (float)atof(optarg);
+            break;
+        default:
+            optind = argc + 1;
+            break;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "usage: %s [-s] [-p P] [-c AH] [-b MV] [-z Z] FILE...\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<uint64_t> histogram(HISTOGRAM_BINS, 0);
+    uint64_t totalRows = 0;
+    int status = 0;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    printf("%-24s %10s %8s %8s %8s %9s %6s %7s %8s\n", "file", "frames", "min V", "max V",
+           "delta mV", "energy Wh", "SOC %", "above", "alarm");
+    for (int i = optind; i < argc; i++) {
+        PackReport report;
+        if (!processFile(argv[i], config, thresholdRaw, alarmZ, histogram.data(), report)) {
+            fprintf(stderr, "%s: not a column file\n", argv[i]);
+            status = 1;
+            continue;
+        }
+        totalRows += report.rows;
+        if (report.statRows == 0) {
+            printf("%-24s %10llu  no complete frames\n", argv[i],
+                   (unsigned long long)report.rows);
+            continue;
+        }
+        printf("%-24s %10llu %8.3f %8.3f %8.0f %9.1f %6.1f %7.2f   0x%05x\n", argv[i],
+               (unsigned long long)report.rows, report.minCell, report.maxCell,
+               report.maxDelta * 1000.0f, report.energyWh, report.lastSoc,
+               (double)report.aboveSum / report.statRows, (unsigned)report.alarmMask);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    uint64_t values = 0;
+    for (int i = 0; i < HISTOGRAM_BINS; i++) {
+        values += histogram[i];
+    }
+    if (values > 0) {
+        printf("cells: %llu values, p0.1 %d  p1 %d  p50 %d  p99 %d  p99.9 %d mV\n",
+               (unsigned long long)values, percentile(histogram.data(), values, 0.001),
+               percentile(histogram.data(), values, 0.01),
+               percentile(histogram.data(), values, 0.5),
+               percentile(histogram.data(), values, 0.99),
+               percentile(histogram.data(), values, 0.999));
+    }
+    fprintf(stderr, "%llu frames in %.2f s (%.1f M frames/s, %s)\n",
+            (unsigned long long)totalRows, seconds, totalRows / seconds / 1e6,
+            batchSimdEnabled() ? "AVX2" : "scalar");
+    return status;
+}
@@ -0,0 +1,604 @@
+/**
+ * @file ingestd.cpp
+ * @brief Multi-pack telemetry ingest daemon for Linux gateways
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Reads link-framed telemetry (pb7200_link.h) from TCP clients and
+ * serial lines with one epoll loop, which only reads: the bytes go to a
+ * pool of workers that do the rest. Connections are sharded across the
+ * workers, each deframing (and checking the CRC of) its own byte
+ * streams, and packs are sharded by id: every frame is handed to the
+ * worker owning its pack, which decodes it with the library's
+ * decodeTelemetry(). Each worker owns its connections' decoders and its
+ * packs' state and files outright, so frames of one pack stay in order
+ * and workers only meet on the queues, which are handed over in batches;
+ * throughput scales with the number of cores.
+ *
+ * Every decoded frame updates the pack's latest-state table entry and,
+ * with -o, is appended as one row to the pack's column file
+ * (pb7200_columns.h) in the output directory, ready for queries. Row
+ * times are the wall-clock time at startup plus the monotonic time since,
+ * and never go back within a pack, so a clock step can't make the column
+ * files reject rows.
+ *
+ * Build from the library root:
+ *   g++ -std=c++11 -O2 -pthread -I. -Iextras/host extras/host/ingestd.cpp \
+ *       extras/host/pb7200_columns.cpp PB7200Telemetry.cpp PB7200Storage.cpp -o ingestd
+ *
+ * Usage:
+ *   ./ingestd [-p port] [-w workers] [-o directory] [-s status seconds] [serial...]
+ *   ./telemetry_gen -c 127.0.0.1:7200 -n 200     (see telemetry_gen.cpp)
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "PB7200Telemetry.h"
+#include "pb7200_columns.h"
+#include "pb7200_link.h"
+
+#define DEFAULT_PORT 7200
+#define MAX_EVENTS 64
+#define READ_CHUNK 65536
+
+/**
+ * @brief One received frame
+ */
+struct FrameJob {
+    uint64_t receivedUs;
+    uint16_t packId;
+    uint8_t length;
+    uint8_t data[255];
+};
+
+/**
+ * @brief Bytes read from one connection in one epoll round
+ */
+struct RawChunk {
+    uint32_t connection;
+    uint64_t receivedUs;
+    uint32_t offset;         // Into the batch's bytes
+    uint32_t length;         // 0 once the connection has closed
+};
+
+/**
+ * @brief Chunks of one epoll round for one worker, with their bytes
+ */
+struct RawBatch {
+    std::vector<RawChunk> chunks;
+    std::vector<uint8_t> bytes;
+};
+
+/**
+ * @brief Latest state of one pack
+ */
+struct PackState {
+    TelemetryView view;
+    uint64_t lastUs;
+    uint32_t frames;
+    uint32_t decodeErrors;
+    ColumnWriter columns;
+};
+
+/**
+ * @brief Worker: queues, connections, packs and column files of one shard
+ */
+struct Shard {
+    std::mutex queueLock;
+    std::condition_variable ready;
+    RawBatch raw;                  // From the epoll loop, for this shard's connections
+    std::vector<FrameJob> queue;   // From any worker, for this shard's packs
+    bool stopping;
+
+    std::unordered_map<uint32_t, LinkDecoder> decoders;  // Worker only
+
+    std::mutex stateLock;  // Only taken for status reports
+    std::unordered_map<uint16_t, PackState> packs;
+
+    const char *outputDir;
+    std::atomic<uint64_t> frames;
+    std::atomic<uint64_t> decodeErrors;
+    std::atomic<uint64_t> writeErrors;
+    std::atomic<uint64_t> linkErrors;
+
+    Shard()
+        : stopping(false), outputDir(nullptr), frames(0), decodeErrors(0), writeErrors(0),
+          linkErrors(0) {}
+};
+
+/**
+ * @brief One epoll source
+ */
+struct Connection {
+    int fd;
+    uint32_t id;
+    bool listener;
+    char name[64];
+};
+
+static std::atomic<bool> running(true);
+
+static void onSignal(int) {
+    running = false;
+}
+
+static uint64_t clockUs(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief Get the time for received frames (µs since the epoch)
+ *
+ * Wall-clock time is read once; after that time follows the monotonic
+ * clock, so an NTP step or a manual clock change can't move it back.
+ */
+static uint64_t receiveUs() {
+    static const uint64_t offset = clockUs(CLOCK_REALTIME) - clockUs(CLOCK_MONOTONIC);
+    return offset + clockUs(CLOCK_MONOTONIC);
+}
+
+/**
+ * @brief Hand raw chunks to a shard's worker
+ */
+static void queueRaw(Shard *shard, RawBatch &raw) {
+    bool idle;
+    {
+        std::lock_guard<std::mutex> lock(shard->queueLock);
+        idle = shard->raw.chunks.empty() && shard->queue.empty();
+        if (shard->raw.chunks.empty()) {
+            shard->raw.chunks.swap(raw.chunks);
+            shard->raw.bytes.swap(raw.bytes);
+        } else {
+            // Offsets are relative to the bytes already queued
+            uint32_t base = (uint32_t)shard->raw.bytes.size();
+            for (size_t i = 0; i < raw.chunks.size(); i++) {
+                raw.chunks[i].offset += base;
+            }
+            shard->raw.chunks.insert(shard->raw.chunks.end(), raw.chunks.begin(),
+                                     raw.chunks.end());
+            shard->raw.bytes.insert(shard->raw.bytes.end(), raw.bytes.begin(), raw.bytes.end());
+        }
+    }
+    raw.chunks.clear();
+    raw.bytes.clear();
+    // A worker with queued work is awake or about to take it
+    if (idle) {
+        shard->ready.notify_one();
+    }
+}
+
+/**
+ * @brief Hand frames to the worker owning their packs
+ */
+static void queueFrames(Shard *shard, std::vector<FrameJob> &jobs) {
+    bool idle;
+    {
+        std::lock_guard<std::mutex> lock(shard->queueLock);
+        idle = shard->raw.chunks.empty() && shard->queue.empty();
+        if (shard->queue.empty()) {
+            shard->queue.swap(jobs);
+        } else {
+            shard->queue.insert(shard->queue.end(), jobs.begin(), jobs.end());
+        }
+    }
+    jobs.clear();
+    if (idle) {
+        shard->ready.notify_one();
+    }
+}
+
+/**
+ * @brief Deframe the byte streams of a shard's connections
+ * @param routed Frames found, per shard of their packs
+ */
+static void deframe(Shard *shard, const RawBatch &raw,
+                    std::vector<std::vector<FrameJob> > &routed) {
+    for (size_t i = 0; i < raw.chunks.size(); i++) {
+        const RawChunk &chunk = raw.chunks[i];
+        if (chunk.length == 0) {
+            shard->decoders.erase(chunk.connection);
+            continue;
+        }
+
+        LinkDecoder &decoder = shard->decoders[chunk.connection];
+        uint32_t errors = decoder.crcErrors();
+        decoder.feed(&raw.bytes[chunk.offset], chunk.length,
+            [&](uint16_t packId, const uint8_t *frame, uint8_t length) {
+                std::vector<FrameJob> &jobs = routed[packId % routed.size()];
+                jobs.resize(jobs.size() + 1);
+                FrameJob &job = jobs.back();
+                job.receivedUs = chunk.receivedUs;
+                job.packId = packId;
+                job.length = length;
+                memcpy(job.data, frame, length);
+            });
+        shard->linkErrors += decoder.crcErrors() - errors;
+    }
+}
+
+/**
+ * @brief Decode frames of a shard's packs and append their rows
+ */
+static void decodeFrames(Shard *shard, const std::vector<FrameJob> &batch) {
+    std::lock_guard<std::mutex> lock(shard->stateLock);
+    for (size_t i = 0; i < batch.size(); i++) {
+        const FrameJob &job = batch[i];
+        PackState &state = shard->packs[job.packId];
+        if (state.frames == 0 && state.decodeErrors == 0) {
+            resetTelemetryView(state.view);
+        }
+
+        if (!decodeTelemetry(job.data, job.length, state.view)) {
+            state.decodeErrors++;
+            shard->decodeErrors++;
+            continue;
+        }
+        state.frames++;
+        shard->frames++;
+
+        // Frames of a pack arriving on two connections may be timed out of order
+        uint64_t us = job.receivedUs > state.lastUs ? job.receivedUs : state.lastUs;
+        if (shard->outputDir != nullptr) {
+            if (!state.columns.isOpen()) {
+                char path[512];
+                snprintf(path, sizeof(path), "%s/pack-%05u.pbc", shard->outputDir, job.packId);
+                state.columns.open(path, job.packId);
+            }
+            // A file from an earlier run may end after this run's clock
+            if (state.columns.lastTime() > us) {
+                us = state.columns.lastTime();
+            }
+            if (!state.columns.append(us, state.view)) {
+                shard->writeErrors++;
+            }
+        }
+        state.lastUs = us;
+    }
+}
+
+/**
+ * @brief Deframe and decode for one shard until shutdown
+ */
+static void workerLoop(Shard *shard, const std::vector<Shard *> *shards) {
+    RawBatch raw;
+    std::vector<FrameJob> batch;
+    std::vector<std::vector<FrameJob> > routed(shards->size());
+
+    while (true) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(shard->queueLock);
+            shard->ready.wait_for(lock, std::chrono::milliseconds(200), [shard] {
+                return !shard->raw.chunks.empty() || !shard->queue.empty() || shard->stopping;
+            });
+            raw.chunks.swap(shard->raw.chunks);
+            raw.bytes.swap(shard->raw.bytes);
+            batch.swap(shard->queue);
+            stopping = shard->stopping;
+        }
+        if (raw.chunks.empty() && batch.empty()) {
+            if (stopping) {
+                break;
+            }
+            continue;
+        }
+
+        if (!raw.chunks.empty()) {
+            deframe(shard, raw, routed);
+            for (size_t w = 0; w < routed.size(); w++) {
+                if ((*shards)[w] == shard) {
+                    // Own packs: decoded below, after the frames queued before them
+                    batch.insert(batch.end(), routed[w].begin(), routed[w].end());
+                    routed[w].clear();
+                } else if (!routed[w].empty()) {
+                    queueFrames((*shards)[w], routed[w]);
+                }
+            }
+            raw.chunks.clear();
+            raw.bytes.clear();
+        }
+        if (!batch.empty()) {
+            decodeFrames(shard, batch);
+            batch.clear();
+        }
+    }
+}
+
+/**
+ * @brief Put a descriptor in non-blocking mode
+ */
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+ * @brief Open a serial line or pty in raw mode
+ */
+static int openSerial(const char *path) {
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+        return -1;
+    }
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
+
+/**
+ * @brief Open the TCP listening socket
+ */
+static int openListener(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 128) != 0 ||
+        !setNonBlocking(fd)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Register a source with epoll
+ */
+static Connection *addSource(int epollFd, int fd, bool listener, const char *name) {
+    static uint32_t nextId = 0;
+    Connection *conn = new Connection();
+    conn->fd = fd;
+    conn->id = nextId++;
+    conn->listener = listener;
+    snprintf(conn->name, sizeof(conn->name), "%s", name);
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = conn;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        delete conn;
+        return nullptr;
+    }
+    return conn;
+}
+
+/**
+ * @brief Print throughput and pack counts
+ */
+static void printStatus(std::vector<Shard *> &shards, uint64_t &lastFrames, double seconds) {
+    uint64_t frames = 0;
+    uint64_t errors = 0;
+    uint64_t writeErrors = 0;
+    uint64_t linkErrors = 0;
+    size_t packs = 0;
+    size_t faulted = 0;
+
+    for (size_t i = 0; i < shards.size(); i++) {
+        frames += shards[i]->frames;
+        errors += shards[i]->decodeErrors;
+        writeErrors += shards[i]->writeErrors;
+        linkErrors += shards[i]->linkErrors;
+        std::lock_guard<std::mutex> lock(shards[i]->stateLock);
+        packs += shards[i]->packs.size();
+        for (auto &entry : shards[i]->packs) {
+            faulted += entry.second.view.faultStatus != 0;
+        }
+    }
+
+    printf("packs %zu (faulted %zu)  frames %llu  %.0f frames/s  decode errors %llu  "
+           "link CRC errors %llu  write errors %llu\n",
+           packs, faulted, (unsigned long long)frames, (frames - lastFrames) / seconds,
+           (unsigned long long)errors, (unsigned long long)linkErrors,
+           (unsigned long long)writeErrors);
+    fflush(stdout);
+    lastFrames = frames;
+}
+
+int main(int argc, char **argv) {
+    uint16_t port = DEFAULT_PORT;
+    unsigned workers = std::thread::hardware_concurrency();
+    const char *outputDir = nullptr;
+    int statusSeconds = 5;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "p:w:o:s:")) != -1) {
+        switch (opt) {
+            case 'p':
+                port = (uint16_t)atoi(optarg);
+                break;
+            case 'w':
+                workers = (unsigned)atoi(optarg);
+                break;
+            case 'o':
+                outputDir = optarg;
+                break;
+            case 's':
+                statusSeconds = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-p port] [-w workers] [-o directory] "
+                                "[-s status seconds] [serial...]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (workers == 0) {
+        workers = 1;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    int epollFd = epoll_create1(0);
+    int listenFd = openListener(port);
+    if (epollFd < 0 || listenFd < 0 || addSource(epollFd, listenFd, true, "listener") == nullptr) {
+        perror("listen");
+        return 1;
+    }
+    printf("listening on port %u, %u workers\n", port, workers);
+
+    for (int i = optind; i < argc; i++) {
+        int fd = openSerial(argv[i]);
+        if (fd < 0 || addSource(epollFd, fd, false, argv[i]) == nullptr) {
+            fprintf(stderr, "cannot open %s: %s\n", argv[i], strerror(errno));
+            return 1;
+        }
+        printf("reading %s\n", argv[i]);
+    }
+
+    std::vector<Shard *> shards;
+    std::vector<std::thread> threads;
+    for (unsigned w = 0; w < workers; w++) {
+        Shard *shard = new Shard();
+        shard->outputDir = outputDir;
+        shards.push_back(shard);
+    }
+    for (unsigned w = 0; w < workers; w++) {
+        threads.push_back(std::thread(workerLoop, shards[w], &shards));
+    }
+
+    // Bytes are collected per shard for one epoll round, then handed over in one lock
+    std::vector<RawBatch> pending(workers);
+    std::vector<Connection *> closed;
+    static uint8_t buffer[READ_CHUNK];
+    uint64_t lastFrames = 0;
+    uint64_t lastStatus = clockUs(CLOCK_MONOTONIC);
+
+    while (running) {
+        struct epoll_event events[MAX_EVENTS];
+        int count = epoll_wait(epollFd, events, MAX_EVENTS, 100);
+        if (count < 0 && errno != EINTR) {
+            perror("epoll_wait");
+            break;
+        }
+
+        for (int e = 0; e < count; e++) {
+            Connection *conn = (Connection *)events[e].data.ptr;
+
+            if (conn->listener) {
+                int fd;
+                while ((fd = accept(listenFd, nullptr, nullptr)) >= 0) {
+                    setNonBlocking(fd);
+                    char name[32];
+                    snprintf(name, sizeof(name), "tcp:%d", fd);
+                    if (addSource(epollFd, fd, false, name) == nullptr) {
+                        close(fd);
+                    }
+                }
+                continue;
+            }
+
+            RawBatch &raw = pending[conn->id % workers];
+            RawChunk chunk;
+            chunk.connection = conn->id;
+            chunk.receivedUs = receiveUs();
+            while (true) {
+                ssize_t n = read(conn->fd, buffer, sizeof(buffer));
+                if (n > 0) {
+                    chunk.offset = (uint32_t)raw.bytes.size();
+                    chunk.length = (uint32_t)n;
+                    raw.chunks.push_back(chunk);
+                    raw.bytes.insert(raw.bytes.end(), buffer, buffer + n);
+                    continue;
+                }
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    break;
+                }
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+
+                // End of stream or error (ptys report EIO once the writer closes)
+                closed.push_back(conn);
+                break;
+            }
+        }
+
+        // The worker drops a connection's decoder after its last bytes
+        for (size_t i = 0; i < closed.size(); i++) {
+            RawBatch &raw = pending[closed[i]->id % workers];
+            RawChunk chunk = {closed[i]->id, 0, (uint32_t)raw.bytes.size(), 0};
+            raw.chunks.push_back(chunk);
+        }
+
+        for (unsigned w = 0; w < workers; w++) {
+            if (!pending[w].chunks.empty()) {
+                queueRaw(shards[w], pending[w]);
+            }
+        }
+
+        for (size_t i = 0; i < closed.size(); i++) {
+            Connection *conn = closed[i];
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, conn->fd, nullptr);
+            close(conn->fd);
+            printf("%s closed\n", conn->name);
+            delete conn;
+        }
+        closed.clear();
+
+        uint64_t now = clockUs(CLOCK_MONOTONIC);
+        if (statusSeconds > 0 && now - lastStatus >= (uint64_t)statusSeconds * 1000000ULL) {
+            printStatus(shards, lastFrames, (now - lastStatus) / 1e6);
+            lastStatus = now;
+        }
+    }
+
+    // Workers finish their bytes and frames, then stop
+    for (size_t i = 0; i < shards.size(); i++) {
+        {
+            std::lock_guard<std::mutex> lock(shards[i]->queueLock);
+            shards[i]->stopping = true;
+        }
+        shards[i]->ready.notify_one();
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    // Frames routed to a worker that had already stopped
+    for (size_t i = 0; i < shards.size(); i++) {
+        decodeFrames(shards[i], shards[i]->queue);
+    }
+
+    printStatus(shards, lastFrames, 1.0);
+
+    // Unmaps the column files; the kernel writes back what is left
+    for (size_t i = 0; i < shards.size(); i++) {
+        delete shards[i];
+    }
+    return 0;
+}
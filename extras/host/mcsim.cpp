@@ -0,0 +1,428 @@
+/**
+ * @file mcsim.cpp
+ * @brief Monte-Carlo evaluation of balancing, SOC and protection
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Runs many randomized packs through the same current profile, each
+ * with the unmodified PB7200P80 driver on a PB7200SimChip fed by a
+ * PackModel, spread over a thread pool. Every run draws its own cell
+ * capacity, resistance, leakage and SOC spread, current sensor offset
+ * and initial SOC error; the chip adds measurement noise and random
+ * bus errors. The driver balances the top cells while the pack charges
+ * or rests, as in cyclesim.
+ *
+ * Per run it measures:
+ *   - convergence: settling time of the cells' true open-circuit
+ *     voltage spread, i.e. when it last came within a target (-C) and
+ *     stayed there; the driver stops bleeding once its measured spread is
+ *     under the balancing threshold (-B), so the target should sit a
+ *     little above it
+ *   - SOC error: driver SOC minus the cells' mean true SOC, at the end
+ *     and the largest seen at any update
+ *   - trips: newly latched fault bits; false when the true cell
+ *     voltages, temperatures and current are inside the chip limits
+ * and prints their distributions over all runs (mean, 5th, 50th and
+ * 95th percentile, max), so a change to the driver's algorithms can be
+ * judged on thousands of packs rather than one.
+ *
+ * Build from the library root:
+ *   g++ -std=c++11 -O2 -pthread -Iextras/host/arduino -I. -Iextras/host \
+ *       extras/host/mcsim.cpp extras/host/pb7200_simbench.cpp \
+ *       extras/host/pb7200_simchip.cpp extras/host/pb7200_faults.cpp \
+ *       extras/host/pb7200_packmodel.cpp extras/host/pb7200_profile.cpp \
+ *       extras/host/arduino/Arduino.cpp PB7200P80.cpp PB7200Stats.cpp \
+ *       PB7200Format.cpp PB7200Storage.cpp -o mcsim
+ *
+ * Usage:
+ *   ./mcsim [-n runs] [-t threads] [-p profile] [-s cells] [-a Ah]
+ *           [-q SOC spread %] [-k capacity spread %] [-r resistance spread %]
+ *           [-m leakage spread mA] [-e initial SOC error %]
+ *           [-V cell noise mV] [-I current noise mA] [-O current offset mA]
+ *           [-E bus error rate] [-P OVP limit V] [-B balance mV]
+ *           [-C convergence mV] [-u update ms] [-T step ms] [-R seed]
+ *           [-o per-run csv]
+ *
+ * Spreads, noise and offsets are standard deviations.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "PB7200P80.h"
+#include "pb7200_profile.h"
+#include "pb7200_simbench.h"
+
+// Charge from 60 %, then balance through a long rest
+#define DEFAULT_PROFILE "charge 25 4.15 1; rest 21600"
+
+/**
+ * @brief Harness settings
+ */
+struct Options {
+    uint32_t runs;
+    unsigned threads;
+    std::string profile;
+    uint8_t cells;
+    float capacityAh;
+    float socSpread;
+    float capacitySpread;
+    float resistanceSpread;
+    float leakageSpread;
+    float socError;
+    float cellNoise;
+    float currentNoise;
+    float currentOffset;
+    float busErrorRate;
+    float ovpLimit;
+    uint16_t balanceMv;
+    float convergeMv;
+    uint32_t updateMs;
+    uint32_t stepMs;
+    uint32_t seed;
+    const char *csv;
+};
+
+/**
+ * @brief Outcome of one run
+ */
+struct RunResult {
+    float convergeS;         // Settling time (s), negative if outside at the end
+    float finalSpreadMv;     // True OCV spread at the end (mV)
+    float finalSocError;     // Driver minus true SOC at the end (%)
+    float maxSocError;       // Largest |driver - true SOC| seen (%)
+    uint16_t trueTrips;      // Fault bits latched by real violations
+    uint16_t falseTrips;     // Fault bits latched inside the limits
+    uint32_t updates;        // update() calls
+    uint32_t failures;       // update() calls that failed
+    float bledAh;            // Charge bled by balancing (Ah)
+    float simSeconds;        // Simulated time (s)
+};
+
+static uint64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Spread of the cells' open-circuit voltages (mV)
+ */
+static float ocvSpreadMv(const PackModel &model) {
+    float lowest = 10.0f;
+    float highest = 0.0f;
+    for (uint8_t i = 0; i < model.cellCount(); i++) {
+        float v = model.ocv(model.cell(i).soc);
+        lowest = v < lowest ? v : lowest;
+        highest = v > highest ? v : highest;
+    }
+    return (highest - lowest) * 1000.0f;
+}
+
+/**
+ * @brief Fault bits the true pack state justifies
+ */
+static uint8_t trueViolations(const PackModel &model, const ProtectionConfig &limits) {
+    uint8_t faults = 0;
+    for (uint8_t i = 0; i < model.cellCount(); i++) {
+        float v = model.cell(i).volts;
+        if (v > limits.overVoltageThreshold) {
+            faults |= PB7200_STATUS_OVP;
+        }
+        if (v < limits.underVoltageThreshold) {
+            faults |= PB7200_STATUS_UVP;
+        }
+    }
+    if (fabsf(model.current()) > limits.overCurrentThreshold) {
+        faults |= PB7200_STATUS_OCP;
+    }
+    if (model.temperature() > limits.overTempThreshold) {
+        faults |= PB7200_STATUS_OTP;
+    }
+    if (model.temperature() < limits.underTempThreshold) {
+        faults |= PB7200_STATUS_UTP;
+    }
+    return faults;
+}
+
+/**
+ * @brief Simulate one randomized pack through the profile
+ */
+static RunResult runPack(uint32_t run, const Options &options, const CurrentProfile &script) {
+    RunResult result;
+    memset(&result, 0, sizeof(result));
+    result.convergeS = -1.0f;
+
+    uint32_t seed = options.seed * 1000003u + run;
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+
+    std::unique_ptr<PB7200SimBench> bench(new PB7200SimBench());
+    CellSpread spread = {options.capacitySpread / 100.0f, options.resistanceSpread / 100.0f,
+                         options.leakageSpread / 1000.0f, options.socSpread / 100.0f};
+    bench->initPack(options.cells, options.capacityAh, 0.6f, 25.0f);
+    bench->model.randomize(spread, seed);
+
+    ProtectionConfig limits = {options.ovpLimit, 2.80f, 100.0f, 60.0f, -20.0f, 0, 0, 0};
+    bench->chip.setLimits(limits);
+    bench->chip.setNoise(options.cellNoise / 1000.0f, 0.2f, options.currentNoise / 1000.0f,
+                         seed ^ 0x5A5A5A5Au);
+    bench->chip.setCurrentOffset(options.currentOffset / 1000.0f * normal(rng));
+    bench->chip.setBusErrorRate(options.busErrorRate);
+
+    bench->bind();
+    // begin() probes the chip, so a bus error may need another try
+    if (!bench->start(options.cells, 3)) {
+        bench->unbind();
+        result.failures = 1;
+        return result;
+    }
+    bench->driver.setStateOfCharge(100.0f * bench->meanSoc() + options.socError * normal(rng));
+
+    CurrentProfile profile = script;
+    profile.restart();
+    const float dt = options.stepMs / 1000.0f;
+    const uint32_t stepUs = options.stepMs * 1000;
+    const uint64_t updateUs = (uint64_t)options.updateMs * 1000;
+    uint64_t lastOutsideUs = 0;
+    uint8_t latched = 0;
+    PackStats stats;
+    memset(&stats, 0, sizeof(stats));
+
+    while (!profile.finished()) {
+        float current = profile.next(bench->model, dt);
+        if (profile.finished()) {
+            break;
+        }
+        bench->step(stepUs, current);
+
+        if (ocvSpreadMv(bench->model) > options.convergeMv) {
+            lastOutsideUs = bench->now();
+        }
+        if (!bench->updateDue(updateUs)) {
+            continue;
+        }
+
+        result.updates++;
+        if (!bench->driver.update()) {
+            result.failures++;
+            continue;
+        }
+        bench->driver.getPackStats(stats);
+
+        float error = fabsf(stats.soc - 100.0f * bench->meanSoc());
+        result.maxSocError = error > result.maxSocError ? error : result.maxSocError;
+
+        // Judge each newly latched fault against the true state, then clear it
+        uint8_t faults = bench->driver.getSnapshot().faultStatus;
+        uint8_t fresh = faults & ~latched;
+        if (fresh != 0) {
+            uint8_t real = trueViolations(bench->model, limits);
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                if (fresh & (1 << bit)) {
+                    if (real & (1 << bit)) {
+                        result.trueTrips++;
+                    } else {
+                        result.falseTrips++;
+                    }
+                }
+            }
+        }
+        latched = faults;
+        if (faults != 0 && bench->driver.clearFaults()) {
+            latched = 0;
+        }
+
+        // Top balancing while charging or resting
+        bool balancing = bench->driver.getSnapshot().balanceMask != 0;
+        if (options.balanceMv > 0 && stats.current >= 0 &&
+            stats.voltageDelta * 1000.0f > options.balanceMv) {
+            bench->driver.balanceTopCells(options.cells / 4 + 1, options.balanceMv);
+        } else if (balancing) {
+            bench->driver.stopAllBalancing();
+        }
+    }
+    bench->unbind();
+
+    result.finalSpreadMv = ocvSpreadMv(bench->model);
+    if (result.finalSpreadMv <= options.convergeMv) {
+        result.convergeS = lastOutsideUs / 1e6f;
+    }
+    result.finalSocError = stats.soc - 100.0f * bench->meanSoc();
+    result.bledAh = bench->model.bledAh();
+    result.simSeconds = bench->now() / 1e6f;
+    return result;
+}
+
+/**
+ * @brief Pool thread: take runs until none are left
+ */
+static void workerLoop(const Options &options, const CurrentProfile &script,
+                       std::atomic<uint32_t> &next, std::vector<RunResult> &results) {
+    for (;;) {
+        uint32_t run = next++;
+        if (run >= options.runs) {
+            break;
+        }
+        results[run] = runPack(run, options, script);
+    }
+}
+
+/**
+ * @brief Print mean and percentiles of a set of values
+ */
+static void printDistribution(const char *name, std::vector<float> values, float scale) {
+    if (values.empty()) {
+        printf("%-22s no samples\n", name);
+        return;
+    }
+    std::sort(values.begin(), values.end());
+    double sum = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        sum += values[i];
+    }
+    size_t n = values.size();
+    printf("%-22s n %-6zu mean %8.3f  p5 %8.3f  p50 %8.3f  p95 %8.3f  max %8.3f\n", name, n,
+           sum / n * scale, values[n * 5 / 100] * scale, values[n / 2] * scale,
+           values[n * 95 / 100] * scale, values[n - 1] * scale);
+}
+
+static void usage(const char *name) {
+    fprintf(stderr,
+            "usage: %s [-n runs] [-t threads] [-p profile] [-s cells] [-a Ah]\n"
+            "          [-q SOC spread %%] [-k capacity spread %%] [-r resistance spread %%]\n"
+            "          [-m leakage spread mA] [-e initial SOC error %%]\n"
+            "          [-V cell noise mV] [-I current noise mA] [-O current offset mA]\n"
+            "          [-E bus error rate] [-P OVP limit V] [-B balance mV]\n"
+            "          [-C convergence mV] [-u update ms] [-T step ms] [-R seed]\n"
+            "          [-o per-run csv]\n",
+            name);
+}
+
+int main(int argc, char **argv) {
+    Options options = {1000, std::thread::hardware_concurrency(), DEFAULT_PROFILE, 16, 50.0f,
+                       0.5f, 1.0f, 5.0f, 0.0f, 0.0f, 2.0f, 50.0f, 20.0f, 0.0f, 4.20f,
+                       10, 15.0f, 1000, 1000, 1, nullptr};
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:t:p:s:a:q:k:r:m:e:V:I:O:E:P:B:C:u:T:R:o:")) != -1) {
+        switch (opt) {
+            case 'n': options.runs = (uint32_t)atoi(optarg); break;
+            case 't': options.threads = (unsigned)atoi(optarg); break;
+            case 'p': options.profile = optarg; break;
+            case 's': options.cells = (uint8_t)atoi(optarg); break;
+            case 'a': options.capacityAh = atof(optarg); break;
+            case 'q': options.socSpread = atof(optarg); break;
+            case 'k': options.capacitySpread = atof(optarg); break;
+            case 'r': options.resistanceSpread = atof(optarg); break;
+            case 'm': options.leakageSpread = atof(optarg); break;
+            case 'e': options.socError = atof(optarg); break;
+            case 'V': options.cellNoise = atof(optarg); break;
+            case 'I': options.currentNoise = atof(optarg); break;
+            case 'O': options.currentOffset = atof(optarg); break;
+            case 'E': options.busErrorRate = atof(optarg); break;
+            case 'P': options.ovpLimit = atof(optarg); break;
+            case 'B': options.balanceMv = (uint16_t)atoi(optarg); break;
+            case 'C': options.convergeMv = atof(optarg); break;
+            case 'u': options.updateMs = (uint32_t)atoi(optarg); break;
+            case 'T': options.stepMs = (uint32_t)atoi(optarg); break;
+            case 'R': options.seed = (uint32_t)atoi(optarg); break;
+            case 'o': options.csv = optarg; break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if (options.runs == 0 || options.cells < 1 || options.cells > 16 ||
+        options.capacityAh <= 0 || options.updateMs == 0 || options.stepMs == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (options.threads == 0) {
+        options.threads = 1;
+    }
+
+    CurrentProfile script;
+    if (!script.parse(options.profile.c_str()) || script.stepCount() == 0) {
+        fprintf(stderr, "bad profile: %s\n", options.profile.c_str());
+        return 1;
+    }
+
+    std::vector<RunResult> results(options.runs);
+    std::atomic<uint32_t> next(0);
+    std::vector<std::thread> threads;
+    uint64_t start = monotonicNs();
+    for (unsigned t = 0; t < options.threads; t++) {
+        threads.emplace_back(workerLoop, std::cref(options), std::cref(script), std::ref(next),
+                             std::ref(results));
+    }
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+    double wall = (monotonicNs() - start) / 1e9;
+
+    if (options.csv != nullptr) {
+        FILE *csv = fopen(options.csv, "w");
+        if (csv == nullptr) {
+            perror(options.csv);
+            return 1;
+        }
+        fprintf(csv, "run,converge_s,final_spread_mv,final_soc_error_pct,max_soc_error_pct,"
+                     "true_trips,false_trips,updates,failures,bled_ah\n");
+        for (uint32_t i = 0; i < options.runs; i++) {
+            const RunResult &r = results[i];
+            fprintf(csv, "%u,%.0f,%.2f,%.3f,%.3f,%u,%u,%u,%u,%.4f\n", i, r.convergeS,
+                    r.finalSpreadMv, r.finalSocError, r.maxSocError, r.trueTrips, r.falseTrips,
+                    r.updates, r.failures, r.bledAh);
+        }
+        fclose(csv);
+    }
+
+    std::vector<float> converge, spread, finalError, maxError;
+    uint32_t unconverged = 0, falseRuns = 0, trueRuns = 0;
+    uint64_t falseTrips = 0, updates = 0, failures = 0;
+    double simSeconds = 0;
+    for (uint32_t i = 0; i < options.runs; i++) {
+        const RunResult &r = results[i];
+        if (r.convergeS >= 0) {
+            converge.push_back(r.convergeS);
+        } else {
+            unconverged++;
+        }
+        spread.push_back(r.finalSpreadMv);
+        finalError.push_back(fabsf(r.finalSocError));
+        maxError.push_back(r.maxSocError);
+        falseRuns += r.falseTrips > 0;
+        trueRuns += r.trueTrips > 0;
+        falseTrips += r.falseTrips;
+        updates += r.updates;
+        failures += r.failures;
+        simSeconds += r.simSeconds;
+    }
+
+    printf("%u runs of %u cells on %u threads: %.0f pack-hours in %.1f s (x%.0f)\n",
+           options.runs, options.cells, options.threads, simSeconds / 3600.0, wall,
+           wall > 0 ? simSeconds / wall : 0.0);
+    printDistribution("convergence (h)", converge, 1.0f / 3600.0f);
+    printf("%-22s %u of %u runs\n", "not converged", unconverged, options.runs);
+    printDistribution("final OCV spread (mV)", spread, 1.0f);
+    printDistribution("final |SOC error| (%)", finalError, 1.0f);
+    printDistribution("max |SOC error| (%)", maxError, 1.0f);
+    printf("%-22s %u runs (%.2f %%), %.3f per pack-hour; real trips in %u runs\n",
+           "false trips", falseRuns, 100.0 * falseRuns / options.runs,
+           simSeconds > 0 ? falseTrips * 3600.0 / simSeconds : 0.0, trueRuns);
+    printf("%-22s %llu of %llu (%.3f %%)\n", "failed updates", (unsigned long long)failures,
+           (unsigned long long)updates, updates > 0 ? 100.0 * failures / updates : 0.0);
+    return 0;
+}
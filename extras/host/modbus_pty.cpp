@@ -0,0 +1,132 @@
+/**
+ * @file modbus_pty.cpp
+ * @brief Serve PB7200ModbusSlave on a Linux pseudo-terminal
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ * 
+ * Creates a pty and answers Modbus RTU requests on it from a synthetic
+ * snapshot, so masters (mbpoll, pymodbus, SCADA test tools) can be
+ * pointed at the printed device path. Limits written by the master are
+ * printed as they arrive.
+ * 
+ * Build from the library root:
+ *   g++ -std=c++11 -O2 -I. extras/host/modbus_pty.cpp PB7200Modbus.cpp -o modbus_pty
+ * 
+ * Usage:
+ *   ./modbus_pty [slave address] [cells]
+ *   mbpoll -m rtu -a 1 -t 3 -r 1 -c 15 -b 9600 -P none /dev/pts/N
+ */
+
+#define _XOPEN_SOURCE 600
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "PB7200Modbus.h"
+
+// Silence that ends a frame (3.5 characters at 9600 baud, rounded up)
+#define FRAME_GAP_US 4000
+
+static void onWrite(uint16_t address, uint16_t count, void *context) {
+    PB7200ModbusSlave *slave = (PB7200ModbusSlave *)context;
+    ProtectionConfig config;
+    slave->getLimits(config);
+    printf("holding %u..%u written: OV %.3f V, UV %.3f V, OC %.2f A, OT %.1f C, UT %.1f C\n",
+           address, address + count - 1, config.overVoltageThreshold,
+           config.underVoltageThreshold, config.overCurrentThreshold,
+           config.overTempThreshold, config.underTempThreshold);
+    fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    uint8_t address = argc > 1 ? (uint8_t)atoi(argv[1]) : 1;
+    uint8_t cells = argc > 2 ? (uint8_t)atoi(argv[2]) : 4;
+    if (cells == 0 || cells > PB7200_MAX_CELLS) {
+        fprintf(stderr, "cells must be 1-%d\n", PB7200_MAX_CELLS);
+        return 1;
+    }
+
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+        perror("pty");
+        return 1;
+    }
+
+    // Raw bytes, no echo or line discipline
+    struct termios tio;
+    tcgetattr(fd, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(fd, TCSANOW, &tio);
+    printf("Modbus slave %u on %s\n", address, ptsname(fd));
+    fflush(stdout);
+
+    PackSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.cellCount = cells;
+    snapshot.tempCount = 2;
+    PackStats stats;
+    memset(&stats, 0, sizeof(stats));
+
+    ProtectionConfig limits = {4.20, 2.80, 10.0, 60.0, -10.0, 100, 100, 50};
+    PB7200ModbusSlave slave(address);
+    slave.setSource(&snapshot, &stats);
+    slave.setLimits(limits);
+    slave.setWriteCallback(onWrite, &slave);
+
+    uint8_t request[PB7200_MODBUS_MAX_FRAME];
+    uint8_t response[PB7200_MODBUS_MAX_FRAME];
+    uint16_t length = 0;
+
+    while (true) {
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        FD_SET(fd, &readSet);
+        struct timeval timeout = {0, FRAME_GAP_US};
+        int ready = select(fd + 1, &readSet, nullptr, nullptr, &timeout);
+        if (ready < 0) {
+            perror("select");
+            return 1;
+        }
+
+        if (ready > 0) {
+            uint8_t chunk[64];
+            ssize_t n = read(fd, chunk, sizeof(chunk));
+            if (n <= 0) {
+                // No master connected yet
+                usleep(FRAME_GAP_US);
+                continue;
+            }
+            for (ssize_t i = 0; i < n && length < PB7200_MODBUS_MAX_FRAME; i++) {
+                request[length++] = chunk[i];
+            }
+            continue;
+        }
+
+        if (length == 0) {
+            continue;
+        }
+
+        // Refresh the simulated pack between requests
+        uint32_t now = (uint32_t)time(nullptr);
+        for (uint8_t i = 0; i < cells; i++) {
+            snapshot.cellRaw[i] = 3600 + (uint16_t)((now + i * 7) % 40);
+        }
+        snapshot.tempRaw[0] = 250 + (int16_t)(now % 20);
+        snapshot.tempRaw[1] = 240;
+        snapshot.currentRaw = -150;
+        snapshot.sequence++;
+        stats.soc = 80.0;
+
+        uint16_t responseLength = slave.handleFrame(request, length, response);
+        length = 0;
+        if (responseLength > 0 && write(fd, response, responseLength) < 0) {
+            perror("write");
+        }
+    }
+}
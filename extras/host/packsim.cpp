@@ -0,0 +1,504 @@
+/**
+ * @file packsim.cpp
+ * @brief Many-device simulator: real drivers on simulated chips and packs
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Every virtual pack runs the unmodified PB7200P80 driver against a
+ * PB7200SimChip fed by an equivalent-circuit PackModel, and sends the
+ * driver's snapshots as telemetry frames (PB7200TelemetryPacker, framed
+ * by pb7200_link.h) to ingestd, like a gateway full of real nodes.
+ *
+ * Time is simulated: all packs step together on a worker pool, and each
+ * driver sees its own clock (extras/host/arduino), which also moves with
+ * bus transfers and while the driver waits for its chip. With -x the
+ * simulation is paced to a multiple of real time; the status line then
+ * shows where it stops keeping up (lag) and how long sends block on the
+ * daemon (send wait), which is where the ingest pipeline saturates.
+ *
+ * Build from the library root:
+ *   g++ -std=c++11 -O2 -pthread -Iextras/host/arduino -I. -Iextras/host \
+ *       extras/host/packsim.cpp extras/host/pb7200_simbench.cpp \
+ *       extras/host/pb7200_simchip.cpp extras/host/pb7200_faults.cpp \
+ *       extras/host/pb7200_packmodel.cpp extras/host/arduino/Arduino.cpp \
+ *       PB7200P80.cpp PB7200Stats.cpp PB7200Format.cpp PB7200Storage.cpp \
+ *       PB7200Telemetry.cpp -o packsim
+ *
+ * Usage:
+ *   ./packsim [-c host:port] [-k connections] [-n packs] [-t threads]
+ *             [-r updates/s per pack] [-x speed, 0 = flat out] [-d sim seconds]
+ *             [-R ramp sim seconds] [-s cells] [-B balance mV] [-b budget]
+ *             [-T step ms] [-C]
+ *
+ * Without -c frames are built but not sent. -R adds packs evenly over
+ * the first seconds of the run; -C uses coherent (triggered)
+ * acquisition; -B balances the top cells while charging.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "PB7200P80.h"
+#include "PB7200Telemetry.h"
+#include "pb7200_link.h"
+#include "pb7200_simbench.h"
+
+// Drive profile: segment length range (s) and current range (C-rate)
+#define PROFILE_MIN_S 60
+#define PROFILE_MAX_S 900
+#define PROFILE_MAX_C 0.5f
+
+// Cell voltages at which the profile turns around (V)
+#define PROFILE_HIGH_V 4.15f
+#define PROFILE_LOW_V 3.35f
+
+/**
+ * @brief Simulator settings
+ */
+struct Options {
+    const char *host;
+    uint16_t port;
+    bool send;
+    unsigned connections;
+    unsigned packs;
+    unsigned threads;
+    double rate;
+    double speed;
+    double seconds;
+    double ramp;
+    uint8_t cells;
+    uint16_t balanceMv;
+    uint8_t budget;
+    uint32_t stepMs;
+    bool coherent;
+};
+
+/**
+ * @brief One virtual pack: simulated bench, telemetry and drive profile
+ */
+struct Device {
+    uint16_t id;
+    PB7200SimBench bench;
+    PB7200TelemetryPacker packer;
+    std::mt19937 rng;
+    float capacityAh;
+    float current;
+    uint64_t segmentEndUs;
+    uint64_t joinUs;
+    bool started;
+};
+
+/**
+ * @brief Work of one pool thread
+ */
+struct Worker {
+    std::vector<Device *> devices;
+    std::vector<int> fds;
+    std::vector<std::vector<uint8_t> > buffers;
+    uint64_t frames;
+    uint64_t bytes;
+    uint64_t failures;
+    uint64_t sendNs;
+    uint64_t busyNs;
+};
+
+/**
+ * @brief Reusable barrier for the pool and the clock thread
+ */
+class StepBarrier {
+public:
+    explicit StepBarrier(unsigned count) : _count(count), _waiting(0), _generation(0) {}
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        unsigned generation = _generation;
+        if (++_waiting == _count) {
+            _waiting = 0;
+            _generation++;
+            _cv.notify_all();
+            return;
+        }
+        _cv.wait(lock, [&] { return generation != _generation; });
+    }
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    unsigned _count;
+    unsigned _waiting;
+    unsigned _generation;
+};
+
+static std::atomic<bool> running(true);
+
+static void onSignal(int) {
+    running = false;
+}
+
+static uint64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Create a pack with some cell-to-cell spread
+ */
+static void initDevice(Device &device, uint16_t id, const Options &options) {
+    device.id = id;
+    device.rng.seed(id + 1);
+    std::uniform_real_distribution<float> spread(-1.0f, 1.0f);
+
+    device.capacityAh = 20.0f + 5.0f * (id % 9);
+    CellSpread cellSpread = {0.015f, 0.05f, 0.0f, 0.01f};
+    float soc = 0.3f + 0.5f * (spread(device.rng) + 1.0f) / 2.0f;
+    device.bench.initPack(options.cells, device.capacityAh, soc, 25.0f);
+    device.bench.model.randomize(cellSpread, id + 1);
+
+    device.current = 0.0f;
+    device.segmentEndUs = 0;
+    device.joinUs = options.ramp > 0 ? (uint64_t)(options.ramp * 1e6 * id / options.packs) : 0;
+    device.bench.setNextUpdate(device.joinUs);
+    device.started = false;
+}
+
+/**
+ * @brief Power up a device: chip inputs, then the driver's begin()
+ */
+static bool startDevice(Device &device, const Options &options) {
+    if (!device.bench.start(options.cells)) {
+        return false;
+    }
+    device.bench.driver.setCoherentMode(options.coherent);
+    device.started = true;
+    return true;
+}
+
+/**
+ * @brief Pick the pack current: random segments, turned at the voltage limits
+ */
+static void stepProfile(Device &device, uint64_t nowUs) {
+    float highest = 0.0f;
+    float lowest = 10.0f;
+    const PackModel &model = device.bench.model;
+    for (uint8_t i = 0; i < model.cellCount(); i++) {
+        float v = model.cell(i).volts;
+        highest = v > highest ? v : highest;
+        lowest = v < lowest ? v : lowest;
+    }
+
+    bool turn = (device.current > 0 && highest > PROFILE_HIGH_V) ||
+                (device.current < 0 && lowest < PROFILE_LOW_V);
+    if (nowUs < device.segmentEndUs && !turn) {
+        return;
+    }
+
+    std::uniform_real_distribution<float> rate(0.05f, PROFILE_MAX_C);
+    std::uniform_int_distribution<int> length(PROFILE_MIN_S, PROFILE_MAX_S);
+    float amps = rate(device.rng) * device.capacityAh;
+    if (turn) {
+        device.current = device.current > 0 ? -amps : amps;
+    } else {
+        switch (device.rng() % 3) {
+            case 0: device.current = amps; break;
+            case 1: device.current = -amps; break;
+            default: device.current = 0.0f; break;
+        }
+    }
+    device.segmentEndUs = nowUs + (uint64_t)length(device.rng) * 1000000;
+}
+
+/**
+ * @brief Open a TCP connection to the daemon
+ */
+static int connectDaemon(const Options &options) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(options.port);
+    if (fd < 0 || inet_pton(AF_INET, options.host, &addr.sin_addr) != 1 ||
+        connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Write everything, retrying short writes
+ */
+static bool writeAll(int fd, const uint8_t *data, size_t length) {
+    while (length > 0) {
+        ssize_t n = write(fd, data, length);
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        length -= (size_t)n;
+    }
+    return true;
+}
+
+/**
+ * @brief Advance this worker's devices by one step and send their frames
+ */
+static void runStep(Worker &worker, const Options &options, uint64_t nowUs) {
+    const uint32_t stepUs = options.stepMs * 1000;
+    const uint64_t periodUs = (uint64_t)(1e6 / options.rate);
+    uint8_t frame[255];
+    uint8_t link[PB7200_LINK_MAX];
+
+    for (size_t i = 0; i < worker.devices.size(); i++) {
+        Device &device = *worker.devices[i];
+        if (nowUs < device.joinUs) {
+            continue;
+        }
+        PB7200SimBench &bench = device.bench;
+        bench.bind();
+        bench.sync(nowUs);
+
+        if (!device.started && !startDevice(device, options)) {
+            worker.failures++;
+            continue;
+        }
+
+        stepProfile(device, nowUs);
+        bench.step(stepUs, device.current);
+
+        if (!bench.updateDue(periodUs)) {
+            continue;
+        }
+
+        if (!bench.driver.update()) {
+            worker.failures++;
+            continue;
+        }
+
+        PackStats stats;
+        bench.driver.getPackStats(stats);
+        if (options.balanceMv > 0) {
+            if (stats.current > 0 && stats.voltageDelta * 1000.0f > options.balanceMv) {
+                bench.driver.balanceTopCells(options.cells / 4 + 1, options.balanceMv);
+            } else if (bench.driver.getSnapshot().balanceMask != 0) {
+                bench.driver.stopAllBalancing();
+            }
+        }
+
+        uint8_t length = device.packer.pack(bench.driver.getSnapshot(), stats, frame,
+                                            options.budget);
+        uint16_t n = linkEncode(device.id, frame, length, link);
+        std::vector<uint8_t> &buffer = worker.buffers[device.id % worker.buffers.size()];
+        buffer.insert(buffer.end(), link, link + n);
+        worker.frames++;
+        worker.bytes += n;
+    }
+    arduinoBindClock(nullptr);
+
+    uint64_t start = monotonicNs();
+    for (size_t c = 0; c < worker.buffers.size(); c++) {
+        if (options.send && !worker.buffers[c].empty() &&
+            !writeAll(worker.fds[c], worker.buffers[c].data(), worker.buffers[c].size())) {
+            running = false;
+        }
+        worker.buffers[c].clear();
+    }
+    worker.sendNs += monotonicNs() - start;
+}
+
+/**
+ * @brief Pool thread: one step per barrier cycle until stopped
+ */
+static void workerLoop(Worker &worker, const Options &options, StepBarrier &barrier,
+                       const std::atomic<uint64_t> &simUs, const std::atomic<bool> &stop) {
+    for (;;) {
+        barrier.wait();
+        if (stop) {
+            break;
+        }
+        uint64_t start = monotonicNs();
+        runStep(worker, options, simUs);
+        worker.busyNs += monotonicNs() - start;
+        barrier.wait();
+    }
+}
+
+int main(int argc, char **argv) {
+    Options options = {"127.0.0.1", 7200, false, 4, 1000, std::thread::hardware_concurrency(),
+                       1.0, 1.0, 0.0, 0.0, 16, 0, 64, 100, false};
+
+    int opt;
+    while ((opt = getopt(argc, argv, "c:k:n:t:r:x:d:R:s:B:b:T:C")) != -1) {
+        switch (opt) {
+            case 'c': {
+                static char host[64];
+                snprintf(host, sizeof(host), "%s", optarg);
+                char *colon = strchr(host, ':');
+                if (colon != nullptr) {
+                    *colon = '\0';
+                    options.port = (uint16_t)atoi(colon + 1);
+                }
+                options.host = host;
+                options.send = true;
+                break;
+            }
+            case 'k': options.connections = (unsigned)atoi(optarg); break;
+            case 'n': options.packs = (unsigned)atoi(optarg); break;
+            case 't': options.threads = (unsigned)atoi(optarg); break;
+            case 'r': options.rate = atof(optarg); break;
+            case 'x': options.speed = atof(optarg); break;
+            case 'd': options.seconds = atof(optarg); break;
+            case 'R': options.ramp = atof(optarg); break;
+            case 's': options.cells = (uint8_t)atoi(optarg); break;
+            case 'B': options.balanceMv = (uint16_t)atoi(optarg); break;
+            case 'b': options.budget = (uint8_t)atoi(optarg); break;
+            case 'T': options.stepMs = (uint32_t)atoi(optarg); break;
+            case 'C': options.coherent = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-c host:port] [-k connections] [-n packs] "
+                                "[-t threads] [-r rate] [-x speed] [-d seconds] [-R ramp] "
+                                "[-s cells] [-B balance mV] [-b budget] [-T step ms] [-C]\n",
+                        argv[0]);
+                return 1;
+        }
+    }
+    if (options.packs == 0 || options.packs > 65536 || options.cells == 0 ||
+        options.cells > 16 || options.rate <= 0 || options.stepMs == 0) {
+        fprintf(stderr, "need 1-65536 packs, 1-16 cells, a rate and a step\n");
+        return 1;
+    }
+    if (options.threads == 0) {
+        options.threads = 1;
+    }
+    if (options.connections < options.threads) {
+        options.connections = options.threads;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    // Connection c belongs to thread c % threads; pack p uses connection p % connections
+    std::vector<Worker> workers(options.threads);
+    for (unsigned c = 0; c < options.connections; c++) {
+        int fd = -1;
+        if (options.send && (fd = connectDaemon(options)) < 0) {
+            perror("connect");
+            return 1;
+        }
+        Worker &worker = workers[c % options.threads];
+        worker.fds.push_back(fd);
+        worker.buffers.push_back(std::vector<uint8_t>());
+    }
+
+    std::vector<std::unique_ptr<Device> > devices;
+    for (unsigned p = 0; p < options.packs; p++) {
+        devices.push_back(std::unique_ptr<Device>(new Device()));
+        initDevice(*devices.back(), (uint16_t)p, options);
+        workers[p % options.connections % options.threads].devices.push_back(devices.back().get());
+    }
+
+    StepBarrier barrier(options.threads + 1);
+    std::atomic<uint64_t> simUs(0);
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < options.threads; t++) {
+        threads.push_back(std::thread(workerLoop, std::ref(workers[t]), std::cref(options),
+                                      std::ref(barrier), std::cref(simUs), std::cref(stop)));
+    }
+
+    const uint64_t stepUs = (uint64_t)options.stepMs * 1000;
+    const uint64_t start = monotonicNs();
+    uint64_t lastReport = start;
+    uint64_t lastFrames = 0;
+    uint64_t lastBytes = 0;
+    uint64_t lastSendNs = 0;
+    uint64_t lastSimUs = 0;
+
+    while (running && (options.seconds <= 0 || simUs < options.seconds * 1e6)) {
+        barrier.wait();
+        barrier.wait();
+        simUs += stepUs;
+
+        uint64_t now = monotonicNs();
+        double lag = 0.0;
+        if (options.speed > 0) {
+            double due = simUs / options.speed / 1e6;
+            double wall = (now - start) / 1e9;
+            if (due > wall) {
+                usleep((useconds_t)((due - wall) * 1e6));
+                now = monotonicNs();
+            } else {
+                lag = (wall - due) * options.speed;
+            }
+        }
+
+        if (now - lastReport >= 1000000000ULL) {
+            uint64_t frames = 0, bytes = 0, sendNs = 0, failures = 0;
+            for (size_t t = 0; t < workers.size(); t++) {
+                frames += workers[t].frames;
+                bytes += workers[t].bytes;
+                sendNs += workers[t].sendNs;
+                failures += workers[t].failures;
+            }
+            double interval = (now - lastReport) / 1e9;
+            unsigned active = 0;
+            for (size_t p = 0; p < devices.size(); p++) {
+                active += devices[p]->started;
+            }
+            fprintf(stderr, "sim %.0f s (x%.1f)  packs %u  %.0f frames/s  %.2f MB/s  "
+                            "send wait %.0f%%  lag %.1f s  failures %llu\n",
+                    simUs / 1e6, (simUs - lastSimUs) / 1e6 / interval, active,
+                    (frames - lastFrames) / interval, (bytes - lastBytes) / interval / 1e6,
+                    100.0 * (sendNs - lastSendNs) / 1e9 / interval / options.threads, lag,
+                    (unsigned long long)failures);
+            lastReport = now;
+            lastFrames = frames;
+            lastBytes = bytes;
+            lastSendNs = sendNs;
+            lastSimUs = simUs;
+        }
+    }
+
+    stop = true;
+    barrier.wait();
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+
+    uint64_t frames = 0, busyNs = 0, failures = 0;
+    for (size_t t = 0; t < workers.size(); t++) {
+        frames += workers[t].frames;
+        busyNs += workers[t].busyNs;
+        failures += workers[t].failures;
+        for (size_t c = 0; c < workers[t].fds.size(); c++) {
+            if (workers[t].fds[c] >= 0) {
+                close(workers[t].fds[c]);
+            }
+        }
+    }
+    double wall = (monotonicNs() - start) / 1e9;
+    printf("%u packs, %.0f s simulated in %.1f s (x%.1f), %llu frames, %.1f us CPU per "
+           "frame, %llu failures\n",
+           options.packs, simUs / 1e6, wall, simUs / 1e6 / wall, (unsigned long long)frames,
+           frames > 0 ? busyNs / 1e3 / frames : 0.0, (unsigned long long)failures);
+    return 0;
+}
@@ -0,0 +1,435 @@
+/**
+ * @file pb7200_batch.cpp
+ * @brief Batch analytics over recorded frames for host tools
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ */
+
+#include "pb7200_batch.h"
+
+#include <string.h>
+
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PB7200_BATCH_X86 1
+#include <immintrin.h>
+#endif
+
+// Rows per call of the accumulation pass in batchPackStats()
+#define BATCH_CHUNK 256
+
+static bool simdEnabled = batchSimdAvailable();
+
+/**
+ * @brief Check whether the CPU has AVX2
+ */
+bool batchSimdAvailable() {
+#ifdef PB7200_BATCH_X86
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Choose between the vector and scalar paths
+ */
+void batchUseSimd(bool enable) {
+    simdEnabled = enable && batchSimdAvailable();
+}
+
+/**
+ * @brief Check which path is in use
+ */
+bool batchSimdEnabled() {
+    return simdEnabled;
+}
+
+/**
+ * @brief Describe one block of a column file as frames
+ */
+void batchFramesFromBlock(const ColumnReader &reader, uint32_t block, BatchFrames &frames) {
+    const ColumnBlockHeader &header = reader.block(block);
+
+    frames.rows = header.rows;
+    frames.cellCount = 0;
+    frames.tempCount = 0;
+    while (frames.cellCount < PB7200_MAX_CELLS &&
+           header.maxValue[PB7200_COLUMN_CELL + frames.cellCount] != INT16_MIN) {
+        frames.cellCount++;
+    }
+    while (frames.tempCount < PB7200_MAX_TEMPS &&
+           header.maxValue[PB7200_COLUMN_TEMP + frames.tempCount] != INT16_MIN) {
+        frames.tempCount++;
+    }
+
+    frames.timesUs = reader.times(block);
+    for (uint8_t i = 0; i < PB7200_MAX_CELLS; i++) {
+        frames.cells[i] = reader.column(block, PB7200_COLUMN_CELL + i);
+    }
+    for (uint8_t i = 0; i < PB7200_MAX_TEMPS; i++) {
+        frames.temps[i] = reader.column(block, PB7200_COLUMN_TEMP + i);
+    }
+    frames.current = reader.column(block, PB7200_COLUMN_CURRENT);
+    frames.balanceMask = nullptr;
+}
+
+/**
+ * @brief Describe an array of snapshots as frames
+ */
+void batchFramesFromSnapshots(const PackSnapshot *snapshots, uint32_t count,
+                              BatchBuffer &buffer, BatchFrames &frames) {
+    const uint32_t columns = PB7200_MAX_CELLS + PB7200_MAX_TEMPS + 1;
+
+    buffer.timesUs.resize(count);
+    buffer.values.assign((size_t)columns * count, PB7200_COLUMN_NULL);
+    buffer.balanceMasks.resize(count);
+
+    frames.rows = count;
+    frames.cellCount = count > 0 ? snapshots[0].cellCount : 0;
+    frames.tempCount = count > 0 ? snapshots[0].tempCount : 0;
+    frames.timesUs = buffer.timesUs.data();
+    for (uint8_t i = 0; i < PB7200_MAX_CELLS; i++) {
+        frames.cells[i] = &buffer.values[(size_t)i * count];
+    }
+    for (uint8_t i = 0; i < PB7200_MAX_TEMPS; i++) {
+        frames.temps[i] = &buffer.values[(size_t)(PB7200_MAX_CELLS + i) * count];
+    }
+    frames.current = &buffer.values[(size_t)(columns - 1) * count];
+    frames.balanceMask = buffer.balanceMasks.data();
+
+    int16_t *values = buffer.values.data();
+    for (uint32_t row = 0; row < count; row++) {
+        const PackSnapshot &snapshot = snapshots[row];
+        buffer.timesUs[row] = (uint64_t)snapshot.timestamp * 1000;
+        buffer.balanceMasks[row] = snapshot.balanceMask;
+        for (uint8_t i = 0; i < frames.cellCount; i++) {
+            values[(size_t)i * count + row] = (int16_t)snapshot.cellRaw[i];
+        }
+        for (uint8_t i = 0; i < frames.tempCount; i++) {
+            values[(size_t)(PB7200_MAX_CELLS + i) * count + row] = snapshot.tempRaw[i];
+        }
+        values[(size_t)(columns - 1) * count + row] = snapshot.currentRaw;
+    }
+}
+
+/**
+ * @brief Gather one frame into a snapshot
+ * @return false if the frame holds a null value
+ */
+static bool gatherRow(const BatchFrames &frames, uint32_t row, PackSnapshot &snapshot,
+                      bool values) {
+    snapshot.cellCount = frames.cellCount;
+    snapshot.tempCount = frames.tempCount;
+    snapshot.currentRaw = frames.current[row];
+    snapshot.timestamp = (uint32_t)(frames.timesUs[row] / 1000);
+    snapshot.balanceMask = frames.balanceMask != nullptr ? frames.balanceMask[row] : 0;
+
+    bool complete = snapshot.currentRaw != PB7200_COLUMN_NULL;
+    if (!values) {
+        return complete;
+    }
+    for (uint8_t i = 0; i < frames.cellCount; i++) {
+        int16_t v = frames.cells[i][row];
+        complete = complete && v != PB7200_COLUMN_NULL;
+        snapshot.cellRaw[i] = (uint16_t)v;
+    }
+    for (uint8_t i = 0; i < frames.tempCount; i++) {
+        int16_t v = frames.temps[i][row];
+        complete = complete && v != PB7200_COLUMN_NULL;
+        snapshot.tempRaw[i] = v;
+    }
+    return complete;
+}
+
+#ifdef PB7200_BATCH_X86
+/**
+ * @brief Accumulation pass for PB7200_BATCH_LANES rows, one row per lane
+ *
+ * Same comparisons as accumulatePackSums(): strict, in channel order,
+ * so ties keep the first index. Cells are unsigned, so they are
+ * compared with the sign bit flipped.
+ */
+__attribute__((target("avx2")))
+static void sumsAvx2(const BatchFrames &frames, uint32_t row, PackSums *sums,
+                     uint8_t *complete) {
+    const __m256i bias = _mm256_set1_epi16((short)0x8000);
+    const __m256i nullValue = _mm256_set1_epi16(PB7200_COLUMN_NULL);
+    const __m256i one = _mm256_set1_epi32(1);
+
+    __m256i maxBiased = _mm256_set1_epi16(INT16_MIN);  // Raw 0
+    __m256i minBiased = _mm256_set1_epi16(INT16_MAX);  // Raw 0xFFFF
+    __m256i maxIndex = _mm256_setzero_si256();
+    __m256i minIndex = _mm256_setzero_si256();
+    __m256i totalLo = _mm256_setzero_si256();
+    __m256i totalHi = _mm256_setzero_si256();
+    __m256i balanceLo = _mm256_setzero_si256();
+    __m256i balanceHi = _mm256_setzero_si256();
+    __m256i balancingLo = _mm256_setzero_si256();
+    __m256i balancingHi = _mm256_setzero_si256();
+    __m256i nulls = _mm256_cmpeq_epi16(
+        _mm256_loadu_si256((const __m256i *)(frames.current + row)), nullValue);
+
+    bool masks = frames.balanceMask != nullptr;
+    __m256i maskLo = _mm256_setzero_si256();
+    __m256i maskHi = _mm256_setzero_si256();
+    if (masks) {
+        maskLo = _mm256_loadu_si256((const __m256i *)(frames.balanceMask + row));
+        maskHi = _mm256_loadu_si256((const __m256i *)(frames.balanceMask + row + 8));
+    }
+
+    for (uint8_t i = 0; i < frames.cellCount; i++) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(frames.cells[i] + row));
+        __m256i index = _mm256_set1_epi16(i);
+        nulls = _mm256_or_si256(nulls, _mm256_cmpeq_epi16(v, nullValue));
+
+        __m256i biased = _mm256_xor_si256(v, bias);
+        __m256i above = _mm256_cmpgt_epi16(biased, maxBiased);
+        __m256i below = _mm256_cmpgt_epi16(minBiased, biased);
+        maxBiased = _mm256_max_epi16(maxBiased, biased);
+        minBiased = _mm256_min_epi16(minBiased, biased);
+        maxIndex = _mm256_blendv_epi8(maxIndex, index, above);
+        minIndex = _mm256_blendv_epi8(minIndex, index, below);
+
+        __m256i lo = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(v));
+        __m256i hi = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(v, 1));
+        totalLo = _mm256_add_epi32(totalLo, lo);
+        totalHi = _mm256_add_epi32(totalHi, hi);
+
+        if (masks) {
+            __m128i shift = _mm_cvtsi32_si128(i);
+            __m256i bitLo = _mm256_and_si256(_mm256_srl_epi32(maskLo, shift), one);
+            __m256i bitHi = _mm256_and_si256(_mm256_srl_epi32(maskHi, shift), one);
+            balanceLo = _mm256_add_epi32(balanceLo,
+                _mm256_and_si256(lo, _mm256_cmpeq_epi32(bitLo, one)));
+            balanceHi = _mm256_add_epi32(balanceHi,
+                _mm256_and_si256(hi, _mm256_cmpeq_epi32(bitHi, one)));
+            balancingLo = _mm256_add_epi32(balancingLo, bitLo);
+            balancingHi = _mm256_add_epi32(balancingHi, bitHi);
+        }
+    }
+
+    __m256i maxTemp = _mm256_set1_epi16(INT16_MIN);
+    __m256i minTemp = _mm256_set1_epi16(INT16_MAX);
+    __m256i maxTempIndex = _mm256_setzero_si256();
+    __m256i minTempIndex = _mm256_setzero_si256();
+
+    for (uint8_t i = 0; i < frames.tempCount; i++) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(frames.temps[i] + row));
+        __m256i index = _mm256_set1_epi16(i);
+        nulls = _mm256_or_si256(nulls, _mm256_cmpeq_epi16(v, nullValue));
+
+        __m256i above = _mm256_cmpgt_epi16(v, maxTemp);
+        __m256i below = _mm256_cmpgt_epi16(minTemp, v);
+        maxTemp = _mm256_max_epi16(maxTemp, v);
+        minTemp = _mm256_min_epi16(minTemp, v);
+        maxTempIndex = _mm256_blendv_epi8(maxTempIndex, index, above);
+        minTempIndex = _mm256_blendv_epi8(minTempIndex, index, below);
+    }
+
+    int16_t maxRaw[16], minRaw[16], maxIdx[16], minIdx[16];
+    int16_t maxT[16], minT[16], maxTIdx[16], minTIdx[16], null[16];
+    uint32_t total[16], balance[16], balancing[16];
+
+    _mm256_storeu_si256((__m256i *)maxRaw, _mm256_xor_si256(maxBiased, bias));
+    _mm256_storeu_si256((__m256i *)minRaw, _mm256_xor_si256(minBiased, bias));
+    _mm256_storeu_si256((__m256i *)maxIdx, maxIndex);
+    _mm256_storeu_si256((__m256i *)minIdx, minIndex);
+    _mm256_storeu_si256((__m256i *)maxT, maxTemp);
+    _mm256_storeu_si256((__m256i *)minT, minTemp);
+    _mm256_storeu_si256((__m256i *)maxTIdx, maxTempIndex);
+    _mm256_storeu_si256((__m256i *)minTIdx, minTempIndex);
+    _mm256_storeu_si256((__m256i *)null, nulls);
+    _mm256_storeu_si256((__m256i *)total, totalLo);
+    _mm256_storeu_si256((__m256i *)(total + 8), totalHi);
+    _mm256_storeu_si256((__m256i *)balance, balanceLo);
+    _mm256_storeu_si256((__m256i *)(balance + 8), balanceHi);
+    _mm256_storeu_si256((__m256i *)balancing, balancingLo);
+    _mm256_storeu_si256((__m256i *)(balancing + 8), balancingHi);
+
+    for (uint8_t lane = 0; lane < PB7200_BATCH_LANES; lane++) {
+        PackSums &s = sums[lane];
+        s.totalRaw = total[lane];
+        s.balanceRaw = balance[lane];
+        s.maxRaw = (uint16_t)maxRaw[lane];
+        s.minRaw = frames.cellCount ? (uint16_t)minRaw[lane] : 0;
+        s.maxCellIndex = (uint8_t)maxIdx[lane];
+        s.minCellIndex = (uint8_t)minIdx[lane];
+        s.maxTempRaw = frames.tempCount ? maxT[lane] : 0;
+        s.minTempRaw = frames.tempCount ? minT[lane] : 0;
+        s.maxTempIndex = (uint8_t)maxTIdx[lane];
+        s.minTempIndex = (uint8_t)minTIdx[lane];
+        s.balancingCount = (uint8_t)balancing[lane];
+        if (complete != nullptr) {
+            complete[lane] = null[lane] == 0;
+        }
+    }
+}
+
+/**
+ * @brief Count cells above the threshold for PB7200_BATCH_LANES rows
+ */
+__attribute__((target("avx2")))
+static void aboveAvx2(const BatchFrames &frames, uint32_t row, const PackSums *sums,
+                      uint16_t thresholdRaw, BalanceMetrics *metrics) {
+    const __m256i bias = _mm256_set1_epi16((short)0x8000);
+
+    uint16_t minRaw[16];
+    for (uint8_t lane = 0; lane < PB7200_BATCH_LANES; lane++) {
+        minRaw[lane] = sums[lane].minRaw;
+    }
+    __m256i low = _mm256_loadu_si256((const __m256i *)minRaw);
+    __m256i limit = _mm256_xor_si256(_mm256_set1_epi16((short)thresholdRaw), bias);
+    __m256i count = _mm256_setzero_si256();
+
+    // raw - min never wraps, as min is the lowest cell of the row
+    for (uint8_t i = 0; i < frames.cellCount; i++) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(frames.cells[i] + row));
+        __m256i excess = _mm256_xor_si256(_mm256_subs_epu16(v, low), bias);
+        count = _mm256_sub_epi16(count, _mm256_cmpgt_epi16(excess, limit));
+    }
+
+    uint16_t above[16];
+    _mm256_storeu_si256((__m256i *)above, count);
+    for (uint8_t lane = 0; lane < PB7200_BATCH_LANES; lane++) {
+        metrics[lane].aboveCount = (uint8_t)above[lane];
+    }
+}
+#endif
+
+/**
+ * @brief Run the accumulation pass of the statistics kernel
+ */
+void batchPackSums(const BatchFrames &frames, uint32_t first, uint32_t count,
+                   PackSums *sums, uint8_t *complete) {
+    uint32_t done = 0;
+
+#ifdef PB7200_BATCH_X86
+    if (simdEnabled) {
+        for (; done + PB7200_BATCH_LANES <= count; done += PB7200_BATCH_LANES) {
+            sumsAvx2(frames, first + done, sums + done,
+                     complete != nullptr ? complete + done : nullptr);
+        }
+    }
+#endif
+
+    // Remaining rows through the embedded kernel
+    PackSnapshot snapshot;
+    for (; done < count; done++) {
+        bool full = gatherRow(frames, first + done, snapshot, true);
+        accumulatePackSums(snapshot, sums[done]);
+        if (complete != nullptr) {
+            complete[done] = full;
+        }
+    }
+}
+
+/**
+ * @brief Compute pack statistics for every frame
+ */
+uint32_t batchPackStats(const BatchFrames &frames, const PackConfig &config,
+                        PackCounters &counters, PackStats *stats, uint8_t *valid,
+                        AnomalyState *anomaly) {
+    PackSums sums[BATCH_CHUNK];
+    uint8_t complete[BATCH_CHUNK];
+    PackSnapshot snapshot;
+    uint32_t produced = 0;
+
+    for (uint32_t base = 0; base < frames.rows; base += BATCH_CHUNK) {
+        uint32_t n = frames.rows - base < BATCH_CHUNK ? frames.rows - base : BATCH_CHUNK;
+        batchPackSums(frames, base, n, sums, complete);
+
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t row = base + i;
+            if (valid != nullptr) {
+                valid[row] = complete[i];
+            }
+            if (!complete[i]) {
+                memset(&stats[row], 0, sizeof(PackStats));
+                continue;
+            }
+
+            // The finishing pass reads cell values only for anomaly scores
+            gatherRow(frames, row, snapshot, anomaly != nullptr);
+            finishPackStats(snapshot, sums[i], config, counters, stats[row], anomaly);
+            produced++;
+        }
+    }
+    return produced;
+}
+
+/**
+ * @brief Compute balance metrics for every frame
+ */
+void batchBalanceMetrics(const BatchFrames &frames, const PackSums *sums,
+                         uint16_t thresholdRaw, BalanceMetrics *metrics) {
+    uint32_t row = 0;
+
+#ifdef PB7200_BATCH_X86
+    if (simdEnabled) {
+        for (; row + PB7200_BATCH_LANES <= frames.rows; row += PB7200_BATCH_LANES) {
+            aboveAvx2(frames, row, sums + row, thresholdRaw, metrics + row);
+        }
+    }
+#endif
+
+    // Same test as selectBalanceCells(): raw > lowest + threshold
+    for (; row < frames.rows; row++) {
+        uint32_t limit = (uint32_t)sums[row].minRaw + thresholdRaw;
+        uint8_t above = 0;
+        for (uint8_t i = 0; i < frames.cellCount; i++) {
+            above += (uint16_t)frames.cells[i][row] > limit;
+        }
+        metrics[row].aboveCount = above;
+    }
+
+    for (row = 0; row < frames.rows; row++) {
+        metrics[row].excessRaw = sums[row].totalRaw - (uint32_t)frames.cellCount * sums[row].minRaw;
+    }
+}
+
+/**
+ * @brief Bin of a histogram value, clamped to the first and last bin
+ */
+static inline int32_t histogramBin(int16_t value, int16_t low, uint16_t width, int32_t last) {
+    int32_t bin = value < low ? 0 : ((int32_t)value - low) / width;
+    return bin > last ? last : bin;
+}
+
+/**
+ * @brief Add values to a histogram
+ */
+void batchHistogram(const int16_t *values, uint32_t count, int16_t low, uint16_t width,
+                    uint64_t *bins, uint16_t binCount) {
+    if (binCount == 0 || width == 0) {
+        return;
+    }
+
+    int32_t last = binCount - 1;
+
+    // Merging split tallies costs a pass over the bins; short runs count directly
+    if (count < 4 * (uint32_t)binCount) {
+        for (uint32_t i = 0; i < count; i++) {
+            if (values[i] != PB7200_COLUMN_NULL) {
+                bins[histogramBin(values[i], low, width, last)]++;
+            }
+        }
+        return;
+    }
+
+    std::vector<uint32_t> tallies(4 * (size_t)binCount, 0);
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (values[i] != PB7200_COLUMN_NULL) {
+            tallies[(size_t)(i & 3) * binCount + histogramBin(values[i], low, width, last)]++;
+        }
+    }
+
+    for (uint16_t b = 0; b < binCount; b++) {
+        bins[b] += (uint64_t)tallies[b] + tallies[binCount + b] + tallies[2 * binCount + b] +
+                   tallies[3 * (size_t)binCount + b];
+    }
+}
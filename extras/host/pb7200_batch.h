@@ -0,0 +1,163 @@
+/**
+ * @file pb7200_batch.h
+ * @brief Batch analytics over recorded frames for host tools
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Runs the on-device statistics kernel (PB7200Stats.h) over many frames
+ * held column by column, as in the column store (pb7200_columns.h).
+ * The accumulation pass is vectorized across 16 rows at a time with
+ * AVX2 when the CPU has it; the scalar path, and every later step
+ * (conversion, charge integration, anomaly scores), is the embedded
+ * code itself, so results match computePackStats() exactly.
+ */
+
+#ifndef PB7200_BATCH_H
+#define PB7200_BATCH_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "PB7200Stats.h"
+#include "pb7200_columns.h"
+
+// Rows per SIMD step
+#define PB7200_BATCH_LANES 16
+
+/**
+ * @brief Frames of one pack, one array per channel
+ */
+struct BatchFrames {
+    uint32_t rows;                              // Number of frames
+    uint8_t cellCount;                          // Cells per frame
+    uint8_t tempCount;                          // Sensors per frame
+    const uint64_t *timesUs;                    // Frame times (µs)
+    const int16_t *cells[PB7200_MAX_CELLS];     // Cell columns (mV)
+    const int16_t *temps[PB7200_MAX_TEMPS];     // Sensor columns (0.1 °C)
+    const int16_t *current;                     // Current column (10 mA)
+    const uint32_t *balanceMask;                // Balance masks (nullptr = none)
+};
+
+/**
+ * @brief Column storage for frames converted from snapshots
+ */
+struct BatchBuffer {
+    std::vector<uint64_t> timesUs;              // Frame times (µs)
+    std::vector<int16_t> values;                // Cell, sensor and current columns
+    std::vector<uint32_t> balanceMasks;         // Balance masks
+};
+
+/**
+ * @brief Balance metrics of one frame
+ */
+struct BalanceMetrics {
+    uint32_t excessRaw;      // Sum of cell excess over the lowest cell (mV)
+    uint8_t aboveCount;      // Cells more than the threshold above the lowest
+};
+
+/**
+ * @brief Check whether the CPU has AVX2
+ * @return true if the vector path can run
+ */
+bool batchSimdAvailable();
+
+/**
+ * @brief Choose between the vector and scalar paths
+ * @param enable true to use AVX2 when available (default)
+ */
+void batchUseSimd(bool enable);
+
+/**
+ * @brief Check which path is in use
+ * @return true if AVX2 is used
+ */
+bool batchSimdEnabled();
+
+/**
+ * @brief Describe one block of a column file as frames
+ *
+ * The cell and sensor counts are those channels holding values in the
+ * block. Column files do not store balance masks.
+ *
+ * @param reader Open column file
+ * @param block Block index
+ * @param frames Output
+ */
+void batchFramesFromBlock(const ColumnReader &reader, uint32_t block, BatchFrames &frames);
+
+/**
+ * @brief Describe an array of snapshots as frames
+ *
+ * Transposes the snapshots into buffer, one column per channel. All
+ * snapshots must have the cell and sensor counts of the first; times
+ * are the snapshot timestamps (ms) in µs.
+ *
+ * @param snapshots Snapshots
+ * @param count Number of snapshots
+ * @param buffer Storage for the columns, must outlive frames
+ * @param frames Output
+ */
+void batchFramesFromSnapshots(const PackSnapshot *snapshots, uint32_t count,
+                              BatchBuffer &buffer, BatchFrames &frames);
+
+/**
+ * @brief Run the accumulation pass of the statistics kernel
+ * @param frames Frames
+ * @param first First row
+ * @param count Number of rows
+ * @param sums Output, count entries
+ * @param complete Output, 1 if the row has no null value (optional)
+ */
+void batchPackSums(const BatchFrames &frames, uint32_t first, uint32_t count,
+                   PackSums *sums, uint8_t *complete = nullptr);
+
+/**
+ * @brief Compute pack statistics for every frame
+ *
+ * Equivalent to computePackStats() on each frame in order. Frames with
+ * a null value are skipped and leave the counters and anomaly state
+ * untouched.
+ *
+ * @param frames Frames
+ * @param config Pack layout
+ * @param counters Integrators, advanced frame by frame
+ * @param stats Output, frames.rows entries
+ * @param valid Output, 1 for frames with statistics (optional)
+ * @param anomaly Anomaly state to update (optional)
+ * @return Number of frames with statistics
+ */
+uint32_t batchPackStats(const BatchFrames &frames, const PackConfig &config,
+                        PackCounters &counters, PackStats *stats, uint8_t *valid = nullptr,
+                        AnomalyState *anomaly = nullptr);
+
+/**
+ * @brief Compute balance metrics for every frame
+ * @param frames Frames
+ * @param sums Accumulation pass of the same frames
+ * @param thresholdRaw Excess over the lowest cell that counts (mV)
+ * @param metrics Output, frames.rows entries
+ */
+void batchBalanceMetrics(const BatchFrames &frames, const PackSums *sums,
+                         uint16_t thresholdRaw, BalanceMetrics *metrics);
+
+/**
+ * @brief Add values to a histogram
+ *
+ * Values below low or beyond the last bin are counted in the first or
+ * last bin; nulls are skipped. Binning is a scatter, which does not
+ * vectorize, so runs of at least four values per bin are tallied four
+ * ways instead to keep increments of the same bin independent.
+ *
+ * @param values Values
+ * @param count Number of values
+ * @param low Lower edge of the first bin
+ * @param width Bin width
+ * @param bins Counts to add to
+ * @param binCount Number of bins
+ */
+void batchHistogram(const int16_t *values, uint32_t count, int16_t low, uint16_t width,
+                    uint64_t *bins, uint16_t binCount);
+
+#endif // PB7200_BATCH_H
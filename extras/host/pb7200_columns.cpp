@@ -0,0 +1,968 @@
+/**
+ * @file pb7200_columns.cpp
+ * @brief Columnar, memory-mapped store of recorded pack data
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ */
+
+#include "pb7200_columns.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <vector>
+
+#define PAGE_SIZE_BYTES 4096
+
+// Index group: superblock entry, then its block entries
+#define GROUP_ENTRIES (PB7200_COLUMN_FANOUT + 1)
+#define GROUP_BYTES (GROUP_ENTRIES * sizeof(ColumnIndexEntry))
+
+/**
+ * @brief Get the size of a block
+ */
+uint32_t columnBlockSize(uint32_t blockRows) {
+    uint32_t bytes = PB7200_COLUMN_BLOCK_HEADER +
+                     blockRows * (sizeof(uint64_t) + PB7200_COLUMN_CHANNELS * sizeof(int16_t));
+    return (bytes + PAGE_SIZE_BYTES - 1) / PAGE_SIZE_BYTES * PAGE_SIZE_BYTES;
+}
+
+/**
+ * @brief Get the summary index path of a data file
+ */
+bool columnIndexPath(const char *path, char *out, size_t size) {
+    size_t length = strlen(path);
+    if (length >= 4 && strcmp(path + length - 4, ".pbc") == 0) {
+        length -= 4;
+    }
+    return snprintf(out, size, "%.*s.pbx", (int)length, path) < (int)size;
+}
+
+/**
+ * @brief Clear a summary
+ */
+void resetColumnSummary(ColumnSummary &summary) {
+    summary.sum = 0;
+    summary.count = 0;
+    summary.minValue = INT16_MAX;
+    summary.maxValue = INT16_MIN;
+}
+
+/**
+ * @brief Add one value to a summary
+ */
+static inline void addValue(ColumnSummary &summary, int16_t value) {
+    summary.sum += value;
+    summary.count++;
+    if (value < summary.minValue) {
+        summary.minValue = value;
+    }
+    if (value > summary.maxValue) {
+        summary.maxValue = value;
+    }
+}
+
+/**
+ * @brief Merge a summary into another
+ */
+static void mergeSummary(ColumnSummary &summary, const ColumnSummary &other) {
+    summary.sum += other.sum;
+    summary.count += other.count;
+    if (other.minValue < summary.minValue) {
+        summary.minValue = other.minValue;
+    }
+    if (other.maxValue > summary.maxValue) {
+        summary.maxValue = other.maxValue;
+    }
+}
+
+/**
+ * @brief Reset an index entry to an empty node
+ */
+static void initEntry(ColumnIndexEntry &entry) {
+    entry.firstUs = 0;
+    entry.lastUs = 0;
+    entry.rows = 0;
+    entry.reserved = 0;
+    for (uint8_t c = 0; c < PB7200_COLUMN_CHANNELS; c++) {
+        resetColumnSummary(entry.channel[c]);
+    }
+}
+
+/**
+ * @brief Add one row to an index entry
+ */
+static void addRow(ColumnIndexEntry &entry, uint64_t us, const int16_t *values) {
+    if (entry.rows == 0) {
+        entry.firstUs = us;
+    }
+    entry.lastUs = us;
+    entry.rows++;
+    for (uint8_t c = 0; c < PB7200_COLUMN_CHANNELS; c++) {
+        if (values[c] != PB7200_COLUMN_NULL) {
+            addValue(entry.channel[c], values[c]);
+        }
+    }
+}
+
+/**
+ * @brief Merge a block entry into its superblock entry
+ */
+static void mergeEntry(ColumnIndexEntry &entry, const ColumnIndexEntry &other) {
+    if (other.rows == 0) {
+        return;
+    }
+    if (entry.rows == 0) {
+        entry.firstUs = other.firstUs;
+    }
+    entry.lastUs = other.lastUs;
+    entry.rows += other.rows;
+    for (uint8_t c = 0; c < PB7200_COLUMN_CHANNELS; c++) {
+        mergeSummary(entry.channel[c], other.channel[c]);
+    }
+}
+
+/**
+ * @brief Get the file offset of an index entry
+ */
+static off_t entryOffset(uint32_t block) {
+    uint32_t group = block / PB7200_COLUMN_FANOUT;
+    return PB7200_COLUMN_FILE_HEADER + (off_t)group * GROUP_BYTES +
+           (off_t)(1 + block % PB7200_COLUMN_FANOUT) * sizeof(ColumnIndexEntry);
+}
+
+/**
+ * @brief Fill the cell spread from the cell columns
+ */
+static void fillDelta(int16_t *values) {
+    int16_t low = INT16_MAX;
+    int16_t high = INT16_MIN;
+    for (uint8_t i = 0; i < PB7200_MAX_CELLS; i++) {
+        int16_t v = values[PB7200_COLUMN_CELL + i];
+        if (v != PB7200_COLUMN_NULL) {
+            low = v < low ? v : low;
+            high = v > high ? v : high;
+        }
+    }
+    values[PB7200_COLUMN_DELTA] = high >= low ? (int16_t)(high - low) : PB7200_COLUMN_NULL;
+}
+
+/**
+ * @brief Convert a telemetry view to one row
+ */
+void columnRow(const TelemetryView &view, int16_t *values) {
+    for (uint8_t i = 0; i < PB7200_MAX_CELLS; i++) {
+        bool valid = i < view.cellCount && (view.cellValid & (1UL << i));
+        values[PB7200_COLUMN_CELL + i] = valid ? (int16_t)view.cellRaw[i] : PB7200_COLUMN_NULL;
+    }
+    for (uint8_t i = 0; i < PB7200_MAX_TEMPS; i++) {
+        bool valid = i < view.tempCount && (view.tempValid & (1U << i));
+        values[PB7200_COLUMN_TEMP + i] = valid ? view.tempRaw[i] : PB7200_COLUMN_NULL;
+    }
+    values[PB7200_COLUMN_CURRENT] = view.currentRaw;
+    values[PB7200_COLUMN_VOLTAGE] = (int16_t)view.packVoltage10mV;
+    values[PB7200_COLUMN_STATUS] = (int16_t)((view.status << 8) | view.faultStatus);
+    fillDelta(values);
+}
+
+/**
+ * @brief Convert a snapshot to one row
+ */
+void columnRow(const PackSnapshot &snapshot, int16_t *values) {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < PB7200_MAX_CELLS; i++) {
+        if (i < snapshot.cellCount) {
+            values[PB7200_COLUMN_CELL + i] = (int16_t)snapshot.cellRaw[i];
+            total += snapshot.cellRaw[i];
+        } else {
+            values[PB7200_COLUMN_CELL + i] = PB7200_COLUMN_NULL;
+        }
+    }
+    for (uint8_t i = 0; i < PB7200_MAX_TEMPS; i++) {
+        values[PB7200_COLUMN_TEMP + i] = i < snapshot.tempCount ? snapshot.tempRaw[i]
+                                                                : PB7200_COLUMN_NULL;
+    }
+    values[PB7200_COLUMN_CURRENT] = snapshot.currentRaw;
+    values[PB7200_COLUMN_VOLTAGE] = (int16_t)((total + 5) / 10);
+    values[PB7200_COLUMN_STATUS] = (int16_t)((snapshot.status << 8) | snapshot.faultStatus);
+    fillDelta(values);
+}
+
+/**
+ * @brief Reset a block header to an empty block
+ */
+static void initBlock(ColumnBlockHeader *header) {
+    header->magic = PB7200_COLUMN_BLOCK_MAGIC;
+    header->rows = 0;
+    header->firstUs = 0;
+    header->lastUs = 0;
+    for (uint8_t c = 0; c < PB7200_COLUMN_CHANNELS; c++) {
+        header->minValue[c] = INT16_MAX;
+        header->maxValue[c] = INT16_MIN;
+    }
+}
+
+// ========== Writer ==========
+
+/**
+ * @brief Constructor
+ */
+ColumnWriter::ColumnWriter() {
+    _path = nullptr;
+    memset(&_header, 0, sizeof(_header));
+    _blockIndex = 0;
+    _block = nullptr;
+    _fullRows = 0;
+    _indexPath = nullptr;
+    _group = nullptr;
+    _groupIndex = 0;
+    _groupOffset = 0;
+}
+
+/**
+ * @brief Destructor
+ */
+ColumnWriter::~ColumnWriter() {
+    close();
+}
+
+/**
+ * @brief Create a file, or continue an existing one
+ */
+bool ColumnWriter::open(const char *path, uint16_t packId, uint32_t blockRows) {
+    close();
+    if (blockRows == 0) {
+        return false;
+    }
+
+    int fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0;
+    uint32_t blocks = 0;
+
+    if (ok && st.st_size >= PB7200_COLUMN_FILE_HEADER) {
+        // Existing file: continue in its last block
+        ok = pread(fd, &_header, sizeof(_header), 0) == (ssize_t)sizeof(_header) &&
+             _header.magic == PB7200_COLUMN_FILE_MAGIC &&
+             _header.version == PB7200_COLUMN_VERSION &&
+             _header.channelCount == PB7200_COLUMN_CHANNELS &&
+             _header.blockSize == columnBlockSize(_header.blockRows) &&
+             _header.packId == packId;
+        blocks = ok ? (uint32_t)((st.st_size - PB7200_COLUMN_FILE_HEADER) / _header.blockSize) : 0;
+    } else if (ok) {
+        // New file
+        uint8_t page[PB7200_COLUMN_FILE_HEADER];
+        memset(page, 0, sizeof(page));
+        _header.magic = PB7200_COLUMN_FILE_MAGIC;
+        _header.version = PB7200_COLUMN_VERSION;
+        _header.channelCount = PB7200_COLUMN_CHANNELS;
+        _header.blockRows = blockRows;
+        _header.blockSize = columnBlockSize(blockRows);
+        _header.packId = packId;
+        memcpy(page, &_header, sizeof(_header));
+        ok = pwrite(fd, page, sizeof(page), 0) == (ssize_t)sizeof(page);
+    }
+    ::close(fd);
+
+    if (!ok) {
+        return false;
+    }
+
+    _path = strdup(path);
+    _fullRows = (uint64_t)(blocks > 0 ? blocks - 1 : 0) * _header.blockRows;
+    if (!mapBlock(blocks > 0 ? blocks - 1 : 0, blocks == 0) || !openIndex(blocks)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Append a row
+ */
+bool ColumnWriter::append(uint64_t us, const int16_t *values) {
+    if (_block == nullptr) {
+        return false;
+    }
+
+    ColumnBlockHeader *header = (ColumnBlockHeader *)_block;
+    if (header->rows > 0 && us < header->lastUs) {
+        return false;
+    }
+    if (header->rows == _header.blockRows) {
+        _fullRows += header->rows;
+        if (!mapBlock(_blockIndex + 1, true)) {
+            return false;
+        }
+        if (_blockIndex / PB7200_COLUMN_FANOUT != _groupIndex &&
+            !mapGroup(_blockIndex / PB7200_COLUMN_FANOUT)) {
+            return false;
+        }
+        header = (ColumnBlockHeader *)_block;
+    }
+
+    uint32_t row = header->rows;
+    uint32_t rows = _header.blockRows;
+    uint64_t *times = (uint64_t *)(_block + PB7200_COLUMN_BLOCK_HEADER);
+    int16_t *columns = (int16_t *)(times + rows);
+
+    times[row] = us;
+    for (uint8_t c = 0; c < PB7200_COLUMN_CHANNELS; c++) {
+        int16_t v = values[c];
+        columns[c * rows + row] = v;
+        if (v != PB7200_COLUMN_NULL) {
+            if (v < header->minValue[c]) {
+                header->minValue[c] = v;
+            }
+            if (v > header->maxValue[c]) {
+                header->maxValue[c] = v;
+            }
+        }
+    }
+
+    if (row == 0) {
+        header->firstUs = us;
+    }
+    header->lastUs = us;
+    header->rows = row + 1;
+
+    // Summaries follow the data, so a reader never sees them ahead of it
+    ColumnIndexEntry *entries = (ColumnIndexEntry *)(_group + _groupOffset);
+    addRow(entries[1 + _blockIndex % PB7200_COLUMN_FANOUT], us, values);
+    addRow(entries[0], us, values);
+    return true;
+}
+
+/**
+ * @brief Append a decoded telemetry view
+ */
+bool ColumnWriter::append(uint64_t us, const TelemetryView &view) {
+    int16_t values[PB7200_COLUMN_CHANNELS];
+    columnRow(view, values);
+    return append(us, values);
+}
+
+/**
+ * @brief Append a snapshot
+ */
+bool ColumnWriter::append(uint64_t us, const PackSnapshot &snapshot) {
+    int16_t values[PB7200_COLUMN_CHANNELS];
+    columnRow(snapshot, values);
+    return append(us, values);
+}
+
+/**
+ * @brief Write mapped rows to disk now
+ */
+bool ColumnWriter::sync() {
+    if (_block == nullptr) {
+        return true;
+    }
+    return msync(_block, _header.blockSize, MS_SYNC) == 0 &&
+           msync(_group, _groupOffset + GROUP_BYTES, MS_SYNC) == 0;
+}
+
+/**
+ * @brief Unmap and close
+ */
+void ColumnWriter::close() {
+    if (_block != nullptr) {
+        munmap(_block, _header.blockSize);
+        _block = nullptr;
+    }
+    unmapGroup();
+    free(_path);
+    _path = nullptr;
+    free(_indexPath);
+    _indexPath = nullptr;
+}
+
+/**
+ * @brief Check whether a file is open
+ */
+bool ColumnWriter::isOpen() const {
+    return _block != nullptr;
+}
+
+/**
+ * @brief Get number of rows in the file
+ */
+uint64_t ColumnWriter::rowCount() const {
+    return _block != nullptr ? _fullRows + ((const ColumnBlockHeader *)_block)->rows : 0;
+}
+
+/**
+ * @brief Get the time of the last row
+ */
+uint64_t ColumnWriter::lastTime() const {
+    if (_block == nullptr) {
+        return 0;
+    }
+    // Only a new file has an empty block; later blocks are mapped by their first row
+    const ColumnBlockHeader *header = (const ColumnBlockHeader *)_block;
+    return header->rows > 0 ? header->lastUs : 0;
+}
+
+/**
+ * @brief Map a block, growing the file for a new one
+ */
+bool ColumnWriter::mapBlock(uint32_t index, bool create) {
+    if (_block != nullptr) {
+        munmap(_block, _header.blockSize);
+        _block = nullptr;
+    }
+
+    int fd = ::open(_path, O_RDWR);
+    if (fd < 0) {
+        return false;
+    }
+
+    off_t offset = PB7200_COLUMN_FILE_HEADER + (off_t)index * _header.blockSize;
+    if (create && ftruncate(fd, offset + _header.blockSize) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void *map = mmap(nullptr, _header.blockSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, offset);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+
+    _block = (uint8_t *)map;
+    _blockIndex = index;
+    ColumnBlockHeader *header = (ColumnBlockHeader *)_block;
+    if (create || header->magic != PB7200_COLUMN_BLOCK_MAGIC) {
+        initBlock(header);
+    }
+    return true;
+}
+
+/**
+ * @brief Open the summary index and bring it up to date with the data
+ */
+bool ColumnWriter::openIndex(uint32_t blocks) {
+    char path[512];
+    if (!columnIndexPath(_path, path, sizeof(path))) {
+        return false;
+    }
+    _indexPath = strdup(path);
+
+    int fd = ::open(_indexPath, O_RDWR | O_CREAT, 0644);
+    int dataFd = ::open(_path, O_RDONLY);
+    struct stat st;
+    bool ok = fd >= 0 && dataFd >= 0 && fstat(fd, &st) == 0;
+
+    // A missing or foreign index is rebuilt from the data
+    ColumnIndexHeader header;
+    bool valid = ok && st.st_size >= PB7200_COLUMN_FILE_HEADER &&
+                 pread(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) &&
+                 header.magic == PB7200_COLUMN_INDEX_MAGIC &&
+                 header.version == PB7200_COLUMN_VERSION &&
+                 header.channelCount == PB7200_COLUMN_CHANNELS &&
+                 header.blockRows == _header.blockRows &&
+                 header.fanout == PB7200_COLUMN_FANOUT && header.packId == _header.packId;
+    uint32_t groups = valid ? (uint32_t)((st.st_size - PB7200_COLUMN_FILE_HEADER) / GROUP_BYTES) : 0;
+
+    if (ok && !valid) {
+        uint8_t page[PB7200_COLUMN_FILE_HEADER];
+        memset(page, 0, sizeof(page));
+        header.magic = PB7200_COLUMN_INDEX_MAGIC;
+        header.version = PB7200_COLUMN_VERSION;
+        header.channelCount = PB7200_COLUMN_CHANNELS;
+        header.blockRows = _header.blockRows;
+        header.fanout = PB7200_COLUMN_FANOUT;
+        header.packId = _header.packId;
+        memcpy(page, &header, sizeof(header));
+        ok = ftruncate(fd, 0) == 0 && pwrite(fd, page, sizeof(page), 0) == (ssize_t)sizeof(page);
+    }
+
+    // Empty groups up to the current block
+    ColumnIndexEntry group[GROUP_ENTRIES];
+    for (uint32_t i = 0; i < GROUP_ENTRIES; i++) {
+        initEntry(group[i]);
+    }
+    uint32_t needed = _blockIndex / PB7200_COLUMN_FANOUT + 1;
+    for (uint32_t g = groups; ok && g < needed; g++) {
+        off_t offset = PB7200_COLUMN_FILE_HEADER + (off_t)g * GROUP_BYTES;
+        ok = pwrite(fd, group, GROUP_BYTES, offset) == (ssize_t)GROUP_BYTES;
+    }
+
+    // Re-summarize blocks from the end back to the first that matches the data
+    uint32_t lowest = _blockIndex;
+    std::vector<uint8_t> data;
+    for (uint32_t b = blocks; ok && b-- > 0;) {
+        ColumnBlockHeader block;
+        ColumnIndexEntry entry;
+        off_t dataOffset = PB7200_COLUMN_FILE_HEADER + (off_t)b * _header.blockSize;
+        ok = pread(dataFd, &block, sizeof(block), dataOffset) == (ssize_t)sizeof(block) &&
+             pread(fd, &entry, sizeof(entry), entryOffset(b)) == (ssize_t)sizeof(entry);
+        if (!ok) {
+            break;
+        }
+        if (block.rows != 0 && entry.rows == block.rows && entry.firstUs == block.firstUs &&
+            entry.lastUs == block.lastUs) {
+            break;
+        }
+
+        initEntry(entry);
+        if (block.rows != 0) {
+            data.resize(_header.blockSize);
+            ok = pread(dataFd, data.data(), data.size(), dataOffset) == (ssize_t)data.size();
+            const uint64_t *times = (const uint64_t *)(data.data() + PB7200_COLUMN_BLOCK_HEADER);
+            const int16_t *columns = (const int16_t *)(times + _header.blockRows);
+            int16_t values[PB7200_COLUMN_CHANNELS];
+            for (uint32_t r = 0; ok && r < block.rows && r < _header.blockRows; r++) {
+                for (uint8_t c = 0; c < PB7200_COLUMN_CHANNELS; c++) {
+                    values[c] = columns[c * _header.blockRows + r];
+                }
+                addRow(entry, times[r], values);
+            }
+        }
+        ok = ok && pwrite(fd, &entry, sizeof(entry), entryOffset(b)) == (ssize_t)sizeof(entry);
+        lowest = b;
+    }
+
+    // Superblocks of the repaired groups, and always the current one
+    for (uint32_t g = lowest / PB7200_COLUMN_FANOUT; ok && g < needed; g++) {
+        off_t offset = PB7200_COLUMN_FILE_HEADER + (off_t)g * GROUP_BYTES;
+        ok = pread(fd, group, GROUP_BYTES, offset) == (ssize_t)GROUP_BYTES;
+        initEntry(group[0]);
+        for (uint32_t i = 1; ok && i < GROUP_ENTRIES; i++) {
+            mergeEntry(group[0], group[i]);
+        }
+        ok = ok && pwrite(fd, &group[0], sizeof(group[0]), offset) == (ssize_t)sizeof(group[0]);
+    }
+
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    if (dataFd >= 0) {
+        ::close(dataFd);
+    }
+    return ok && mapGroup(_blockIndex / PB7200_COLUMN_FANOUT);
+}
+
+/**
+ * @brief Map an index group, adding it to the file when new
+ */
+bool ColumnWriter::mapGroup(uint32_t index) {
+    unmapGroup();
+
+    int fd = ::open(_indexPath, O_RDWR);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return false;
+    }
+
+    off_t offset = PB7200_COLUMN_FILE_HEADER + (off_t)index * GROUP_BYTES;
+    off_t end = offset + GROUP_BYTES;
+    bool create = st.st_size < end;
+    if (create && ftruncate(fd, end) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // mmap needs a page-aligned offset
+    off_t aligned = offset / PAGE_SIZE_BYTES * PAGE_SIZE_BYTES;
+    void *map = mmap(nullptr, end - aligned, PROT_READ | PROT_WRITE, MAP_SHARED, fd, aligned);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+
+    _group = (uint8_t *)map;
+    _groupIndex = index;
+    _groupOffset = (uint32_t)(offset - aligned);
+    if (create) {
+        ColumnIndexEntry *entries = (ColumnIndexEntry *)(_group + _groupOffset);
+        for (uint32_t i = 0; i < GROUP_ENTRIES; i++) {
+            initEntry(entries[i]);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Unmap the index group
+ */
+void ColumnWriter::unmapGroup() {
+    if (_group != nullptr) {
+        munmap(_group, _groupOffset + GROUP_BYTES);
+        _group = nullptr;
+    }
+}
+
+// ========== Reader ==========
+
+/**
+ * @brief Constructor
+ */
+ColumnReader::ColumnReader() {
+    _map = nullptr;
+    _size = 0;
+    _header = nullptr;
+    _blockCount = 0;
+    _index = nullptr;
+    _indexSize = 0;
+    _indexBlocks = 0;
+}
+
+/**
+ * @brief Destructor
+ */
+ColumnReader::~ColumnReader() {
+    close();
+}
+
+/**
+ * @brief Map a file
+ */
+bool ColumnReader::open(const char *path) {
+    close();
+
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < PB7200_COLUMN_FILE_HEADER) {
+        ::close(fd);
+        return false;
+    }
+
+    void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    _map = (const uint8_t *)map;
+    _size = st.st_size;
+    _header = (const ColumnFileHeader *)_map;
+
+    if (_header->magic != PB7200_COLUMN_FILE_MAGIC || _header->version != PB7200_COLUMN_VERSION ||
+        _header->channelCount != PB7200_COLUMN_CHANNELS ||
+        _header->blockSize != columnBlockSize(_header->blockRows)) {
+        close();
+        return false;
+    }
+
+    // A block the writer has just added may still be empty
+    _blockCount = (uint32_t)((_size - PB7200_COLUMN_FILE_HEADER) / _header->blockSize);
+    while (_blockCount > 0 && block(_blockCount - 1).rows == 0) {
+        _blockCount--;
+    }
+
+    // Without an index, queries read the data
+    openIndex(path);
+    return true;
+}
+
+/**
+ * @brief Unmap the file
+ */
+void ColumnReader::close() {
+    if (_map != nullptr) {
+        munmap((void *)_map, _size);
+    }
+    _map = nullptr;
+    _size = 0;
+    _header = nullptr;
+    _blockCount = 0;
+    if (_index != nullptr) {
+        munmap((void *)_index, _indexSize);
+    }
+    _index = nullptr;
+    _indexSize = 0;
+    _indexBlocks = 0;
+}
+
+/**
+ * @brief Get the pack identifier
+ */
+uint16_t ColumnReader::packId() const {
+    return _header != nullptr ? _header->packId : 0;
+}
+
+/**
+ * @brief Get rows per block
+ */
+uint32_t ColumnReader::blockRows() const {
+    return _header != nullptr ? _header->blockRows : 0;
+}
+
+/**
+ * @brief Get number of blocks holding rows
+ */
+uint32_t ColumnReader::blockCount() const {
+    return _blockCount;
+}
+
+/**
+ * @brief Get number of rows
+ */
+uint64_t ColumnReader::rowCount() const {
+    if (_blockCount == 0) {
+        return 0;
+    }
+    return (uint64_t)(_blockCount - 1) * _header->blockRows + block(_blockCount - 1).rows;
+}
+
+/**
+ * @brief Get a block header
+ */
+const ColumnBlockHeader &ColumnReader::block(uint32_t block) const {
+    return *(const ColumnBlockHeader *)blockData(block);
+}
+
+/**
+ * @brief Get the time column of a block
+ */
+const uint64_t *ColumnReader::times(uint32_t block) const {
+    return (const uint64_t *)(blockData(block) + PB7200_COLUMN_BLOCK_HEADER);
+}
+
+/**
+ * @brief Get a value column of a block
+ */
+const int16_t *ColumnReader::column(uint32_t block, uint8_t channel) const {
+    const int16_t *columns = (const int16_t *)(times(block) + _header->blockRows);
+    return columns + (size_t)channel * _header->blockRows;
+}
+
+/**
+ * @brief Find the first block ending at or after a time
+ */
+uint32_t ColumnReader::findBlock(uint64_t us) const {
+    uint32_t low = 0;
+    uint32_t high = _blockCount;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if (block(mid).lastUs < us) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/**
+ * @brief Find the lowest and highest value of a channel in a time range
+ */
+bool ColumnReader::extremes(uint8_t channel, uint64_t fromUs, uint64_t toUs,
+                            ColumnExtremes &result) const {
+    result.minValue = INT16_MAX;
+    result.maxValue = INT16_MIN;
+    result.minUs = 0;
+    result.maxUs = 0;
+    if (channel >= PB7200_COLUMN_CHANNELS) {
+        return false;
+    }
+
+    if (_indexBlocks > 0) {
+        // Values from the summaries, then the first row holding each
+        ColumnSummary summary;
+        summarize(channel, fromUs, toUs, summary);
+        if (summary.count == 0) {
+            return false;
+        }
+        result.minValue = summary.minValue;
+        result.maxValue = summary.maxValue;
+        locate(channel, fromUs, toUs, summary.minValue, result.minUs);
+        locate(channel, fromUs, toUs, summary.maxValue, result.maxUs);
+        return true;
+    }
+
+    for (uint32_t b = findBlock(fromUs); b < _blockCount; b++) {
+        const ColumnBlockHeader &header = block(b);
+        if (header.firstUs > toUs) {
+            break;
+        }
+
+        // Inner blocks that cannot improve either extreme are skipped unread
+        bool inside = header.firstUs >= fromUs && header.lastUs <= toUs;
+        if (inside && header.minValue[channel] >= result.minValue &&
+            header.maxValue[channel] <= result.maxValue) {
+            continue;
+        }
+
+        const uint64_t *t = times(b);
+        const int16_t *v = column(b, channel);
+        for (uint32_t r = firstRow(b, fromUs); r < header.rows && t[r] <= toUs; r++) {
+            if (v[r] == PB7200_COLUMN_NULL) {
+                continue;
+            }
+            if (v[r] < result.minValue) {
+                result.minValue = v[r];
+                result.minUs = t[r];
+            }
+            if (v[r] > result.maxValue) {
+                result.maxValue = v[r];
+                result.maxUs = t[r];
+            }
+        }
+    }
+    return result.minValue <= result.maxValue;
+}
+
+/**
+ * @brief Aggregate a channel over a time range
+ */
+void ColumnReader::summarize(uint8_t channel, uint64_t fromUs, uint64_t toUs,
+                             ColumnSummary &result) const {
+    resetColumnSummary(result);
+    if (channel >= PB7200_COLUMN_CHANNELS) {
+        return;
+    }
+
+    walk(channel, fromUs, toUs,
+        [](const ColumnSummary &summary) {
+            return summary.count == 0;
+        },
+        [&](const ColumnSummary &summary) {
+            mergeSummary(result, summary);
+            return true;
+        },
+        [&](const uint64_t *, const int16_t *v, uint32_t first, uint32_t end) {
+            for (uint32_t r = first; r < end; r++) {
+                if (v[r] != PB7200_COLUMN_NULL) {
+                    addValue(result, v[r]);
+                }
+            }
+        });
+}
+
+/**
+ * @brief Check whether the summary index was found
+ */
+bool ColumnReader::hasIndex() const {
+    return _index != nullptr;
+}
+
+/**
+ * @brief Find the time of the first row holding a value
+ */
+void ColumnReader::locate(uint8_t channel, uint64_t fromUs, uint64_t toUs, int16_t value,
+                          uint64_t &us) const {
+    bool found = false;
+    walk(channel, fromUs, toUs,
+        [&](const ColumnSummary &summary) {
+            return found || summary.count == 0 || value < summary.minValue ||
+                   value > summary.maxValue;
+        },
+        [](const ColumnSummary &) {
+            return false;
+        },
+        [&](const uint64_t *t, const int16_t *v, uint32_t first, uint32_t end) {
+            for (uint32_t r = first; !found && r < end; r++) {
+                if (v[r] == value) {
+                    us = t[r];
+                    found = true;
+                }
+            }
+        });
+}
+
+/**
+ * @brief Map the summary index of a data file, if there is one
+ */
+bool ColumnReader::openIndex(const char *path) {
+    char indexPath[512];
+    if (!columnIndexPath(path, indexPath, sizeof(indexPath))) {
+        return false;
+    }
+    int fd = ::open(indexPath, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)(PB7200_COLUMN_FILE_HEADER + GROUP_BYTES)) {
+        ::close(fd);
+        return false;
+    }
+    void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    _index = (const uint8_t *)map;
+    _indexSize = st.st_size;
+
+    const ColumnIndexHeader *header = (const ColumnIndexHeader *)_index;
+    if (header->magic != PB7200_COLUMN_INDEX_MAGIC || header->version != PB7200_COLUMN_VERSION ||
+        header->channelCount != PB7200_COLUMN_CHANNELS ||
+        header->blockRows != _header->blockRows || header->fanout != PB7200_COLUMN_FANOUT ||
+        header->packId != _header->packId) {
+        munmap(map, _indexSize);
+        _index = nullptr;
+        _indexSize = 0;
+        return false;
+    }
+
+    // Blocks summarized: full groups, then the used entries of the last
+    uint32_t groups = (uint32_t)((_indexSize - PB7200_COLUMN_FILE_HEADER) / GROUP_BYTES);
+    uint32_t used = 0;
+    while (used < PB7200_COLUMN_FANOUT &&
+           blockEntry((groups - 1) * PB7200_COLUMN_FANOUT + used).rows > 0) {
+        used++;
+    }
+    _indexBlocks = (groups - 1) * PB7200_COLUMN_FANOUT + used;
+    if (_indexBlocks > _blockCount) {
+        _indexBlocks = _blockCount;
+    }
+    return true;
+}
+
+/**
+ * @brief Get the index entry of a superblock
+ */
+const ColumnIndexEntry &ColumnReader::superEntry(uint32_t group) const {
+    return *(const ColumnIndexEntry *)(_index + PB7200_COLUMN_FILE_HEADER +
+                                       (size_t)group * GROUP_BYTES);
+}
+
+/**
+ * @brief Get the index entry of a block
+ */
+const ColumnIndexEntry &ColumnReader::blockEntry(uint32_t block) const {
+    return *(const ColumnIndexEntry *)(_index + entryOffset(block));
+}
+
+/**
+ * @brief Get the start of a block in the mapping
+ */
+const uint8_t *ColumnReader::blockData(uint32_t block) const {
+    return _map + PB7200_COLUMN_FILE_HEADER + (size_t)block * _header->blockSize;
+}
+
+/**
+ * @brief Find the first row of a block at or after a time
+ */
+uint32_t ColumnReader::firstRow(uint32_t block, uint64_t us) const {
+    const uint64_t *t = times(block);
+    uint32_t low = 0;
+    uint32_t high = this->block(block).rows;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if (t[mid] < us) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
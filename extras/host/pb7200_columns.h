@@ -0,0 +1,548 @@
+/**
+ * @file pb7200_columns.h
+ * @brief Columnar, memory-mapped store of recorded pack data
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * One file per pack. After a 4 KB file header the file is a sequence of
+ * fixed-size, page-aligned blocks of up to blockRows rows:
+ *
+ *   block header (256 bytes): rows, first/last time, min/max per channel
+ *   times[blockRows]                 uint64, µs since the epoch
+ *   column[channel][blockRows]       int16 per channel
+ *
+ * Every value keeps its register unit (see PB7200_ColumnChannel), so the
+ * reader maps the file and uses the arrays directly: nothing is parsed.
+ * Because blocks have a fixed size and times only increase, block b
+ * starts at a computed offset and a time is found by binary search over
+ * the block headers. The per-block min/max answer range extremes without
+ * touching the columns of fully covered blocks.
+ *
+ * The writer also maps the block it is filling, so rows are visible to
+ * readers as soon as they are appended and the kernel writes them back.
+ * All fields are little-endian (x86, ARM Linux gateways).
+ *
+ * Next to each data file (pack-N.pbc) the writer keeps a summary index
+ * (pack-N.pbx) with min/max/sum/count per channel for every block and
+ * for every superblock of PB7200_COLUMN_FANOUT blocks, updated on each
+ * append. The index is laid out as groups of one superblock entry
+ * followed by its block entries, so range queries walk the superblocks,
+ * descend only at the range edges or where a summary cannot decide, and
+ * read raw rows of at most a few blocks.
+ */
+
+#ifndef PB7200_COLUMNS_H
+#define PB7200_COLUMNS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "PB7200Types.h"
+#include "PB7200Telemetry.h"
+
+#define PB7200_COLUMN_FILE_MAGIC 0x46434250UL   // "PBCF"
+#define PB7200_COLUMN_BLOCK_MAGIC 0x42434250UL  // "PBCB"
+#define PB7200_COLUMN_VERSION 1
+#define PB7200_COLUMN_FILE_HEADER 4096
+#define PB7200_COLUMN_BLOCK_HEADER 256
+#define PB7200_COLUMN_ROWS 1024
+#define PB7200_COLUMN_INDEX_MAGIC 0x58434250UL  // "PBCX"
+#define PB7200_COLUMN_FANOUT 64                 // Blocks per superblock
+
+// Value of a channel with no data in a row (cell not received yet, ...)
+#define PB7200_COLUMN_NULL INT16_MIN
+
+/**
+ * @brief Channels stored for every row
+ */
+enum PB7200_ColumnChannel {
+    PB7200_COLUMN_CELL = 0,                                      // + cell, mV
+    PB7200_COLUMN_TEMP = PB7200_MAX_CELLS,                       // + sensor, 0.1 °C
+    PB7200_COLUMN_CURRENT = PB7200_MAX_CELLS + PB7200_MAX_TEMPS, // 10 mA
+    PB7200_COLUMN_VOLTAGE,                                       // Pack, 10 mV
+    PB7200_COLUMN_DELTA,                                         // Max - min cell, mV
+    PB7200_COLUMN_STATUS,                                        // status << 8 | faults
+    PB7200_COLUMN_CHANNELS
+};
+
+/**
+ * @brief File header
+ */
+struct ColumnFileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t channelCount;
+    uint32_t blockRows;
+    uint32_t blockSize;     // Bytes, multiple of 4096
+    uint16_t packId;
+};
+
+/**
+ * @brief Header of one block
+ */
+struct ColumnBlockHeader {
+    uint32_t magic;
+    uint32_t rows;          // Rows written
+    uint64_t firstUs;       // Time of the first row
+    uint64_t lastUs;        // Time of the last row
+    int16_t minValue[PB7200_COLUMN_CHANNELS];  // INT16_MAX when all null
+    int16_t maxValue[PB7200_COLUMN_CHANNELS];  // INT16_MIN when all null
+};
+
+/**
+ * @brief Aggregate of one channel over a block, superblock or range
+ */
+struct ColumnSummary {
+    int64_t sum;            // Sum of the non-null values
+    uint32_t count;         // Number of non-null values
+    int16_t minValue;       // INT16_MAX when count is 0
+    int16_t maxValue;       // INT16_MIN when count is 0
+};
+
+/**
+ * @brief Summary index entry of a block or superblock
+ */
+struct ColumnIndexEntry {
+    uint64_t firstUs;
+    uint64_t lastUs;
+    uint32_t rows;
+    uint32_t reserved;
+    ColumnSummary channel[PB7200_COLUMN_CHANNELS];
+};
+
+/**
+ * @brief Summary index file header
+ */
+struct ColumnIndexHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t channelCount;
+    uint32_t blockRows;
+    uint32_t fanout;
+    uint16_t packId;
+};
+
+/**
+ * @brief Result of an extremes query
+ */
+struct ColumnExtremes {
+    int16_t minValue;
+    int16_t maxValue;
+    uint64_t minUs;         // Time of the first row holding the minimum
+    uint64_t maxUs;         // Time of the first row holding the maximum
+};
+
+/**
+ * @brief Get the size of a block
+ * @param blockRows Rows per block
+ * @return Bytes, rounded up to whole pages
+ */
+uint32_t columnBlockSize(uint32_t blockRows);
+
+/**
+ * @brief Get the summary index path of a data file
+ * @param path Data file path (.pbc)
+ * @param out Output buffer
+ * @param size Buffer size
+ * @return false if the buffer is too small
+ */
+bool columnIndexPath(const char *path, char *out, size_t size);
+
+/**
+ * @brief Clear a summary
+ * @param summary Summary
+ */
+void resetColumnSummary(ColumnSummary &summary);
+
+/**
+ * @brief Convert a telemetry view to one row
+ * @param view Decoded telemetry
+ * @param values Output, PB7200_COLUMN_CHANNELS values
+ */
+void columnRow(const TelemetryView &view, int16_t *values);
+
+/**
+ * @brief Convert a snapshot to one row
+ * @param snapshot Raw snapshot
+ * @param values Output, PB7200_COLUMN_CHANNELS values
+ */
+void columnRow(const PackSnapshot &snapshot, int16_t *values);
+
+/**
+ * @brief Appends rows to a pack's column file
+ */
+class ColumnWriter {
+public:
+    ColumnWriter();
+    ~ColumnWriter();
+
+    /**
+     * @brief Create a file, or continue an existing one
+     *
+     * The summary index is created or brought up to date with the data
+     * (files written without one are indexed here, once).
+     *
+     * @param path File path
+     * @param packId Pack identifier (checked against an existing file)
+     * @param blockRows Rows per block for a new file
+     * @return true if successful
+     */
+    bool open(const char *path, uint16_t packId, uint32_t blockRows = PB7200_COLUMN_ROWS);
+
+    /**
+     * @brief Append a row
+     * @param us Time (µs since the epoch), not before the last row
+     * @param values PB7200_COLUMN_CHANNELS values
+     * @return false if out of order or on I/O error
+     */
+    bool append(uint64_t us, const int16_t *values);
+
+    /**
+     * @brief Append a decoded telemetry view
+     * @param us Time (µs since the epoch)
+     * @param view Telemetry view
+     * @return false if out of order or on I/O error
+     */
+    bool append(uint64_t us, const TelemetryView &view);
+
+    /**
+     * @brief Append a snapshot (replay from the driver or the simulator)
+     * @param us Time (µs since the epoch)
+     * @param snapshot Snapshot
+     * @return false if out of order or on I/O error
+     */
+    bool append(uint64_t us, const PackSnapshot &snapshot);
+
+    /**
+     * @brief Write mapped rows to disk now
+     * @return true if successful
+     */
+    bool sync();
+
+    /**
+     * @brief Unmap and close
+     */
+    void close();
+
+    /**
+     * @brief Check whether a file is open
+     * @return true if open
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Get number of rows in the file
+     * @return Row count
+     */
+    uint64_t rowCount() const;
+
+    /**
+     * @brief Get the time of the last row
+     * @return Time (µs since the epoch), 0 if the file has no rows
+     */
+    uint64_t lastTime() const;
+
+private:
+    char *_path;
+    ColumnFileHeader _header;
+    uint32_t _blockIndex;
+    uint8_t *_block;
+    uint64_t _fullRows;     // Rows in blocks before the mapped one
+
+    ColumnWriter(const ColumnWriter &);
+    ColumnWriter &operator=(const ColumnWriter &);
+
+    char *_indexPath;
+    uint8_t *_group;        // Mapped index group of the current block
+    uint32_t _groupIndex;
+    uint32_t _groupOffset;  // Start of the group within the mapping
+
+    bool mapBlock(uint32_t index, bool create);
+    bool openIndex(uint32_t blocks);
+    bool mapGroup(uint32_t index);
+    void unmapGroup();
+};
+
+/**
+ * @brief Read-only view of a pack's column file
+ */
+class ColumnReader {
+public:
+    ColumnReader();
+    ~ColumnReader();
+
+    /**
+     * @brief Map a file
+     * @param path File path
+     * @return false if missing or not a column file
+     */
+    bool open(const char *path);
+
+    /**
+     * @brief Unmap the file
+     */
+    void close();
+
+    /**
+     * @brief Get the pack identifier
+     * @return Pack id
+     */
+    uint16_t packId() const;
+
+    /**
+     * @brief Get rows per block
+     * @return Block capacity
+     */
+    uint32_t blockRows() const;
+
+    /**
+     * @brief Get number of blocks holding rows
+     * @return Block count
+     */
+    uint32_t blockCount() const;
+
+    /**
+     * @brief Get number of rows
+     * @return Row count
+     */
+    uint64_t rowCount() const;
+
+    /**
+     * @brief Get a block header
+     * @param block Block index
+     * @return Header (min/max per channel, time range)
+     */
+    const ColumnBlockHeader &block(uint32_t block) const;
+
+    /**
+     * @brief Get the time column of a block
+     * @param block Block index
+     * @return block(block).rows times (µs)
+     */
+    const uint64_t *times(uint32_t block) const;
+
+    /**
+     * @brief Get a value column of a block
+     * @param block Block index
+     * @param channel PB7200_ColumnChannel
+     * @return block(block).rows values
+     */
+    const int16_t *column(uint32_t block, uint8_t channel) const;
+
+    /**
+     * @brief Find the first block ending at or after a time
+     * @param us Time (µs)
+     * @return Block index, blockCount() if none
+     */
+    uint32_t findBlock(uint64_t us) const;
+
+    /**
+     * @brief Find the lowest and highest value of a channel in a time range
+     *
+     * Blocks inside the range are answered from their headers; only the
+     * blocks at the range edges, and blocks holding a new extreme (to
+     * find its time), are scanned.
+     *
+     * @param channel PB7200_ColumnChannel
+     * @param fromUs Start (µs, inclusive)
+     * @param toUs End (µs, inclusive)
+     * @param result Output
+     * @return false if the range holds no value of the channel
+     */
+    bool extremes(uint8_t channel, uint64_t fromUs, uint64_t toUs,
+                  ColumnExtremes &result) const;
+
+    /**
+     * @brief Aggregate a channel over a time range
+     * @param channel PB7200_ColumnChannel
+     * @param fromUs Start (µs, inclusive)
+     * @param toUs End (µs, inclusive)
+     * @param result Output (count 0 if the range holds no value)
+     */
+    void summarize(uint8_t channel, uint64_t fromUs, uint64_t toUs,
+                   ColumnSummary &result) const;
+
+    /**
+     * @brief Find the windows where a channel is beyond a threshold
+     *
+     * A window is a run of consecutive rows with value > threshold
+     * (above) or < threshold (below); null values end a window.
+     * Superblocks and blocks whose summary rules the condition out are
+     * skipped without reading their rows.
+     *
+     * @param channel PB7200_ColumnChannel
+     * @param fromUs Start (µs, inclusive)
+     * @param toUs End (µs, inclusive)
+     * @param threshold Threshold in register units
+     * @param above true for value > threshold, false for value < threshold
+     * @param visit Called as visit(firstUs, lastUs, peak) for every window
+     * @return Number of windows
+     */
+    template <typename Visitor>
+    uint32_t windows(uint8_t channel, uint64_t fromUs, uint64_t toUs, int16_t threshold,
+                     bool above, Visitor visit) const {
+        uint32_t found = 0;
+        bool open = false;
+        uint64_t firstUs = 0;
+        uint64_t lastUs = 0;
+        int16_t peak = 0;
+
+        walk(channel, fromUs, toUs,
+            [&](const ColumnSummary &summary) {
+                bool skip = summary.count == 0 || (above ? summary.maxValue <= threshold
+                                                         : summary.minValue >= threshold);
+                if (skip && open) {
+                    visit(firstUs, lastUs, peak);
+                    found++;
+                    open = false;
+                }
+                return skip;
+            },
+            [&](const ColumnSummary &) {
+                return false;
+            },
+            [&](const uint64_t *t, const int16_t *v, uint32_t first, uint32_t end) {
+                for (uint32_t r = first; r < end; r++) {
+                    bool beyond = v[r] != PB7200_COLUMN_NULL &&
+                                  (above ? v[r] > threshold : v[r] < threshold);
+                    if (beyond) {
+                        if (!open) {
+                            open = true;
+                            firstUs = t[r];
+                            peak = v[r];
+                        }
+                        lastUs = t[r];
+                        if (above ? v[r] > peak : v[r] < peak) {
+                            peak = v[r];
+                        }
+                    } else if (open) {
+                        visit(firstUs, lastUs, peak);
+                        found++;
+                        open = false;
+                    }
+                }
+            });
+
+        if (open) {
+            visit(firstUs, lastUs, peak);
+            found++;
+        }
+        return found;
+    }
+
+    /**
+     * @brief Check whether the summary index was found
+     * @return true if queries can use the index
+     */
+    bool hasIndex() const;
+
+    /**
+     * @brief Visit the values of a channel in a time range
+     * @param channel PB7200_ColumnChannel
+     * @param fromUs Start (µs, inclusive)
+     * @param toUs End (µs, inclusive)
+     * @param visit Called as visit(us, value) for every non-null value
+     * @return Number of values visited
+     */
+    template <typename Visitor>
+    uint64_t scan(uint8_t channel, uint64_t fromUs, uint64_t toUs, Visitor visit) const {
+        uint64_t visited = 0;
+        for (uint32_t b = findBlock(fromUs); b < _blockCount; b++) {
+            const ColumnBlockHeader &header = block(b);
+            if (header.firstUs > toUs) {
+                break;
+            }
+            const uint64_t *t = times(b);
+            const int16_t *v = column(b, channel);
+            for (uint32_t r = firstRow(b, fromUs); r < header.rows && t[r] <= toUs; r++) {
+                if (v[r] != PB7200_COLUMN_NULL) {
+                    visit(t[r], v[r]);
+                    visited++;
+                }
+            }
+        }
+        return visited;
+    }
+
+private:
+    const uint8_t *_map;
+    size_t _size;
+    const ColumnFileHeader *_header;
+    uint32_t _blockCount;
+
+    ColumnReader(const ColumnReader &);
+    ColumnReader &operator=(const ColumnReader &);
+
+    const uint8_t *_index;
+    size_t _indexSize;
+    uint32_t _indexBlocks;  // Blocks covered by the index
+
+    const uint8_t *blockData(uint32_t block) const;
+    uint32_t firstRow(uint32_t block, uint64_t us) const;
+    bool openIndex(const char *path);
+    void locate(uint8_t channel, uint64_t fromUs, uint64_t toUs, int16_t value,
+                uint64_t &us) const;
+    const ColumnIndexEntry &superEntry(uint32_t group) const;
+    const ColumnIndexEntry &blockEntry(uint32_t block) const;
+
+    /**
+     * @brief Walk a time range through the index, in time order
+     *
+     * For each superblock, then block, overlapping the range:
+     * skip(summary) returning true drops it (valid for any overlap, as
+     * the part in range lies within the summary); otherwise a node lying
+     * inside the range is offered to whole(summary), and if that
+     * declines, the walk descends. Rows of blocks at the range edges,
+     * or not yet indexed, go to rows(times, values, first, end).
+     */
+    template <typename Skip, typename Whole, typename Rows>
+    void walk(uint8_t channel, uint64_t fromUs, uint64_t toUs, Skip skip, Whole whole,
+              Rows rows) const {
+        uint32_t b = findBlock(fromUs);
+
+        while (b < _blockCount) {
+            // Superblock, once all its blocks are indexed
+            uint32_t group = b / PB7200_COLUMN_FANOUT;
+            uint32_t groupEnd = (group + 1) * PB7200_COLUMN_FANOUT;
+            if (groupEnd <= _indexBlocks) {
+                const ColumnIndexEntry &entry = superEntry(group);
+                if (entry.firstUs > toUs) {
+                    return;
+                }
+                bool inside = b % PB7200_COLUMN_FANOUT == 0 && entry.firstUs >= fromUs &&
+                              entry.lastUs <= toUs;
+                if (skip(entry.channel[channel]) || (inside && whole(entry.channel[channel]))) {
+                    b = groupEnd;
+                    continue;
+                }
+            }
+
+            // Then each block of the superblock
+            uint32_t end = groupEnd < _blockCount ? groupEnd : _blockCount;
+            for (; b < end; b++) {
+                const ColumnBlockHeader &header = block(b);
+                if (header.firstUs > toUs) {
+                    return;
+                }
+                if (b < _indexBlocks && blockEntry(b).rows == header.rows) {
+                    const ColumnSummary &summary = blockEntry(b).channel[channel];
+                    bool inside = header.firstUs >= fromUs && header.lastUs <= toUs;
+                    if (skip(summary) || (inside && whole(summary))) {
+                        continue;
+                    }
+                }
+
+                const uint64_t *t = times(b);
+                uint32_t first = firstRow(b, fromUs);
+                uint32_t last = first;
+                while (last < header.rows && t[last] <= toUs) {
+                    last++;
+                }
+                rows(t, column(b, channel), first, last);
+            }
+        }
+    }
+};
+
+#endif // PB7200_COLUMNS_H
@@ -0,0 +1,150 @@
+/**
+ * @file pb7200_faults.cpp
+ * @brief Fault-injecting PB7200Transport decorator for host testing
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ */
+
+#include "pb7200_faults.h"
+
+#include <string.h>
+
+#include "PB7200P80.h"
+
+// Fault register bits a spurious fault may set
+#define SPURIOUS_FAULT_BITS 5
+
+/**
+ * @brief Constructor, no faults enabled
+ */
+PB7200FaultTransport::PB7200FaultTransport(PB7200Transport &inner, uint32_t seed)
+    : _inner(inner), _rng(seed) {
+    memset(_schedules, 0, sizeof(_schedules));
+    memset(_injected, 0, sizeof(_injected));
+    _transfers = 0;
+    _stuckUntilUs = 0;
+}
+
+/**
+ * @brief Restart the bus: clears a stuck bus, then starts the inner transport
+ */
+bool PB7200FaultTransport::begin() {
+    _stuckUntilUs = 0;
+    return _inner.begin();
+}
+
+/**
+ * @brief Write registers through the inner transport, with faults
+ */
+bool PB7200FaultTransport::write(uint8_t reg, const uint8_t *values, uint8_t length) {
+    if (!beforeTransfer(micros())) {
+        return false;
+    }
+    return _inner.write(reg, values, length);
+}
+
+/**
+ * @brief Read registers through the inner transport, with faults
+ */
+bool PB7200FaultTransport::read(uint8_t reg, uint8_t *values, uint8_t length) {
+    uint64_t nowUs = micros();
+    if (!beforeTransfer(nowUs)) {
+        return false;
+    }
+
+    if (length > 0 && trigger(FAULT_SHORT_READ, nowUs)) {
+        // Part of the data lands in the buffer, the rest keeps old contents
+        uint8_t data[256];
+        if (_inner.read(reg, data, length)) {
+            memcpy(values, data, _rng() % length);
+        }
+        return false;
+    }
+
+    if (!_inner.read(reg, values, length)) {
+        return false;
+    }
+
+    if (length > 0 && trigger(FAULT_BIT_FLIP, nowUs)) {
+        uint32_t bit = _rng() % (length * 8u);
+        values[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+    }
+    if (reg <= PB7200_REG_FAULT_STATUS && reg + length > PB7200_REG_FAULT_STATUS &&
+        trigger(FAULT_SPURIOUS_FAULT, nowUs)) {
+        values[PB7200_REG_FAULT_STATUS - reg] |= (uint8_t)(1 << (_rng() % SPURIOUS_FAULT_BITS));
+    }
+    return true;
+}
+
+/**
+ * @brief Enable a fault
+ */
+void PB7200FaultTransport::setFault(PB7200FaultType type, const FaultSchedule &schedule) {
+    if (type < FAULT_TYPES) {
+        _schedules[type] = schedule;
+    }
+}
+
+/**
+ * @brief Disable every fault and release a stuck bus
+ */
+void PB7200FaultTransport::clearFaults() {
+    memset(_schedules, 0, sizeof(_schedules));
+    _stuckUntilUs = 0;
+}
+
+/**
+ * @brief Get how often a fault was injected
+ */
+uint32_t PB7200FaultTransport::injected(PB7200FaultType type) const {
+    return type < FAULT_TYPES ? _injected[type] : 0;
+}
+
+/**
+ * @brief Get the number of transfers seen
+ */
+uint32_t PB7200FaultTransport::transfers() const {
+    return _transfers;
+}
+
+// ========== Private Methods ==========
+
+/**
+ * @brief Decide whether a fault hits this transfer
+ */
+bool PB7200FaultTransport::trigger(PB7200FaultType type, uint64_t nowUs) {
+    const FaultSchedule &s = _schedules[type];
+    if (s.probability <= 0.0f || nowUs < s.startUs || (s.endUs != 0 && nowUs >= s.endUs)) {
+        return false;
+    }
+    if (s.periodUs != 0 && (nowUs - s.startUs) % s.periodUs >= s.activeUs) {
+        return false;
+    }
+    if (_uniform(_rng) >= s.probability) {
+        return false;
+    }
+    _injected[type]++;
+    return true;
+}
+
+/**
+ * @brief Faults that act before the transfer reaches the chip
+ * @return false if the transfer fails
+ */
+bool PB7200FaultTransport::beforeTransfer(uint64_t nowUs) {
+    _transfers++;
+
+    if (trigger(FAULT_DELAY, nowUs)) {
+        delayMicroseconds(_schedules[FAULT_DELAY].durationUs);
+        nowUs = micros();
+    }
+    if (nowUs < _stuckUntilUs) {
+        return false;
+    }
+    if (trigger(FAULT_STUCK_BUS, nowUs)) {
+        _stuckUntilUs = nowUs + _schedules[FAULT_STUCK_BUS].durationUs;
+        return false;
+    }
+    return !trigger(FAULT_NACK, nowUs);
+}
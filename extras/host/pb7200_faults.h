@@ -0,0 +1,135 @@
+/**
+ * @file pb7200_faults.h
+ * @brief Fault-injecting PB7200Transport decorator for host testing
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Wraps another transport (usually a PB7200SimChip) and corrupts its
+ * traffic the way a flaky I2C bus does:
+ *
+ *   FAULT_NACK            The transfer fails and never reaches the chip
+ *   FAULT_SHORT_READ      Only part of a read arrives (received != length)
+ *   FAULT_BIT_FLIP        A read succeeds with one data bit inverted
+ *   FAULT_STUCK_BUS       Every transfer fails for durationUs, or until
+ *                         begin() restarts the bus
+ *   FAULT_DELAY           The transfer takes durationUs longer
+ *   FAULT_SPURIOUS_FAULT  A read of the fault register gains a
+ *                         protection bit the chip did not set
+ *
+ * Each fault has its own probability per transfer and schedule: a
+ * window [startUs, endUs) and optionally a duty cycle, active for the
+ * first activeUs of every periodUs, for bursts. Time is micros(), so on
+ * the host core (extras/host/arduino) faults follow the simulated clock
+ * and delays advance it.
+ */
+
+#ifndef PB7200_FAULTS_H
+#define PB7200_FAULTS_H
+
+#include <stdint.h>
+
+#include <random>
+
+#include "PB7200Transport.h"
+
+/**
+ * @brief Kinds of injected fault
+ */
+enum PB7200FaultType {
+    FAULT_NACK = 0,
+    FAULT_SHORT_READ = 1,
+    FAULT_BIT_FLIP = 2,
+    FAULT_STUCK_BUS = 3,
+    FAULT_DELAY = 4,
+    FAULT_SPURIOUS_FAULT = 5,
+    FAULT_TYPES = 6
+};
+
+/**
+ * @brief When and how often a fault is injected
+ */
+struct FaultSchedule {
+    float probability;       // Chance per transfer while active (0-1)
+    uint64_t startUs;        // Active from (µs)
+    uint64_t endUs;          // Active until (µs, 0 = no end)
+    uint32_t periodUs;       // Duty cycle period (µs, 0 = always active)
+    uint32_t activeUs;       // Active part of each period (µs)
+    uint32_t durationUs;     // Stuck time or added delay (µs)
+};
+
+/**
+ * @brief Transport that injects faults into another transport
+ */
+class PB7200FaultTransport : public PB7200Transport {
+public:
+    /**
+     * @brief Constructor, no faults enabled
+     * @param inner Transport to wrap
+     * @param seed Random seed
+     */
+    PB7200FaultTransport(PB7200Transport &inner, uint32_t seed = 1);
+
+    /**
+     * @brief Restart the bus: clears a stuck bus, then starts the inner transport
+     * @return Result of the inner transport's begin()
+     */
+    bool begin() override;
+
+    /**
+     * @brief Write registers through the inner transport, with faults
+     * @param reg First register
+     * @param values Values to write
+     * @param length Number of registers
+     * @return false on an injected or real failure
+     */
+    bool write(uint8_t reg, const uint8_t *values, uint8_t length) override;
+
+    /**
+     * @brief Read registers through the inner transport, with faults
+     * @param reg First register
+     * @param values Buffer for the values
+     * @param length Number of registers
+     * @return false on an injected or real failure
+     */
+    bool read(uint8_t reg, uint8_t *values, uint8_t length) override;
+
+    /**
+     * @brief Enable a fault
+     * @param type Fault kind
+     * @param schedule Probability and timing
+     */
+    void setFault(PB7200FaultType type, const FaultSchedule &schedule);
+
+    /**
+     * @brief Disable every fault and release a stuck bus
+     */
+    void clearFaults();
+
+    /**
+     * @brief Get how often a fault was injected
+     * @param type Fault kind
+     * @return Injections so far
+     */
+    uint32_t injected(PB7200FaultType type) const;
+
+    /**
+     * @brief Get the number of transfers seen
+     * @return Reads plus writes
+     */
+    uint32_t transfers() const;
+
+private:
+    PB7200Transport &_inner;
+    FaultSchedule _schedules[FAULT_TYPES];
+    uint32_t _injected[FAULT_TYPES];
+    uint32_t _transfers;
+    uint64_t _stuckUntilUs;
+    std::mt19937 _rng;
+    std::uniform_real_distribution<float> _uniform;
+
+    bool trigger(PB7200FaultType type, uint64_t nowUs);
+    bool beforeTransfer(uint64_t nowUs);
+};
+
+#endif // PB7200_FAULTS_H
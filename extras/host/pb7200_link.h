@@ -0,0 +1,127 @@
+/**
+ * @file pb7200_link.h
+ * @brief Byte-stream framing of telemetry frames for host tools
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Serial lines and TCP streams carry telemetry frames (PB7200Telemetry.h)
+ * from many packs, so every frame is wrapped with a sync byte, the pack
+ * id, its length and a CRC16-CCITT:
+ *
+ *   0xA5, pack id (2, LE), length (1), frame, CRC over id..frame (2, LE)
+ *
+ * The decoder resynchronizes after noise or a dropped byte by skipping
+ * to the next sync byte whose CRC checks out.
+ */
+
+#ifndef PB7200_LINK_H
+#define PB7200_LINK_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "PB7200Storage.h"
+
+#define PB7200_LINK_SYNC 0xA5
+#define PB7200_LINK_HEADER 4
+#define PB7200_LINK_OVERHEAD 6
+#define PB7200_LINK_MAX (PB7200_LINK_OVERHEAD + 255)
+
+/**
+ * @brief Wrap a telemetry frame
+ * @param packId Pack identifier
+ * @param frame Telemetry frame
+ * @param length Frame length
+ * @param out Buffer of length + PB7200_LINK_OVERHEAD bytes
+ * @return Encoded length
+ */
+inline uint16_t linkEncode(uint16_t packId, const uint8_t *frame, uint8_t length, uint8_t *out) {
+    out[0] = PB7200_LINK_SYNC;
+    out[1] = packId & 0xFF;
+    out[2] = packId >> 8;
+    out[3] = length;
+    memcpy(out + PB7200_LINK_HEADER, frame, length);
+    uint16_t crc = pb7200Crc16(out + 1, 3 + length);
+    out[PB7200_LINK_HEADER + length] = crc & 0xFF;
+    out[PB7200_LINK_HEADER + length + 1] = crc >> 8;
+    return PB7200_LINK_OVERHEAD + length;
+}
+
+/**
+ * @brief Incremental deframer for one byte stream
+ */
+class LinkDecoder {
+public:
+    LinkDecoder() : _used(0), _crcErrors(0) {}
+
+    /**
+     * @brief Consume received bytes
+     * @param data Bytes
+     * @param length Number of bytes
+     * @param onFrame Called as onFrame(packId, frame, frameLength)
+     */
+    template <typename Handler>
+    void feed(const uint8_t *data, size_t length, Handler onFrame) {
+        while (length > 0) {
+            size_t n = sizeof(_buffer) - _used;
+            if (n > length) {
+                n = length;
+            }
+            memcpy(_buffer + _used, data, n);
+            _used += n;
+            data += n;
+            length -= n;
+            parse(onFrame);
+        }
+    }
+
+    /**
+     * @brief Get number of frames dropped for a bad CRC
+     * @return Error count
+     */
+    uint32_t crcErrors() const {
+        return _crcErrors;
+    }
+
+private:
+    uint8_t _buffer[2 * PB7200_LINK_MAX];
+    size_t _used;
+    uint32_t _crcErrors;
+
+    template <typename Handler>
+    void parse(Handler &onFrame) {
+        size_t pos = 0;
+        while (true) {
+            // Skip to the next sync byte
+            while (pos < _used && _buffer[pos] != PB7200_LINK_SYNC) {
+                pos++;
+            }
+            if (_used - pos < PB7200_LINK_HEADER) {
+                break;
+            }
+            uint8_t length = _buffer[pos + 3];
+            size_t total = PB7200_LINK_OVERHEAD + length;
+            if (_used - pos < total) {
+                break;
+            }
+
+            const uint8_t *p = _buffer + pos;
+            uint16_t crc = p[PB7200_LINK_HEADER + length] |
+                           ((uint16_t)p[PB7200_LINK_HEADER + length + 1] << 8);
+            if (pb7200Crc16(p + 1, 3 + length) == crc) {
+                onFrame((uint16_t)(p[1] | (p[2] << 8)), p + PB7200_LINK_HEADER, length);
+                pos += total;
+            } else {
+                // False sync or corrupted frame: retry from the next byte
+                _crcErrors++;
+                pos++;
+            }
+        }
+
+        memmove(_buffer, _buffer + pos, _used - pos);
+        _used -= pos;
+    }
+};
+
+#endif // PB7200_LINK_H
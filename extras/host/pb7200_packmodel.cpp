@@ -0,0 +1,298 @@
+/**
+ * @file pb7200_packmodel.cpp
+ * @brief Equivalent-circuit battery model for host simulation
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ */
+
+#include "pb7200_packmodel.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <random>
+
+// Open-circuit voltage at 0, 5, ..., 100 % state of charge
+#define OCV_POINTS 21
+
+static const float OCV_TABLE[][OCV_POINTS] = {
+    // NMC
+    {3.000f, 3.300f, 3.450f, 3.520f, 3.570f, 3.610f, 3.640f, 3.660f, 3.690f, 3.720f, 3.750f,
+     3.790f, 3.830f, 3.870f, 3.920f, 3.970f, 4.010f, 4.060f, 4.100f, 4.150f, 4.200f},
+    // LFP
+    {2.500f, 3.000f, 3.150f, 3.220f, 3.255f, 3.270f, 3.280f, 3.290f, 3.295f, 3.300f, 3.302f,
+     3.305f, 3.310f, 3.320f, 3.330f, 3.335f, 3.340f, 3.345f, 3.360f, 3.400f, 3.600f},
+};
+
+// Default bleed resistor (ohm)
+#define DEFAULT_BLEED_OHMS 33.0f
+
+// Resistance rise per degree below 25 °C (Arrhenius fit, relative)
+#define RESISTANCE_TEMP_COEFF 0.025f
+
+/**
+ * @brief Constructor, empty pack
+ */
+PackModel::PackModel() {
+    memset(_params, 0, sizeof(_params));
+    memset(_cells, 0, sizeof(_cells));
+    memset(_sensorOffset, 0, sizeof(_sensorOffset));
+    _thermal.heatCapacity = 1.0f;
+    _thermal.resistance = 1.0f;
+    _thermal.ambient = 25.0f;
+    _chemistry = CHEMISTRY_NMC;
+    _cellCount = 0;
+    _sensorCount = 0;
+    _current = 0.0f;
+    _temperature = 25.0f;
+    _heat = 0.0f;
+    _bleedOhms = DEFAULT_BLEED_OHMS;
+    _bledAh = 0.0f;
+}
+
+/**
+ * @brief Set up identical cells at rest, at ambient temperature
+ */
+void PackModel::init(uint8_t cellCount, uint8_t sensorCount, const CellParams &params,
+                     float soc, const ThermalParams &thermal) {
+    _cellCount = cellCount > PB7200_MAX_CELLS ? PB7200_MAX_CELLS : cellCount;
+    _sensorCount = sensorCount > PB7200_MAX_TEMPS ? PB7200_MAX_TEMPS : sensorCount;
+    _thermal = thermal;
+    _temperature = thermal.ambient;
+    for (uint8_t i = 0; i < _cellCount; i++) {
+        _params[i] = params;
+        setSoc(i, soc);
+    }
+    _current = 0.0f;
+    _heat = 0.0f;
+    _bledAh = 0.0f;
+}
+
+/**
+ * @brief Vary capacity, resistance, leakage and charge cell by cell
+ */
+void PackModel::randomize(const CellSpread &spread, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+
+    for (uint8_t i = 0; i < _cellCount; i++) {
+        CellParams &p = _params[i];
+        float capacity = 1.0f + spread.capacity * normal(rng);
+        float resistance = 1.0f + spread.resistance * normal(rng);
+        capacity = capacity < 0.1f ? 0.1f : capacity;
+        resistance = resistance < 0.1f ? 0.1f : resistance;
+
+        p.capacityAh *= capacity;
+        p.r0 *= resistance;
+        for (uint8_t k = 0; k < PB7200_SIM_RC_PAIRS; k++) {
+            p.r[k] *= resistance;
+        }
+        p.leakage += spread.leakage * normal(rng);
+        p.leakage = p.leakage < 0.0f ? 0.0f : p.leakage;
+        setSoc(i, _cells[i].soc + spread.soc * normal(rng));
+    }
+}
+
+/**
+ * @brief Select the open-circuit voltage curve
+ */
+void PackModel::setChemistry(CellChemistry chemistry) {
+    _chemistry = chemistry;
+    for (uint8_t i = 0; i < _cellCount; i++) {
+        _cells[i].volts = restVoltage(i);
+    }
+}
+
+/**
+ * @brief Change one cell's parameters
+ */
+void PackModel::setCell(uint8_t cell, const CellParams &params) {
+    if (cell < _cellCount) {
+        _params[cell] = params;
+    }
+}
+
+/**
+ * @brief Set one cell's state of charge, at rest
+ */
+void PackModel::setSoc(uint8_t cell, float soc) {
+    if (cell < _cellCount) {
+        CellState &c = _cells[cell];
+        c.soc = soc < 0.0f ? 0.0f : (soc > 1.0f ? 1.0f : soc);
+        memset(c.vRc, 0, sizeof(c.vRc));
+        c.current = 0.0f;
+        c.volts = ocv(c.soc);
+    }
+}
+
+/**
+ * @brief Set a sensor's offset from the pack temperature
+ */
+void PackModel::setSensorOffset(uint8_t sensor, float offset) {
+    if (sensor < PB7200_MAX_TEMPS) {
+        _sensorOffset[sensor] = offset;
+    }
+}
+
+/**
+ * @brief Set the bleed resistor of each balance switch
+ */
+void PackModel::setBleedResistance(float ohms) {
+    _bleedOhms = ohms > 0.0f ? ohms : DEFAULT_BLEED_OHMS;
+}
+
+/**
+ * @brief Advance the model
+ */
+void PackModel::step(float dt, float current, uint32_t bleedTaps) {
+    const float scale = resistanceScale();
+    float heat = 0.0f;
+    _current = current;
+
+    for (uint8_t i = 0; i < _cellCount; i++) {
+        const CellParams &p = _params[i];
+        CellState &c = _cells[i];
+
+        // The bleed resistor discharges the cell on top of the pack current
+        float bleed = (bleedTaps & (1UL << i)) ? c.volts / _bleedOhms : 0.0f;
+        float cellCurrent = current - bleed;
+        _bledAh += bleed * dt / 3600.0f;
+        heat += bleed * bleed * _bleedOhms;
+
+        c.soc += (cellCurrent - p.leakage) * dt / (3600.0f * p.capacityAh);
+        c.soc = c.soc < 0.0f ? 0.0f : (c.soc > 1.0f ? 1.0f : c.soc);
+
+        // Exact step of each RC pair for a current held over dt
+        float r0 = p.r0 * scale;
+        float volts = ocv(c.soc) + cellCurrent * r0;
+        heat += cellCurrent * cellCurrent * r0;
+        for (uint8_t k = 0; k < PB7200_SIM_RC_PAIRS; k++) {
+            float r = p.r[k] * scale;
+            float decay = p.tau[k] > 0.0f ? expf(-dt / p.tau[k]) : 0.0f;
+            c.vRc[k] = c.vRc[k] * decay + cellCurrent * r * (1.0f - decay);
+            volts += c.vRc[k];
+            if (r > 0.0f) {
+                heat += c.vRc[k] * c.vRc[k] / r;
+            }
+        }
+        c.current = cellCurrent;
+        c.volts = volts;
+    }
+
+    // Lumped thermal mass settling towards ambient + heat × resistance
+    float settled = _thermal.ambient + heat * _thermal.resistance;
+    float tau = _thermal.heatCapacity * _thermal.resistance;
+    _temperature = settled + (_temperature - settled) * (tau > 0.0f ? expf(-dt / tau) : 0.0f);
+    _heat = heat;
+}
+
+/**
+ * @brief Copy voltages, temperatures and current to a simulated chip
+ */
+void PackModel::apply(PB7200SimChip &chip) const {
+    float volts[PB7200_MAX_CELLS];
+    float temps[PB7200_MAX_TEMPS];
+    for (uint8_t i = 0; i < _cellCount; i++) {
+        volts[i] = _cells[i].volts;
+    }
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        temps[i] = _temperature + _sensorOffset[i];
+    }
+    chip.setCellVoltages(volts, _cellCount);
+    chip.setTemperatures(temps, _sensorCount);
+    chip.setCurrent(_current);
+}
+
+/**
+ * @brief Get the number of cells
+ */
+uint8_t PackModel::cellCount() const {
+    return _cellCount;
+}
+
+/**
+ * @brief Get the parameters of a cell
+ */
+const CellParams &PackModel::params(uint8_t cell) const {
+    return _params[cell];
+}
+
+/**
+ * @brief Get the state of a cell
+ */
+const CellState &PackModel::cell(uint8_t cell) const {
+    return _cells[cell];
+}
+
+/**
+ * @brief Get a cell's voltage without its R0 drop
+ */
+float PackModel::restVoltage(uint8_t cell) const {
+    const CellState &c = _cells[cell];
+    float volts = ocv(c.soc);
+    for (uint8_t k = 0; k < PB7200_SIM_RC_PAIRS; k++) {
+        volts += c.vRc[k];
+    }
+    return volts;
+}
+
+/**
+ * @brief Get a cell's series resistance at the present temperature
+ */
+float PackModel::seriesResistance(uint8_t cell) const {
+    return _params[cell].r0 * resistanceScale();
+}
+
+/**
+ * @brief Get the pack current of the last step
+ */
+float PackModel::current() const {
+    return _current;
+}
+
+/**
+ * @brief Get the pack temperature
+ */
+float PackModel::temperature() const {
+    return _temperature;
+}
+
+/**
+ * @brief Get the heat generated in the last step
+ */
+float PackModel::heat() const {
+    return _heat;
+}
+
+/**
+ * @brief Get the charge bled by balancing so far
+ */
+float PackModel::bledAh() const {
+    return _bledAh;
+}
+
+/**
+ * @brief Open-circuit voltage of the selected chemistry
+ */
+float PackModel::ocv(float soc) const {
+    const float *table = OCV_TABLE[_chemistry];
+    float x = soc * (OCV_POINTS - 1);
+    if (x <= 0.0f) {
+        return table[0];
+    }
+    if (x >= OCV_POINTS - 1) {
+        return table[OCV_POINTS - 1];
+    }
+    uint8_t i = (uint8_t)x;
+    return table[i] + (table[i + 1] - table[i]) * (x - i);
+}
+
+// ========== Private Methods ==========
+
+/**
+ * @brief Resistance factor at the present temperature (1 at 25 °C)
+ */
+float PackModel::resistanceScale() const {
+    return expf(RESISTANCE_TEMP_COEFF * (25.0f - _temperature));
+}
@@ -0,0 +1,243 @@
+/**
+ * @file pb7200_packmodel.h
+ * @brief Equivalent-circuit battery model for host simulation
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Each cell is an open-circuit voltage source (NMC or LFP curve over
+ * state of charge), a series resistance R0 and RC pairs, with a leakage
+ * current for self-discharge. Resistances rise in the cold. Cells are
+ * in series, so they share the pack current, except that a cell whose
+ * balance switch is on also feeds its bleed resistor. Heat from the
+ * resistances and bleed resistors warms one lumped thermal mass that
+ * loses heat to ambient; sensors read it plus a fixed offset each.
+ *
+ * Steps are exact for currents held over the step (RC pairs and the
+ * thermal mass decay exponentially), so seconds-long steps stay
+ * accurate and a full charge cycle runs in milliseconds. The model
+ * drives a PB7200SimChip's analog inputs.
+ */
+
+#ifndef PB7200_PACKMODEL_H
+#define PB7200_PACKMODEL_H
+
+#include <stdint.h>
+
+#include "PB7200Types.h"
+#include "pb7200_simchip.h"
+
+// RC pairs per cell
+#define PB7200_SIM_RC_PAIRS 2
+
+/**
+ * @brief Open-circuit voltage curve
+ */
+enum CellChemistry {
+    CHEMISTRY_NMC = 0,       // 3.0-4.2 V, sloped
+    CHEMISTRY_LFP = 1        // 2.5-3.6 V, flat between 20 and 90 %
+};
+
+/**
+ * @brief Electrical parameters of one cell
+ */
+struct CellParams {
+    float capacityAh;                  // Capacity (Ah)
+    float r0;                          // Series resistance at 25 °C (ohm)
+    float r[PB7200_SIM_RC_PAIRS];      // RC pair resistances at 25 °C (ohm)
+    float tau[PB7200_SIM_RC_PAIRS];    // RC pair time constants (s)
+    float leakage;                     // Self-discharge current (A)
+};
+
+/**
+ * @brief Random cell-to-cell variation (standard deviations)
+ */
+struct CellSpread {
+    float capacity;          // Relative capacity (e.g. 0.02 = 2 %)
+    float resistance;        // Relative resistance
+    float leakage;           // Leakage current (A)
+    float soc;               // State of charge (0-1)
+};
+
+/**
+ * @brief Lumped thermal parameters of the pack
+ */
+struct ThermalParams {
+    float heatCapacity;      // Heat capacity (J/K)
+    float resistance;        // Thermal resistance to ambient (K/W)
+    float ambient;           // Ambient temperature (°C)
+};
+
+/**
+ * @brief State of one cell
+ */
+struct CellState {
+    float soc;                         // State of charge (0-1)
+    float vRc[PB7200_SIM_RC_PAIRS];    // Voltage across each RC pair (V)
+    float current;                     // Current into the cell (A)
+    float volts;                       // Terminal voltage (V)
+};
+
+/**
+ * @brief Series pack of equivalent-circuit cells
+ */
+class PackModel {
+public:
+    /**
+     * @brief Constructor, empty pack
+     */
+    PackModel();
+
+    /**
+     * @brief Set up identical cells at rest, at ambient temperature
+     * @param cellCount Number of cells (1-20)
+     * @param sensorCount Number of temperature sensors (0-8)
+     * @param params Cell parameters
+     * @param soc Initial state of charge (0-1)
+     * @param thermal Thermal parameters
+     */
+    void init(uint8_t cellCount, uint8_t sensorCount, const CellParams &params, float soc,
+              const ThermalParams &thermal);
+
+    /**
+     * @brief Vary capacity, resistance, leakage and charge cell by cell
+     *
+     * Draws from normal distributions around the parameters given to
+     * init(); capacity and resistance stay above 10 % of nominal and
+     * leakage at or above zero.
+     *
+     * @param spread Standard deviations
+     * @param seed Random seed
+     */
+    void randomize(const CellSpread &spread, uint32_t seed);
+
+    /**
+     * @brief Select the open-circuit voltage curve
+     * @param chemistry Curve
+     */
+    void setChemistry(CellChemistry chemistry);
+
+    /**
+     * @brief Change one cell's parameters
+     * @param cell Cell index
+     * @param params Parameters
+     */
+    void setCell(uint8_t cell, const CellParams &params);
+
+    /**
+     * @brief Set one cell's state of charge, at rest
+     * @param cell Cell index
+     * @param soc State of charge (0-1)
+     */
+    void setSoc(uint8_t cell, float soc);
+
+    /**
+     * @brief Set a sensor's offset from the pack temperature
+     * @param sensor Sensor index
+     * @param offset Offset (°C)
+     */
+    void setSensorOffset(uint8_t sensor, float offset);
+
+    /**
+     * @brief Set the bleed resistor of each balance switch
+     * @param ohms Resistance (ohm)
+     */
+    void setBleedResistance(float ohms);
+
+    /**
+     * @brief Advance the model
+     * @param dt Time step (s)
+     * @param current Pack current (A, positive = charging)
+     * @param bleedTaps Cells whose balance switch is on (bit = tap)
+     */
+    void step(float dt, float current, uint32_t bleedTaps);
+
+    /**
+     * @brief Copy voltages, temperatures and current to a simulated chip
+     * @param chip Chip whose inputs to set
+     */
+    void apply(PB7200SimChip &chip) const;
+
+    /**
+     * @brief Get the number of cells
+     * @return Cell count
+     */
+    uint8_t cellCount() const;
+
+    /**
+     * @brief Get the parameters of a cell
+     * @param cell Cell index
+     * @return Parameters
+     */
+    const CellParams &params(uint8_t cell) const;
+
+    /**
+     * @brief Get the state of a cell
+     * @param cell Cell index
+     * @return State
+     */
+    const CellState &cell(uint8_t cell) const;
+
+    /**
+     * @brief Get a cell's voltage without its R0 drop
+     * @param cell Cell index
+     * @return Open-circuit plus RC pair voltages (V)
+     */
+    float restVoltage(uint8_t cell) const;
+
+    /**
+     * @brief Get a cell's series resistance at the present temperature
+     * @param cell Cell index
+     * @return R0 (ohm)
+     */
+    float seriesResistance(uint8_t cell) const;
+
+    /**
+     * @brief Get the pack current of the last step
+     * @return Current (A)
+     */
+    float current() const;
+
+    /**
+     * @brief Get the pack temperature
+     * @return Temperature (°C)
+     */
+    float temperature() const;
+
+    /**
+     * @brief Get the heat generated in the last step
+     * @return Power (W)
+     */
+    float heat() const;
+
+    /**
+     * @brief Get the charge bled by balancing so far
+     * @return Charge, all cells (Ah)
+     */
+    float bledAh() const;
+
+    /**
+     * @brief Open-circuit voltage of the selected chemistry
+     * @param soc State of charge (0-1)
+     * @return Voltage (V)
+     */
+    float ocv(float soc) const;
+
+private:
+    CellParams _params[PB7200_MAX_CELLS];
+    CellState _cells[PB7200_MAX_CELLS];
+    float _sensorOffset[PB7200_MAX_TEMPS];
+    ThermalParams _thermal;
+    CellChemistry _chemistry;
+    uint8_t _cellCount;
+    uint8_t _sensorCount;
+    float _current;
+    float _temperature;
+    float _heat;
+    float _bleedOhms;
+    float _bledAh;
+
+    float resistanceScale() const;
+};
+
+#endif // PB7200_PACKMODEL_H
@@ -0,0 +1,241 @@
+/**
+ * @file pb7200_profile.cpp
+ * @brief Scripted pack current for host simulation
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ */
+
+#include "pb7200_profile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Longest step text
+#define PROFILE_STEP_CHARS 96
+
+// Charge end current when none is given, as a fraction of the charge current
+#define DEFAULT_CUTOFF_FRACTION 0.05f
+
+/**
+ * @brief Constructor, empty profile (finished)
+ */
+CurrentProfile::CurrentProfile() {
+    memset(_steps, 0, sizeof(_steps));
+    memset(_repeatsLeft, 0, sizeof(_repeatsLeft));
+    _stepCount = 0;
+    _index = 0;
+    _elapsed = 0.0;
+    _cvAmps = 0.0f;
+    _cv = false;
+}
+
+/**
+ * @brief Parse a profile script and restart
+ */
+bool CurrentProfile::parse(const char *script) {
+    _stepCount = 0;
+    const char *p = script;
+
+    while (*p != '\0') {
+        size_t length = strcspn(p, ";\n");
+        char text[PROFILE_STEP_CHARS];
+        if (length >= sizeof(text)) {
+            return false;
+        }
+        memcpy(text, p, length);
+        text[length] = '\0';
+        p += length;
+        if (*p != '\0') {
+            p++;
+        }
+
+        char word[16];
+        float a = 0.0f, b = 0.0f, c = 0.0f, d = 0.0f;
+        int fields = sscanf(text, " %15s %f %f %f %f", word, &a, &b, &c, &d);
+        if (fields <= 0) {
+            continue;    // Blank step
+        }
+        if (_stepCount >= PB7200_PROFILE_MAX_STEPS) {
+            return false;
+        }
+
+        ProfileStep &s = _steps[_stepCount];
+        memset(&s, 0, sizeof(s));
+        if (strcmp(word, "rest") == 0 && fields == 2 && a >= 0.0f) {
+            s.type = PROFILE_REST;
+            s.seconds = a;
+        } else if (strcmp(word, "current") == 0 && fields == 3 && b >= 0.0f) {
+            s.type = PROFILE_CURRENT;
+            s.amps = a;
+            s.seconds = b;
+        } else if (strcmp(word, "charge") == 0 && fields >= 3 && a > 0.0f) {
+            s.type = PROFILE_CHARGE;
+            s.amps = a;
+            s.volts = b;
+            s.cutoff = fields >= 4 ? c : a * DEFAULT_CUTOFF_FRACTION;
+            s.seconds = fields == 5 ? d : PB7200_PROFILE_STEP_LIMIT_S;
+        } else if (strcmp(word, "discharge") == 0 && fields >= 3 && fields <= 4 && a > 0.0f) {
+            s.type = PROFILE_DISCHARGE;
+            s.amps = a;
+            s.volts = b;
+            s.seconds = fields == 4 ? c : PB7200_PROFILE_STEP_LIMIT_S;
+        } else if (strcmp(word, "repeat") == 0 && fields == 2 && a >= 0.0f) {
+            s.type = PROFILE_REPEAT;
+            s.seconds = (float)(uint16_t)a;
+        } else {
+            return false;
+        }
+        _stepCount++;
+    }
+
+    restart();
+    return true;
+}
+
+/**
+ * @brief Go back to the first step
+ */
+void CurrentProfile::restart() {
+    for (uint8_t i = 0; i < _stepCount; i++) {
+        _repeatsLeft[i] = repeatCount(_steps[i]);
+    }
+    _index = 0;
+    enterStep();
+}
+
+/**
+ * @brief Get the current for the next model step and advance
+ */
+float CurrentProfile::next(const PackModel &model, float dt) {
+    while (_index < _stepCount) {
+        const ProfileStep &s = _steps[_index];
+        uint8_t cells = model.cellCount();
+
+        switch (s.type) {
+            case PROFILE_REST:
+            case PROFILE_CURRENT:
+                if (_elapsed < s.seconds) {
+                    _elapsed += dt;
+                    return s.type == PROFILE_REST ? 0.0f : s.amps;
+                }
+                break;
+
+            case PROFILE_CHARGE: {
+                // Largest current that keeps every cell at or below the limit
+                float amps = s.amps;
+                for (uint8_t i = 0; i < cells; i++) {
+                    float limit = (s.volts - model.restVoltage(i)) / model.seriesResistance(i);
+                    if (limit < amps) {
+                        amps = limit;
+                    }
+                }
+                if (amps < s.amps) {
+                    _cv = true;
+                }
+                amps = amps < 0.0f ? 0.0f : amps;
+                // Once regulating, the current only falls
+                if (_cv) {
+                    amps = amps < _cvAmps ? amps : _cvAmps;
+                    _cvAmps = amps;
+                }
+                if ((!_cv || amps > s.cutoff) && _elapsed < s.seconds) {
+                    _elapsed += dt;
+                    return amps;
+                }
+                break;
+            }
+
+            case PROFILE_DISCHARGE: {
+                bool empty = false;
+                for (uint8_t i = 0; i < cells; i++) {
+                    if (model.cell(i).volts <= s.volts) {
+                        empty = true;
+                    }
+                }
+                if (!empty && _elapsed < s.seconds) {
+                    _elapsed += dt;
+                    return -s.amps;
+                }
+                break;
+            }
+
+            case PROFILE_REPEAT:
+                if (_repeatsLeft[_index] > 0) {
+                    _repeatsLeft[_index]--;
+                    // Inner repeats run in full again on each pass
+                    for (uint8_t i = 0; i < _index; i++) {
+                        _repeatsLeft[i] = repeatCount(_steps[i]);
+                    }
+                    _index = 0;
+                    enterStep();
+                    continue;
+                }
+                break;
+        }
+        nextStep();
+    }
+    return 0.0f;
+}
+
+/**
+ * @brief Check whether every step has ended
+ */
+bool CurrentProfile::finished() const {
+    return _index >= _stepCount;
+}
+
+/**
+ * @brief Get the step being run
+ */
+uint8_t CurrentProfile::stepIndex() const {
+    return _index;
+}
+
+/**
+ * @brief Check whether a charge step is in its constant-voltage phase
+ */
+bool CurrentProfile::constantVoltage() const {
+    return _cv;
+}
+
+/**
+ * @brief Get the number of steps
+ */
+uint8_t CurrentProfile::stepCount() const {
+    return _stepCount;
+}
+
+/**
+ * @brief Get a step
+ */
+const ProfileStep &CurrentProfile::step(uint8_t index) const {
+    return _steps[index];
+}
+
+// ========== Private Methods ==========
+
+/**
+ * @brief Number of passes a repeat step adds (0 for other steps)
+ */
+uint16_t CurrentProfile::repeatCount(const ProfileStep &step) {
+    return step.type == PROFILE_REPEAT ? (uint16_t)step.seconds : 0;
+}
+
+/**
+ * @brief Reset per-step state on entering a step
+ */
+void CurrentProfile::enterStep() {
+    _elapsed = 0.0;
+    _cv = false;
+    _cvAmps = _index < _stepCount ? _steps[_index].amps : 0.0f;
+}
+
+/**
+ * @brief Move to the following step
+ */
+void CurrentProfile::nextStep() {
+    _index++;
+    enterStep();
+}
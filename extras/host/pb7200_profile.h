@@ -0,0 +1,142 @@
+/**
+ * @file pb7200_profile.h
+ * @brief Scripted pack current for host simulation
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * A profile is a list of steps separated by ';' or newlines, run in
+ * order. Currents are in amps and positive while charging:
+ *
+ *   rest SECONDS                  No current
+ *   current AMPS SECONDS          Fixed current (negative = discharge)
+ *   charge AMPS VOLTS [CUTOFF [LIMIT]]
+ *                                 Constant current until the highest cell
+ *                                 reaches VOLTS, then constant voltage on
+ *                                 that cell until the current falls to
+ *                                 CUTOFF (default AMPS / 20)
+ *   discharge AMPS VOLTS [LIMIT]  Discharge at AMPS until the lowest cell
+ *                                 falls to VOLTS
+ *   repeat COUNT                  Run the steps so far COUNT more times
+ *
+ * Charge and discharge steps also end after LIMIT seconds (default one
+ * day), like a charger's safety timer, in case VOLTS is out of reach.
+ *
+ * Example: "charge 20 4.15 1; rest 1800; discharge 30 3.3; rest 600"
+ *
+ * The constant-voltage phase sets the current from the model's rest
+ * voltages and series resistances, as a charger regulating on the
+ * highest cell would.
+ */
+
+#ifndef PB7200_PROFILE_H
+#define PB7200_PROFILE_H
+
+#include <stdint.h>
+
+#include "pb7200_packmodel.h"
+
+// Maximum steps in a profile
+#define PB7200_PROFILE_MAX_STEPS 32
+
+// Default time limit of charge and discharge steps (s)
+#define PB7200_PROFILE_STEP_LIMIT_S 86400.0f
+
+/**
+ * @brief Kind of profile step
+ */
+enum ProfileStepType {
+    PROFILE_REST = 0,
+    PROFILE_CURRENT = 1,
+    PROFILE_CHARGE = 2,
+    PROFILE_DISCHARGE = 3,
+    PROFILE_REPEAT = 4
+};
+
+/**
+ * @brief One profile step
+ */
+struct ProfileStep {
+    ProfileStepType type;
+    float amps;              // Current magnitude (A); signed for PROFILE_CURRENT
+    float volts;             // Voltage limit (V)
+    float cutoff;            // Charge end current (A)
+    float seconds;           // Duration or time limit (s), or repeat count
+};
+
+/**
+ * @brief Current profile run against a PackModel
+ */
+class CurrentProfile {
+public:
+    /**
+     * @brief Constructor, empty profile (finished)
+     */
+    CurrentProfile();
+
+    /**
+     * @brief Parse a profile script and restart
+     * @param script Steps, see the file comment
+     * @return true if every step was understood
+     */
+    bool parse(const char *script);
+
+    /**
+     * @brief Go back to the first step
+     */
+    void restart();
+
+    /**
+     * @brief Get the current for the next model step and advance
+     * @param model Pack the current will flow through
+     * @param dt Length of the step (s)
+     * @return Pack current (A, positive = charging)
+     */
+    float next(const PackModel &model, float dt);
+
+    /**
+     * @brief Check whether every step has ended
+     * @return true when done
+     */
+    bool finished() const;
+
+    /**
+     * @brief Get the step being run
+     * @return Step index
+     */
+    uint8_t stepIndex() const;
+
+    /**
+     * @brief Check whether a charge step is in its constant-voltage phase
+     * @return true while regulating voltage
+     */
+    bool constantVoltage() const;
+
+    /**
+     * @brief Get the number of steps
+     * @return Step count
+     */
+    uint8_t stepCount() const;
+
+    /**
+     * @brief Get a step
+     * @param index Step index
+     * @return Step
+     */
+    const ProfileStep &step(uint8_t index) const;
+
+private:
+    ProfileStep _steps[PB7200_PROFILE_MAX_STEPS];
+    uint16_t _repeatsLeft[PB7200_PROFILE_MAX_STEPS];
+    uint8_t _stepCount;
+    uint8_t _index;
+    double _elapsed;
+    float _cvAmps;
+    bool _cv;
+
+    static uint16_t repeatCount(const ProfileStep &step);
+    void enterStep();
+    void nextStep();
+};
+
+#endif // PB7200_PROFILE_H
@@ -0,0 +1,147 @@
+/**
+ * @file pb7200_simbench.cpp
+ * @brief One simulated pack: clock, chip, battery model and driver
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ */
+
+#include "pb7200_simbench.h"
+
+/**
+ * @brief Bus transfers take time on the bound clock
+ */
+static void onTransfer(uint32_t us, void *) {
+    arduinoAdvance(us);
+}
+
+/**
+ * @brief The chip follows its bench's clock
+ */
+static void onClock(void *context, uint64_t us) {
+    ((PB7200SimBench *)context)->chip.advance(us);
+}
+
+/**
+ * @brief Constructor, clock at zero and no pack model
+ */
+PB7200SimBench::PB7200SimBench(uint32_t seed) : faults(chip, seed), driver(faults) {
+    clock.us = 0;
+    clock.advance = onClock;
+    clock.context = this;
+    chip.setTransferCallback(onTransfer, nullptr);
+    _nowUs = 0;
+    _nextUpdateUs = 0;
+    _capacityAh = 0.0f;
+}
+
+/**
+ * @brief Set up the battery model with the usual cell parameters
+ */
+void PB7200SimBench::initPack(uint8_t cells, float capacityAh, float soc, float ambient) {
+    CellParams params = {capacityAh, 0.0012f, {0.0005f, 0.0004f}, {20.0f, 600.0f}, 0.0f};
+    ThermalParams thermal = {PB7200_SIM_HEAT_CAPACITY * cells, PB7200_SIM_THERMAL_RESISTANCE,
+                             ambient};
+    model.init(cells, PB7200_SIM_SENSORS, params, soc, thermal);
+    model.setBleedResistance(PB7200_SIM_BLEED_OHMS);
+    _capacityAh = capacityAh;
+}
+
+/**
+ * @brief Use this bench's clock on the calling thread
+ */
+void PB7200SimBench::bind() {
+    arduinoBindClock(&clock);
+}
+
+/**
+ * @brief Return the calling thread to the monotonic clock
+ */
+void PB7200SimBench::unbind() {
+    arduinoBindClock(nullptr);
+}
+
+/**
+ * @brief Power up: chip inputs from the model, then the driver's begin()
+ */
+bool PB7200SimBench::start(uint8_t cells, uint8_t attempts) {
+    if (_capacityAh > 0.0f) {
+        model.apply(chip);
+    }
+    sync(_nowUs);
+
+    driver.setTempSensorMask((1 << PB7200_SIM_SENSORS) - 1);
+    bool started = false;
+    for (uint8_t attempt = 0; attempt < attempts && !started; attempt++) {
+        started = driver.begin(cells);
+    }
+    if (!started) {
+        return false;
+    }
+
+    if (_capacityAh > 0.0f) {
+        driver.setParallelConfig(1, _capacityAh);
+        driver.setBalanceResistance(PB7200_SIM_BLEED_OHMS);
+        driver.setStateOfCharge(100.0f * meanSoc());
+    }
+    return true;
+}
+
+/**
+ * @brief Run the model for one step and bring chip and clock to its end
+ */
+void PB7200SimBench::step(uint32_t stepUs, float current) {
+    model.step(stepUs / 1e6f, current, chip.balanceTaps());
+    model.apply(chip);
+    sync(_nowUs + stepUs);
+}
+
+/**
+ * @brief Move simulation time forward without stepping the model
+ */
+void PB7200SimBench::sync(uint64_t nowUs) {
+    if (nowUs > _nowUs) {
+        _nowUs = nowUs;
+    }
+    // The driver's own waits may have run the clock ahead
+    if (clock.us < _nowUs) {
+        clock.us = _nowUs;
+    }
+    chip.advance(clock.us);
+}
+
+/**
+ * @brief Check whether a driver update is due, and schedule the next
+ */
+bool PB7200SimBench::updateDue(uint64_t periodUs) {
+    if (_nowUs < _nextUpdateUs) {
+        return false;
+    }
+    _nextUpdateUs += periodUs;
+    return true;
+}
+
+/**
+ * @brief Set when the first update is due
+ */
+void PB7200SimBench::setNextUpdate(uint64_t us) {
+    _nextUpdateUs = us;
+}
+
+/**
+ * @brief Get the simulation time
+ */
+uint64_t PB7200SimBench::now() const {
+    return _nowUs;
+}
+
+/**
+ * @brief Get the cells' true mean state of charge
+ */
+float PB7200SimBench::meanSoc() const {
+    float soc = 0.0f;
+    for (uint8_t i = 0; i < model.cellCount(); i++) {
+        soc += model.cell(i).soc;
+    }
+    return model.cellCount() > 0 ? soc / model.cellCount() : 0.0f;
+}
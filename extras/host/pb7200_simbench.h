@@ -0,0 +1,153 @@
+/**
+ * @file pb7200_simbench.h
+ * @brief One simulated pack: clock, chip, battery model and driver
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Wires the pieces every host simulator needs: the unmodified PB7200P80
+ * driver talks through a PB7200FaultTransport (idle until faults are
+ * set) to a PB7200SimChip, whose inputs come from a PackModel. The
+ * bench has its own simulated clock (extras/host/arduino); bus transfers
+ * advance it and the chip follows it, so each bench can run on any
+ * thread once bound.
+ *
+ * A simulator steps the bench through time and updates the driver when
+ * an update is due:
+ *
+ *   bench.initPack(16, 50.0f, 0.6f, 25.0f);
+ *   bench.bind();
+ *   bench.start(16);
+ *   while (...) {
+ *       bench.step(stepUs, current);
+ *       if (bench.updateDue(updateUs)) {
+ *           bench.driver.update();
+ *       }
+ *   }
+ *   bench.unbind();
+ *
+ * The bench refers to itself through its clock, so it is neither copied
+ * nor moved.
+ */
+
+#ifndef PB7200_SIMBENCH_H
+#define PB7200_SIMBENCH_H
+
+#include <stdint.h>
+
+#include "PB7200P80.h"
+#include "pb7200_faults.h"
+#include "pb7200_packmodel.h"
+#include "pb7200_simchip.h"
+
+// Temperature sensors on a simulated pack
+#define PB7200_SIM_SENSORS 4
+
+// Heat capacity per cell (J/K) and pack thermal resistance to ambient (K/W)
+#define PB7200_SIM_HEAT_CAPACITY 900.0f
+#define PB7200_SIM_THERMAL_RESISTANCE 0.4f
+
+// Bleed resistor per tap (ohm)
+#define PB7200_SIM_BLEED_OHMS 33.0f
+
+/**
+ * @brief A simulated pack and its driver
+ */
+class PB7200SimBench {
+public:
+    ArduinoClock clock;
+    PB7200SimChip chip;
+    PackModel model;
+    PB7200FaultTransport faults;
+    PB7200P80 driver;
+
+    /**
+     * @brief Constructor, clock at zero and no pack model
+     * @param seed Random seed of the fault layer
+     */
+    explicit PB7200SimBench(uint32_t seed = 1);
+
+    /**
+     * @brief Set up the battery model with the usual cell parameters
+     *
+     * R0 1.2 mΩ, RC pairs of 0.5 mΩ / 20 s and 0.4 mΩ / 600 s, a thermal
+     * mass per cell and bleed resistors of PB7200_SIM_BLEED_OHMS. Spread,
+     * chemistry and sensor offsets can be changed on model afterwards.
+     *
+     * @param cells Cells in series
+     * @param capacityAh Nominal cell capacity (Ah)
+     * @param soc Initial state of charge (0-1)
+     * @param ambient Ambient temperature (°C)
+     */
+    void initPack(uint8_t cells, float capacityAh, float soc, float ambient);
+
+    /**
+     * @brief Use this bench's clock on the calling thread
+     */
+    void bind();
+
+    /**
+     * @brief Return the calling thread to the monotonic clock
+     */
+    void unbind();
+
+    /**
+     * @brief Power up: chip inputs from the model, then the driver's begin()
+     *
+     * With a pack model the driver is also given the capacity, bleed
+     * resistance and the cells' true mean state of charge.
+     *
+     * @param cells Cells to configure in the driver
+     * @param attempts begin() tries, for benches with bus errors
+     * @return true if begin() succeeded
+     */
+    bool start(uint8_t cells, uint8_t attempts = 1);
+
+    /**
+     * @brief Run the model for one step and bring chip and clock to its end
+     * @param stepUs Step length (µs)
+     * @param current Pack current over the step (A, positive = charging)
+     */
+    void step(uint32_t stepUs, float current);
+
+    /**
+     * @brief Move simulation time forward without stepping the model
+     * @param nowUs New time (µs); earlier times only resync the chip
+     */
+    void sync(uint64_t nowUs);
+
+    /**
+     * @brief Check whether a driver update is due, and schedule the next
+     * @param periodUs Update period (µs)
+     * @return true once per period
+     */
+    bool updateDue(uint64_t periodUs);
+
+    /**
+     * @brief Set when the first update is due
+     * @param us Simulation time (µs)
+     */
+    void setNextUpdate(uint64_t us);
+
+    /**
+     * @brief Get the simulation time
+     * @return Time at the end of the last step (µs)
+     */
+    uint64_t now() const;
+
+    /**
+     * @brief Get the cells' true mean state of charge
+     * @return State of charge (0-1)
+     */
+    float meanSoc() const;
+
+private:
+    uint64_t _nowUs;
+    uint64_t _nextUpdateUs;
+    float _capacityAh;
+
+    PB7200SimBench(const PB7200SimBench &);
+    PB7200SimBench &operator=(const PB7200SimBench &);
+};
+
+#endif // PB7200_SIMBENCH_H
@@ -0,0 +1,370 @@
+/**
+ * @file pb7200_simchip.cpp
+ * @brief Register-level PB7200P80 model for host simulation
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ */
+
+#include "pb7200_simchip.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "PB7200P80.h"
+
+// I2C framing: start, address + R/W, stop (bits), and one ACK per byte
+#define BUS_FRAME_BITS 11
+#define BUS_BYTE_BITS 9
+
+// Control register bits
+#define CONTROL_RESET 0x80
+
+/**
+ * @brief Constructor, registers at power-on values
+ */
+PB7200SimChip::PB7200SimChip() {
+    memset(_cellVolts, 0, sizeof(_cellVolts));
+    memset(_tempCelsius, 0, sizeof(_tempCelsius));
+    _currentAmps = 0.0f;
+    _cellCount = 0;
+    _tempCount = 0;
+    _limits.overVoltageThreshold = 4.25f;
+    _limits.underVoltageThreshold = 2.80f;
+    _limits.overCurrentThreshold = 100.0f;
+    _limits.overTempThreshold = 60.0f;
+    _limits.underTempThreshold = -20.0f;
+    _limits.overVoltageDelay = 0;
+    _limits.underVoltageDelay = 0;
+    _limits.overCurrentDelay = 0;
+    _noiseVolts = 0.0f;
+    _noiseCelsius = 0.0f;
+    _noiseAmps = 0.0f;
+    _currentOffset = 0.0f;
+    _busErrorRate = 0.0f;
+    _busErrors = 0;
+    _conversionUs = PB7200_SIM_CONVERSION_US;
+    _busHz = PB7200_SIM_BUS_HZ;
+    _nowUs = 0;
+    _transfers = 0;
+    _busUs = 0;
+    _callback = nullptr;
+    _context = nullptr;
+    reset();
+}
+
+/**
+ * @brief Return every register to its power-on value
+ */
+void PB7200SimChip::reset() {
+    memset(_regs, 0, sizeof(_regs));
+    _regs[PB7200_REG_DEVICE_ID] = PB7200_SIM_DEVICE_ID;
+    _shutdown = false;
+    _nextConversionUs = _nowUs + _conversionUs;
+}
+
+/**
+ * @brief Write registers as the chip would over I2C
+ */
+bool PB7200SimChip::write(uint8_t reg, const uint8_t *values, uint8_t length) {
+    if (!finishTransfer(1 + length) || _shutdown || reg + length > PB7200_SIM_REGISTERS) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < length; i++) {
+        uint8_t r = reg + i;
+        uint8_t v = values[i];
+        switch (r) {
+            case PB7200_REG_FAULT_STATUS:
+                // Latched faults are cleared by writing 0 to their bits
+                _regs[r] &= v;
+                break;
+            case PB7200_REG_BALANCE_CTRL1:
+            case PB7200_REG_BALANCE_CTRL2:
+            case PB7200_REG_BALANCE_CTRL3:
+                _regs[r] = v;
+                if (balanceTaps() != 0) {
+                    _regs[PB7200_REG_STATUS] |= PB7200_STATUS_BALANCING;
+                } else {
+                    _regs[PB7200_REG_STATUS] &= ~PB7200_STATUS_BALANCING;
+                }
+                break;
+            case PB7200_REG_CONTROL:
+                if (v & CONTROL_RESET) {
+                    reset();
+                    return true;
+                }
+                _regs[r] = v;
+                break;
+            case PB7200_REG_ADC_CTRL:
+                // Start clears READY until the next conversion latches
+                if (v & PB7200_ADC_START) {
+                    _regs[PB7200_REG_STATUS] &= ~PB7200_STATUS_READY;
+                    _nextConversionUs = _nowUs + _conversionUs;
+                }
+                _regs[r] = v & ~PB7200_ADC_START;
+                break;
+            case PB7200_REG_SHUTDOWN:
+                _shutdown = (v & 0x01) != 0;
+                _regs[r] = v;
+                break;
+            default:
+                if (r >= PB7200_REG_CONFIG_OVP && r <= PB7200_REG_CONFIG_UTP + 1) {
+                    _regs[r] = v;
+                    break;
+                }
+                // Read-only: ID, status and results
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Read registers as the chip would over I2C
+ */
+bool PB7200SimChip::read(uint8_t reg, uint8_t *values, uint8_t length) {
+    // Register address write, repeated start, then the data
+    if (!finishTransfer(2 + length) || _shutdown || reg + length > PB7200_SIM_REGISTERS) {
+        return false;
+    }
+    memcpy(values, &_regs[reg], length);
+    return true;
+}
+
+/**
+ * @brief Set the voltages at the cell taps
+ */
+void PB7200SimChip::setCellVoltages(const float *volts, uint8_t count) {
+    _cellCount = count > PB7200_MAX_CELLS ? PB7200_MAX_CELLS : count;
+    memcpy(_cellVolts, volts, _cellCount * sizeof(float));
+}
+
+/**
+ * @brief Set the sensor temperatures
+ */
+void PB7200SimChip::setTemperatures(const float *celsius, uint8_t count) {
+    _tempCount = count > PB7200_MAX_TEMPS ? PB7200_MAX_TEMPS : count;
+    memcpy(_tempCelsius, celsius, _tempCount * sizeof(float));
+}
+
+/**
+ * @brief Set the pack current
+ */
+void PB7200SimChip::setCurrent(float amps) {
+    _currentAmps = amps;
+}
+
+/**
+ * @brief Set the protection comparator levels
+ */
+void PB7200SimChip::setLimits(const ProtectionConfig &limits) {
+    _limits = limits;
+}
+
+/**
+ * @brief Add Gaussian noise to each conversion
+ */
+void PB7200SimChip::setNoise(float volts, float celsius, float amps, uint32_t seed) {
+    _noiseVolts = volts;
+    _noiseCelsius = celsius;
+    _noiseAmps = amps;
+    _rng.seed(seed);
+    _normal.reset();
+}
+
+/**
+ * @brief Set the current measurement offset
+ */
+void PB7200SimChip::setCurrentOffset(float amps) {
+    _currentOffset = amps;
+}
+
+/**
+ * @brief Make random transfers fail
+ */
+void PB7200SimChip::setBusErrorRate(float probability) {
+    _busErrorRate = probability;
+}
+
+/**
+ * @brief Get the number of transfers failed by the bus error rate
+ */
+uint32_t PB7200SimChip::busErrors() const {
+    return _busErrors;
+}
+
+/**
+ * @brief Set the conversion period
+ */
+void PB7200SimChip::setConversionTime(uint32_t us) {
+    _conversionUs = us > 0 ? us : 1;
+}
+
+/**
+ * @brief Set the bus clock used for transfer durations
+ */
+void PB7200SimChip::setBusClock(uint32_t hz) {
+    _busHz = hz > 0 ? hz : PB7200_SIM_BUS_HZ;
+}
+
+/**
+ * @brief Report transfer durations
+ */
+void PB7200SimChip::setTransferCallback(PB7200SimTransferCallback callback, void *context) {
+    _callback = callback;
+    _context = context;
+}
+
+/**
+ * @brief Move chip time forward, completing due conversions
+ */
+void PB7200SimChip::advance(uint64_t nowUs) {
+    if (nowUs <= _nowUs) {
+        return;
+    }
+    _nowUs = nowUs;
+    if (_shutdown || _nowUs < _nextConversionUs) {
+        return;
+    }
+
+    // Conversions run back to back; only the latest one is visible
+    latch();
+    uint64_t missed = (_nowUs - _nextConversionUs) / _conversionUs;
+    _nextConversionUs += (missed + 1) * _conversionUs;
+}
+
+/**
+ * @brief Latch the current inputs now, outside the conversion schedule
+ */
+void PB7200SimChip::convert() {
+    if (!_shutdown) {
+        latch();
+    }
+}
+
+/**
+ * @brief Get the taps whose balance switch is on
+ */
+uint32_t PB7200SimChip::balanceTaps() const {
+    if (_shutdown) {
+        return 0;
+    }
+    return _regs[PB7200_REG_BALANCE_CTRL1] | ((uint32_t)_regs[PB7200_REG_BALANCE_CTRL2] << 8) |
+           ((uint32_t)_regs[PB7200_REG_BALANCE_CTRL3] << 16);
+}
+
+/**
+ * @brief Check whether the shutdown register was written
+ */
+bool PB7200SimChip::isShutdown() const {
+    return _shutdown;
+}
+
+/**
+ * @brief Get a register value without a bus transfer
+ */
+uint8_t PB7200SimChip::peek(uint8_t reg) const {
+    return _regs[reg];
+}
+
+/**
+ * @brief Get the number of transfers so far
+ */
+uint32_t PB7200SimChip::transfers() const {
+    return _transfers;
+}
+
+/**
+ * @brief Get the total time spent on the bus
+ */
+uint64_t PB7200SimChip::busTime() const {
+    return _busUs;
+}
+
+// ========== Private Methods ==========
+
+/**
+ * @brief Complete a conversion: results, comparators, status
+ */
+void PB7200SimChip::latch() {
+    uint8_t trips = 0;
+
+    for (uint8_t tap = 0; tap < _cellCount; tap++) {
+        float v = _cellVolts[tap] + noise(_noiseVolts);
+        long raw = lroundf(v / PB7200_VOLTAGE_LSB);
+        putWord(PB7200_REG_CELL_VOLTAGE_BASE + tap * 2,
+                (uint16_t)(raw < 0 ? 0 : (raw > 65535 ? 65535 : raw)));
+        if (v > _limits.overVoltageThreshold) {
+            trips |= PB7200_STATUS_OVP;
+        }
+        if (v < _limits.underVoltageThreshold) {
+            trips |= PB7200_STATUS_UVP;
+        }
+    }
+
+    for (uint8_t i = 0; i < _tempCount; i++) {
+        float t = _tempCelsius[i] + noise(_noiseCelsius);
+        long raw = lroundf(t / PB7200_TEMP_LSB);
+        putWord(PB7200_REG_TEMP_BASE + i * 2,
+                (uint16_t)(int16_t)(raw < -32768 ? -32768 : (raw > 32767 ? 32767 : raw)));
+        if (t > _limits.overTempThreshold) {
+            trips |= PB7200_STATUS_OTP;
+        }
+        if (t < _limits.underTempThreshold) {
+            trips |= PB7200_STATUS_UTP;
+        }
+    }
+
+    float amps = _currentAmps + _currentOffset + noise(_noiseAmps);
+    long current = lroundf(amps / PB7200_CURRENT_LSB);
+    current = current < -32768 ? -32768 : (current > 32767 ? 32767 : current);
+    putWord(PB7200_REG_CURRENT_H, (uint16_t)(int16_t)current);
+    if (fabsf(amps) > _limits.overCurrentThreshold) {
+        trips |= PB7200_STATUS_OCP;
+    }
+
+    uint8_t status = trips | PB7200_STATUS_READY;
+    if (balanceTaps() != 0) {
+        status |= PB7200_STATUS_BALANCING;
+    }
+    if (current > 0) {
+        status |= PB7200_STATUS_CHARGING;
+    }
+    _regs[PB7200_REG_STATUS] = status;
+    _regs[PB7200_REG_FAULT_STATUS] |= trips;
+}
+
+/**
+ * @brief Store a 16-bit result, high byte first
+ */
+void PB7200SimChip::putWord(uint8_t reg, uint16_t value) {
+    _regs[reg] = value >> 8;
+    _regs[(uint8_t)(reg + 1)] = value & 0xFF;
+}
+
+/**
+ * @brief Account for a transfer and report its duration
+ * @return false if the transfer is lost to a bus error
+ */
+bool PB7200SimChip::finishTransfer(uint16_t bytes) {
+    uint32_t bits = BUS_FRAME_BITS + (uint32_t)(bytes + 1) * BUS_BYTE_BITS;
+    uint32_t us = (uint32_t)(((uint64_t)bits * 1000000 + _busHz - 1) / _busHz);
+    _transfers++;
+    _busUs += us;
+    if (_callback != nullptr) {
+        _callback(us, _context);
+    }
+    if (_busErrorRate > 0.0f && _uniform(_rng) < _busErrorRate) {
+        _busErrors++;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Draw one noise sample
+ */
+float PB7200SimChip::noise(float rms) {
+    return rms > 0.0f ? rms * _normal(_rng) : 0.0f;
+}
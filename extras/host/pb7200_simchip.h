@@ -0,0 +1,243 @@
+/**
+ * @file pb7200_simchip.h
+ * @brief Register-level PB7200P80 model for host simulation
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * A PB7200Transport that behaves like the chip at its register map:
+ * conversions latch analog inputs into the result registers, the
+ * protection comparators set status and latched fault bits, and the
+ * balance, configuration and control registers hold what the driver
+ * writes. Give it to PB7200P80(PB7200Transport &) in place of Wire.
+ *
+ * Time only moves through advance(). Each transfer also reports its
+ * duration on the bus, so a simulator can charge it to the device clock.
+ *
+ * Cell tap N is at 0x10 + 2N and sensor N at 0x30 + 2N, as the driver
+ * reads them, so taps 16-19 share addresses with sensors 0-3; latching
+ * writes sensors last. The model is exact for up to 16 taps.
+ *
+ * Measurement noise and a current offset are applied at each latch, so
+ * the comparators see them as the result registers do. A bus error rate
+ * makes random transfers fail as NACKs that leave the chip untouched.
+ */
+
+#ifndef PB7200_SIMCHIP_H
+#define PB7200_SIMCHIP_H
+
+#include <stdint.h>
+
+#include <random>
+
+#include "PB7200Transport.h"
+#include "PB7200Types.h"
+
+// Value of the device ID register
+#define PB7200_SIM_DEVICE_ID 0x72
+
+// Default conversion period (µs) and bus clock (Hz)
+#define PB7200_SIM_CONVERSION_US 5000
+#define PB7200_SIM_BUS_HZ 100000
+
+// Register file size
+#define PB7200_SIM_REGISTERS 256
+
+/**
+ * @brief Called after each transfer with its duration on the bus (µs)
+ */
+typedef void (*PB7200SimTransferCallback)(uint32_t us, void *context);
+
+/**
+ * @brief Simulated PB7200P80
+ */
+class PB7200SimChip : public PB7200Transport {
+public:
+    /**
+     * @brief Constructor, registers at power-on values
+     */
+    PB7200SimChip();
+
+    /**
+     * @brief Return every register to its power-on value
+     *
+     * Analog inputs, limits and time are kept.
+     */
+    void reset();
+
+    /**
+     * @brief Write registers as the chip would over I2C
+     * @param reg First register
+     * @param values Values to write
+     * @param length Number of registers
+     * @return false (NACK) for read-only registers, after shutdown or on a
+     *         bus error
+     */
+    bool write(uint8_t reg, const uint8_t *values, uint8_t length) override;
+
+    /**
+     * @brief Read registers as the chip would over I2C
+     * @param reg First register
+     * @param values Buffer for the values
+     * @param length Number of registers
+     * @return false (NACK) past the register file, after shutdown or on a
+     *         bus error
+     */
+    bool read(uint8_t reg, uint8_t *values, uint8_t length) override;
+
+    /**
+     * @brief Set the voltages at the cell taps
+     * @param volts Voltage per tap (V)
+     * @param count Number of connected taps, from tap 0
+     */
+    void setCellVoltages(const float *volts, uint8_t count);
+
+    /**
+     * @brief Set the sensor temperatures
+     * @param celsius Temperature per sensor (°C)
+     * @param count Number of sensors, from sensor 0
+     */
+    void setTemperatures(const float *celsius, uint8_t count);
+
+    /**
+     * @brief Set the pack current
+     * @param amps Current (A, positive = charging)
+     */
+    void setCurrent(float amps);
+
+    /**
+     * @brief Set the protection comparator levels
+     *
+     * The limit registers overlap on the driver's map (each 16-bit limit
+     * starts one address after the previous one), so the comparators
+     * use these levels rather than decoding them.
+     *
+     * @param limits Trip levels (delays are not modelled)
+     */
+    void setLimits(const ProtectionConfig &limits);
+
+    /**
+     * @brief Add Gaussian noise to each conversion
+     * @param volts Cell voltage noise (V RMS)
+     * @param celsius Temperature noise (°C RMS)
+     * @param amps Current noise (A RMS)
+     * @param seed Random seed
+     */
+    void setNoise(float volts, float celsius, float amps, uint32_t seed);
+
+    /**
+     * @brief Set the current measurement offset
+     * @param amps Offset added to every current conversion (A)
+     */
+    void setCurrentOffset(float amps);
+
+    /**
+     * @brief Make random transfers fail
+     * @param probability Chance of a NACK per transfer (0-1)
+     */
+    void setBusErrorRate(float probability);
+
+    /**
+     * @brief Get the number of transfers failed by the bus error rate
+     * @return Failed transfers
+     */
+    uint32_t busErrors() const;
+
+    /**
+     * @brief Set the conversion period
+     * @param us Time from start to READY (µs)
+     */
+    void setConversionTime(uint32_t us);
+
+    /**
+     * @brief Set the bus clock used for transfer durations
+     * @param hz I2C clock (Hz)
+     */
+    void setBusClock(uint32_t hz);
+
+    /**
+     * @brief Report transfer durations
+     * @param callback Function to call, nullptr to stop
+     * @param context Passed to callback
+     */
+    void setTransferCallback(PB7200SimTransferCallback callback, void *context);
+
+    /**
+     * @brief Move chip time forward, completing due conversions
+     * @param nowUs Current time (µs); earlier times are ignored
+     */
+    void advance(uint64_t nowUs);
+
+    /**
+     * @brief Latch the current inputs now, outside the conversion schedule
+     *
+     * Lets a harness change inputs between two driver reads and know
+     * every register already shows them.
+     */
+    void convert();
+
+    /**
+     * @brief Get the taps whose balance switch is on
+     * @return Bit mask of taps (none while shut down)
+     */
+    uint32_t balanceTaps() const;
+
+    /**
+     * @brief Check whether the shutdown register was written
+     * @return true if the chip no longer answers
+     */
+    bool isShutdown() const;
+
+    /**
+     * @brief Get a register value without a bus transfer
+     * @param reg Register
+     * @return Value
+     */
+    uint8_t peek(uint8_t reg) const;
+
+    /**
+     * @brief Get the number of transfers so far
+     * @return Reads plus writes
+     */
+    uint32_t transfers() const;
+
+    /**
+     * @brief Get the total time spent on the bus
+     * @return Time (µs)
+     */
+    uint64_t busTime() const;
+
+private:
+    uint8_t _regs[PB7200_SIM_REGISTERS];
+    float _cellVolts[PB7200_MAX_CELLS];
+    float _tempCelsius[PB7200_MAX_TEMPS];
+    float _currentAmps;
+    uint8_t _cellCount;
+    uint8_t _tempCount;
+    ProtectionConfig _limits;
+    float _noiseVolts;
+    float _noiseCelsius;
+    float _noiseAmps;
+    float _currentOffset;
+    float _busErrorRate;
+    uint32_t _busErrors;
+    std::mt19937 _rng;
+    std::normal_distribution<float> _normal;
+    std::uniform_real_distribution<float> _uniform;
+    uint32_t _conversionUs;
+    uint32_t _busHz;
+    uint64_t _nowUs;
+    uint64_t _nextConversionUs;
+    bool _shutdown;
+    uint32_t _transfers;
+    uint64_t _busUs;
+    PB7200SimTransferCallback _callback;
+    void *_context;
+
+    void latch();
+    void putWord(uint8_t reg, uint16_t value);
+    bool finishTransfer(uint16_t bytes);
+    float noise(float rms);
+};
+
+#endif // PB7200_SIMCHIP_H
@@ -0,0 +1,270 @@
+/**
+ * @file printbench.cpp
+ * @brief Report formatting cost: print* diagnostics against the JSON writer
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Formats the same simulated pack (pb7200_simbench.h) over and over and
+ * reports host time, bytes and Serial write() calls per report for:
+ *
+ *   float print   the print* diagnostics as they were before PB7200Format:
+ *                 Serial.print(float, n) per value, one print per fragment
+ *   print*        printCellVoltages() and printTemperatures()
+ *   json serial   writeSnapshotJson() through a PB7200JsonWriter on Serial
+ *   json buffer   writeSnapshotJson() into a fixed buffer
+ *
+ * The host Print follows the Arduino core's number and float printing,
+ * so the float path runs the board's algorithm; host floats are hardware,
+ * though, where AVR uses software routines, so the gap on a board is
+ * larger than here. The float path reads balancing from the snapshot,
+ * not the bus, which leaves out the transfer per cell it used to make.
+ * Serial output is discarded while timing.
+ *
+ * Build from the library root:
+ *   g++ -std=c++11 -O2 -DARDUINO=10819 -Iextras/host/arduino -I. -Iextras/host \
+ *       extras/host/printbench.cpp extras/host/pb7200_simbench.cpp \
+ *       extras/host/pb7200_simchip.cpp extras/host/pb7200_faults.cpp \
+ *       extras/host/pb7200_packmodel.cpp extras/host/arduino/Arduino.cpp \
+ *       PB7200P80.cpp PB7200Stats.cpp PB7200Format.cpp PB7200Storage.cpp \
+ *       PB7200Json.cpp -o printbench
+ *
+ * Usage:
+ *   ./printbench [-n reports] [-s cells] [-p]
+ *
+ * -p prints one report of each kind before the timings. ARDUINO is
+ * defined as the IDE does, to build the JSON writer's Print output.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "PB7200Json.h"
+#include "PB7200P80.h"
+#include "pb7200_simbench.h"
+
+// Large enough for a full 20-cell snapshot
+#define JSON_BUFFER_SIZE 1024
+
+/**
+ * @brief What every report is built from
+ */
+struct Report {
+    PB7200P80 *driver;
+    PackSnapshot snapshot;
+    float cellVoltages[PB7200_MAX_CELLS];    // Float copies, as the driver kept them
+    float temperatures[PB7200_MAX_TEMPS];
+    char buffer[JSON_BUFFER_SIZE];
+    uint32_t length;                         // Bytes of the last buffered report
+};
+
+/**
+ * @brief One way of formatting a report
+ */
+struct Formatter {
+    const char *name;
+    void (*run)(Report &report);
+};
+
+/**
+ * @brief Cell voltages, formatted as before PB7200Format
+ */
+static void floatCellVoltages(const Report &report) {
+    const PackSnapshot &snapshot = report.snapshot;
+    float total = 0.0f;
+    float maxVoltage = 0.0f;
+    float minVoltage = 999.0f;
+
+    Serial.println(F("Cell Voltages:"));
+    for (uint8_t i = 0; i < snapshot.cellCount; i++) {
+        Serial.print(F("  Cell "));
+        Serial.print(i + 1);
+        Serial.print(F(": "));
+        Serial.print(report.cellVoltages[i], 3);
+        Serial.print(F(" V"));
+        if (snapshot.balanceMask & (1UL << i)) {
+            Serial.print(F(" [BAL]"));
+        }
+        Serial.println();
+    }
+    for (uint8_t i = 0; i < snapshot.cellCount; i++) {
+        total += report.cellVoltages[i];
+        maxVoltage = report.cellVoltages[i] > maxVoltage ? report.cellVoltages[i] : maxVoltage;
+        minVoltage = report.cellVoltages[i] < minVoltage ? report.cellVoltages[i] : minVoltage;
+    }
+    Serial.print(F("Total: "));
+    Serial.print(total, 3);
+    Serial.print(F(" V | Delta: "));
+    Serial.print((maxVoltage - minVoltage) * 1000, 1);
+    Serial.println(F(" mV"));
+}
+
+/**
+ * @brief Temperatures, formatted as before PB7200Format
+ */
+static void floatTemperatures(const Report &report) {
+    Serial.println(F("Temperatures:"));
+    for (uint8_t i = 0; i < report.snapshot.tempCount; i++) {
+        Serial.print(F("  Sensor "));
+        Serial.print(i + 1);
+        Serial.print(F(": "));
+        Serial.print(report.temperatures[i], 1);
+        Serial.println(F(" °C"));
+    }
+}
+
+static void runFloatPrint(Report &report) {
+    floatCellVoltages(report);
+    floatTemperatures(report);
+}
+
+static void runPrint(Report &report) {
+    report.driver->printCellVoltages();
+    report.driver->printTemperatures();
+}
+
+static void runJsonSerial(Report &report) {
+    PB7200JsonWriter json(Serial);
+    writeSnapshotJson(json, report.snapshot);
+    json.flush();
+}
+
+static void runJsonBuffer(Report &report) {
+    PB7200JsonWriter json(report.buffer, sizeof(report.buffer));
+    writeSnapshotJson(json, report.snapshot);
+    report.length = json.length();
+}
+
+static const Formatter FORMATTERS[] = {
+    {"float print", runFloatPrint},
+    {"print*", runPrint},
+    {"json serial", runJsonSerial},
+    {"json buffer", runJsonBuffer},
+};
+
+/**
+ * @brief Get monotonic host time
+ * @return Nanoseconds
+ */
+static uint64_t hostNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Time one formatter with Serial output discarded
+ * @param[out] bytes Bytes per report
+ * @param[out] writes Serial write() calls per report
+ * @return Nanoseconds per report
+ */
+static double timeFormatter(const Formatter &formatter, Report &report, uint32_t reports,
+                            double &bytes, double &writes) {
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null = open("/dev/null", O_WRONLY);
+    dup2(null, STDOUT_FILENO);
+    close(null);
+
+    // One untimed round warms the caches
+    formatter.run(report);
+    unsigned long startWrites = Serial.writeCount();
+    unsigned long startBytes = Serial.byteCount();
+    report.length = 0;
+
+    uint64_t start = hostNs();
+    for (uint32_t n = 0; n < reports; n++) {
+        formatter.run(report);
+    }
+    uint64_t elapsed = hostNs() - start;
+
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+
+    writes = (double)(Serial.writeCount() - startWrites) / reports;
+    bytes = writes > 0 ? (double)(Serial.byteCount() - startBytes) / reports : report.length;
+    return (double)elapsed / reports;
+}
+
+static void usage(const char *name) {
+    fprintf(stderr, "usage: %s [-n reports] [-s cells] [-p]\n", name);
+}
+
+int main(int argc, char **argv) {
+    uint32_t reports = 100000;
+    uint8_t cells = 16;
+    bool show = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:p")) != -1) {
+        switch (opt) {
+            case 'n': reports = (uint32_t)atoi(optarg); break;
+            case 's': cells = (uint8_t)atoi(optarg); break;
+            case 'p': show = true; break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if (reports == 0 || cells < 1 || cells > 16) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // A pack part way through balancing, with some spread between cells
+    PB7200SimBench bench;
+    bench.initPack(cells, 50.0f, 0.6f, 25.0f);
+    for (uint8_t i = 0; i < cells; i++) {
+        bench.model.setSoc(i, 0.6f + 0.004f * (i % 5));
+    }
+    for (uint8_t i = 0; i < PB7200_SIM_SENSORS; i++) {
+        bench.model.setSensorOffset(i, 0.7f * i);
+    }
+    bench.bind();
+    if (!bench.start(cells) || !bench.driver.setBalancingMask(0x11) ||
+        !bench.driver.update()) {
+        bench.unbind();
+        fprintf(stderr, "simulated pack failed to start\n");
+        return 1;
+    }
+    bench.unbind();
+
+    static Report report;
+    report.driver = &bench.driver;
+    report.snapshot = bench.driver.getSnapshot();
+    for (uint8_t i = 0; i < report.snapshot.cellCount; i++) {
+        report.cellVoltages[i] = report.snapshot.cellRaw[i] * PB7200_VOLTAGE_LSB;
+    }
+    for (uint8_t i = 0; i < report.snapshot.tempCount; i++) {
+        report.temperatures[i] = report.snapshot.tempRaw[i] * PB7200_TEMP_LSB;
+    }
+
+    const size_t count = sizeof(FORMATTERS) / sizeof(FORMATTERS[0]);
+    if (show) {
+        for (size_t i = 0; i < count; i++) {
+            printf("--- %s\n", FORMATTERS[i].name);
+            fflush(stdout);
+            report.length = 0;
+            FORMATTERS[i].run(report);
+            printf("%.*s\n", (int)report.length, report.buffer);
+        }
+        printf("\n");
+    }
+
+    double baseline = 0.0;
+    printf("%u reports, %u cells, %u sensors\n", reports, cells, report.snapshot.tempCount);
+    printf("%-12s %10s %8s %8s %8s\n", "format", "ns/report", "speedup", "bytes", "writes");
+    for (size_t i = 0; i < count; i++) {
+        double bytes, writes;
+        double ns = timeFormatter(FORMATTERS[i], report, reports, bytes, writes);
+        if (i == 0) {
+            baseline = ns;
+        }
+        printf("%-12s %10.0f %7.1fx %8.0f %8.1f\n", FORMATTERS[i].name, ns, baseline / ns,
+               bytes, writes);
+    }
+    return 0;
+}
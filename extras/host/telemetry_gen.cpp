@@ -0,0 +1,312 @@
+/**
+ * @file telemetry_gen.cpp
+ * @brief Synthetic multi-pack telemetry source for ingestd
+ * @author PB7200P80 Library
+ * @version 1.0.0
+ * @date 2025-10-04
+ *
+ * Simulates packs with random-walk cells, temperatures and current,
+ * packs them with PB7200TelemetryPacker exactly like a node would and
+ * sends them link-framed (pb7200_link.h), either over TCP connections
+ * to ingestd or on pseudo-terminals whose paths are printed, so the
+ * daemon can be started on them as serial lines.
+ *
+ * Build from the library root:
+ *   g++ -std=c++11 -O2 -pthread -I. extras/host/telemetry_gen.cpp \
+ *       PB7200Stats.cpp PB7200Telemetry.cpp PB7200Storage.cpp -o telemetry_gen
+ *
+ * Usage:
+ *   ./telemetry_gen -c 127.0.0.1:7200 [-k connections] [-n packs per stream]
+ *                   [-r frames/s per pack, 0 = flat out] [-d seconds] [-b frame budget]
+ *   ./telemetry_gen -t ptys [-n ...]     then: ./ingestd /dev/pts/N ...
+ */
+
+#define _XOPEN_SOURCE 600
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "PB7200Stats.h"
+#include "PB7200Telemetry.h"
+#include "pb7200_link.h"
+
+/**
+ * @brief One simulated pack
+ */
+struct SimPack {
+    uint16_t id;
+    PackSnapshot snapshot;
+    PackCounters counters;
+    PackStats stats;
+    PB7200TelemetryPacker packer;
+};
+
+/**
+ * @brief Generator settings
+ */
+struct Options {
+    const char *host;
+    uint16_t port;
+    unsigned streams;
+    unsigned packsPerStream;
+    double rate;
+    double seconds;
+    uint8_t budget;
+    bool pty;
+};
+
+static std::atomic<bool> running(true);
+static std::atomic<uint64_t> framesSent(0);
+
+static void onSignal(int) {
+    running = false;
+}
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Set up a pack with a slightly different cell count per id
+ */
+static void initPack(SimPack &pack, uint16_t id, std::mt19937 &rng) {
+    memset(&pack.snapshot, 0, sizeof(pack.snapshot));
+    memset(&pack.counters, 0, sizeof(pack.counters));
+    pack.id = id;
+    pack.snapshot.cellCount = 12 + id % (PB7200_MAX_CELLS - 11);
+    pack.snapshot.tempCount = 4;
+    pack.snapshot.coherent = true;
+    for (uint8_t i = 0; i < pack.snapshot.cellCount; i++) {
+        pack.snapshot.cellRaw[i] = 3250 + rng() % 100;
+    }
+    for (uint8_t i = 0; i < pack.snapshot.tempCount; i++) {
+        pack.snapshot.tempRaw[i] = 220 + rng() % 40;
+    }
+    pack.packer.reset();
+}
+
+/**
+ * @brief Bounded random-walk step
+ */
+static int constrainStep(int value, int low, int high) {
+    return value < low ? low : (value > high ? high : value);
+}
+
+/**
+ * @brief Advance a pack one step and build its next link frame
+ */
+static uint16_t stepPack(SimPack &pack, const PackConfig &config, uint32_t nowMs,
+                         uint8_t budget, std::mt19937 &rng, uint8_t *out) {
+    PackSnapshot &s = pack.snapshot;
+
+    s.currentRaw = (int16_t)constrainStep(s.currentRaw + (int)(rng() % 201) - 100, -5000, 5000);
+    for (uint8_t i = 0; i < s.cellCount; i++) {
+        s.cellRaw[i] = (uint16_t)constrainStep(s.cellRaw[i] + (int)(rng() % 5) - 2, 2800, 3650);
+    }
+    for (uint8_t i = 0; i < s.tempCount; i++) {
+        s.tempRaw[i] = (int16_t)constrainStep(s.tempRaw[i] + (int)(rng() % 3) - 1, -100, 600);
+    }
+    s.timestamp = nowMs;
+    s.sequence++;
+
+    computePackStats(s, config, pack.counters, pack.stats);
+
+    uint8_t frame[255];
+    uint8_t length = pack.packer.pack(s, pack.stats, frame, budget);
+    return linkEncode(pack.id, frame, length, out);
+}
+
+/**
+ * @brief Open a TCP connection to the daemon
+ */
+static int connectDaemon(const Options &options) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(options.port);
+    if (fd < 0 || inet_pton(AF_INET, options.host, &addr.sin_addr) != 1 ||
+        connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Open a pty in raw mode and print the path to give to ingestd
+ */
+static int openPty() {
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+        return -1;
+    }
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    printf("%s\n", ptsname(fd));
+    fflush(stdout);
+    return fd;
+}
+
+/**
+ * @brief Write everything, retrying short writes
+ */
+static bool writeAll(int fd, const uint8_t *data, size_t length) {
+    while (length > 0) {
+        ssize_t n = write(fd, data, length);
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        length -= (size_t)n;
+    }
+    return true;
+}
+
+/**
+ * @brief Feed one stream (connection or pty) with its packs
+ */
+static void streamLoop(const Options &options, int fd, unsigned stream) {
+    PackConfig config = {1, 100.0f, 0.0f};
+    std::mt19937 rng(stream + 1);
+    std::vector<SimPack> packs(options.packsPerStream);
+    for (unsigned p = 0; p < packs.size(); p++) {
+        initPack(packs[p], (uint16_t)(stream * options.packsPerStream + p), rng);
+    }
+
+    std::vector<uint8_t> batch;
+    uint8_t link[PB7200_LINK_MAX];
+    double start = nowSeconds();
+    uint64_t round = 0;
+
+    while (running) {
+        double now = nowSeconds() - start;
+        if (options.seconds > 0 && now >= options.seconds) {
+            break;
+        }
+
+        // One frame per pack per round, sent with one write
+        batch.clear();
+        uint32_t nowMs = (uint32_t)(now * 1000.0);
+        for (unsigned p = 0; p < packs.size(); p++) {
+            uint16_t n = stepPack(packs[p], config, nowMs, options.budget, rng, link);
+            batch.insert(batch.end(), link, link + n);
+        }
+        if (!writeAll(fd, batch.data(), batch.size())) {
+            break;
+        }
+        framesSent += packs.size();
+        round++;
+
+        if (options.rate > 0) {
+            double wait = round / options.rate - (nowSeconds() - start);
+            if (wait > 0) {
+                usleep((useconds_t)(wait * 1e6));
+            }
+        }
+    }
+    close(fd);
+}
+
+int main(int argc, char **argv) {
+    Options options = {"127.0.0.1", 7200, 1, 100, 10.0, 0.0, 64, false};
+
+    int opt;
+    while ((opt = getopt(argc, argv, "c:k:n:r:d:b:t:")) != -1) {
+        switch (opt) {
+            case 'c': {
+                static char host[64];
+                snprintf(host, sizeof(host), "%s", optarg);
+                char *colon = strchr(host, ':');
+                if (colon != nullptr) {
+                    *colon = '\0';
+                    options.port = (uint16_t)atoi(colon + 1);
+                }
+                options.host = host;
+                break;
+            }
+            case 'k':
+                options.streams = (unsigned)atoi(optarg);
+                break;
+            case 'n':
+                options.packsPerStream = (unsigned)atoi(optarg);
+                break;
+            case 'r':
+                options.rate = atof(optarg);
+                break;
+            case 'd':
+                options.seconds = atof(optarg);
+                break;
+            case 'b':
+                options.budget = (uint8_t)atoi(optarg);
+                break;
+            case 't':
+                options.pty = true;
+                options.streams = (unsigned)atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-c host:port | -t ptys] [-k connections] "
+                                "[-n packs] [-r rate] [-d seconds] [-b budget]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (options.streams == 0 || options.packsPerStream == 0 ||
+        options.packsPerStream * options.streams > 65536) {
+        fprintf(stderr, "need 1-65536 packs in total\n");
+        return 1;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::vector<int> fds;
+    for (unsigned s = 0; s < options.streams; s++) {
+        int fd = options.pty ? openPty() : connectDaemon(options);
+        if (fd < 0) {
+            perror(options.pty ? "pty" : "connect");
+            return 1;
+        }
+        fds.push_back(fd);
+    }
+    if (options.pty) {
+        // Give the reader time to open the ptys before data is written
+        printf("press Enter to start\n");
+        fflush(stdout);
+        getchar();
+    }
+
+    double start = nowSeconds();
+    std::vector<std::thread> threads;
+    for (unsigned s = 0; s < options.streams; s++) {
+        threads.push_back(std::thread(streamLoop, std::cref(options), fds[s], s));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+
+    double elapsed = nowSeconds() - start;
+    printf("sent %llu frames in %.1f s (%.0f frames/s)\n", (unsigned long long)framesSent.load(),
+           elapsed, framesSent / elapsed);
+    return 0;
+}